@@ -0,0 +1,201 @@
+#include "bench.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+
+namespace
+{
+
+thread_local std::size_t allocs = 0;
+thread_local std::size_t bytes = 0;
+
+void* counted_alloc(std::size_t size)
+{
+    ++allocs;
+    bytes += size;
+    return std::malloc(size ? size : 1);
+}
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    if (void* ptr = counted_alloc(size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return counted_alloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return counted_alloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace bench
+{
+
+counters allocations()
+{
+    return {allocs, bytes};
+}
+
+static std::vector<result> read_csv(const std::string& path)
+{
+    std::vector<result> rows;
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);     // header
+    while (std::getline(in, line))
+    {
+        // the name is quoted and may contain commas
+        const auto close = line.rfind('"');
+        if (line.empty() || line[0] != '"' || close == 0 ||
+                close == std::string::npos)
+        {
+            continue;
+        }
+        result row{line.substr(1, close - 1), 0, 0, 0, 0};
+        std::istringstream fields(line.substr(close + 2));
+        char comma;
+        fields >> row.ns_per_op >> comma >> row.allocs_per_op >> comma
+               >> row.bytes_per_op >> comma >> row.iterations;
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+suite::suite(const char* name, int argc, char** argv) :
+        name_(name), min_time_(std::chrono::milliseconds(100)), repeat_(3)
+{
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string flag(argv[i]);
+        const std::string value(argv[i + 1]);
+        if (flag == "--filter")
+        {
+            filter_ = value;
+        }
+        else if (flag == "--min-time")
+        {
+            min_time_ = std::chrono::milliseconds(std::atoi(value.c_str()));
+        }
+        else if (flag == "--repeat")
+        {
+            repeat_ = std::atoi(value.c_str()) > 0 ?
+                    std::atoi(value.c_str()) : 1;
+        }
+        else if (flag == "--out")
+        {
+            out_ = value;
+        }
+        else if (flag == "--baseline")
+        {
+            baseline_ = value;
+        }
+        else
+        {
+            std::fprintf(stderr, "unknown argument %s\n", argv[i]);
+        }
+    }
+
+    if (!baseline_.empty())
+    {
+        baseline_results_ = read_csv(baseline_);
+        if (baseline_results_.empty())
+        {
+            std::fprintf(stderr, "no results in baseline %s\n",
+                    baseline_.c_str());
+        }
+    }
+
+    std::printf("%-52s %12s %10s %10s%s\n", name_.c_str(), "ns/op",
+            "allocs/op", "bytes/op", baseline_results_.empty() ? "" :
+                    "   vs baseline");
+}
+
+bool suite::selected(const std::string& name) const
+{
+    return filter_.empty() || name.find(filter_) != std::string::npos;
+}
+
+void suite::record(result&& row)
+{
+    std::printf("%-52s %12.1f %10.2f %10.1f", row.name.c_str(),
+            row.ns_per_op, row.allocs_per_op, row.bytes_per_op);
+    for (const auto& base : baseline_results_)
+    {
+        if (base.name == row.name && base.ns_per_op > 0)
+        {
+            std::printf("   %+7.1f%%",
+                    (row.ns_per_op / base.ns_per_op - 1) * 100);
+            if (base.allocs_per_op != row.allocs_per_op)
+            {
+                std::printf(" (allocs %.2f -> %.2f)", base.allocs_per_op,
+                        row.allocs_per_op);
+            }
+            break;
+        }
+    }
+    std::printf("\n");
+    std::fflush(stdout);
+    results_.push_back(std::move(row));
+}
+
+int suite::finish()
+{
+    if (out_.empty())
+    {
+        return 0;
+    }
+
+    std::ofstream out(out_);
+    out << "name,ns_per_op,allocs_per_op,bytes_per_op,iterations\n";
+    for (const auto& row : results_)
+    {
+        out << '"' << row.name << "\"," << row.ns_per_op << ','
+            << row.allocs_per_op << ',' << row.bytes_per_op << ','
+            << row.iterations << '\n';
+    }
+    if (!out)
+    {
+        std::fprintf(stderr, "failed to write %s\n", out_.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace bench
@@ -0,0 +1,245 @@
+#ifndef BENCH_BENCH_HPP
+#define BENCH_BENCH_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE
+#endif
+
+namespace bench
+{
+
+/**
+ * @brief Prevent the optimizer from discarding a value.
+ * 
+ * @param value value that must be considered used
+ */
+template <typename t>
+inline void keep(const t& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static const volatile void* sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * @brief Heap activity on the calling thread since it started.
+ */
+struct counters
+{
+    std::size_t allocs;
+    std::size_t bytes;
+};
+
+/**
+ * @brief Read the calling thread's allocation counters.  Counting is
+ * done by the replacement operator new in bench.cpp.
+ * 
+ * @return allocations made & bytes requested so far
+ */
+counters allocations();
+
+/**
+ * @brief Measurements for one benchmark.
+ */
+struct result
+{
+    std::string name;
+    double ns_per_op;
+    double allocs_per_op;
+    double bytes_per_op;
+    std::size_t iterations;
+};
+
+/**
+ * @brief A set of benchmarks sharing one executable.  Recognized
+ * command line arguments:
+ * 
+ * --filter <text>    only run benchmarks whose name contains text
+ * --min-time <ms>    minimum duration of each timed run (default 100)
+ * --repeat <n>       timed runs per benchmark, fastest is kept (default 3)
+ * --out <file>       write results as CSV
+ * --baseline <file>  compare against CSV written by an earlier --out
+ */
+class suite
+{
+  public:
+
+    suite(const char* name, int argc, char** argv);
+
+    /**
+     * @brief Time a callable and record one result row.  The iteration
+     * count is doubled until a run takes at least the minimum time.
+     * 
+     * @param name row label, unique within the suite
+     * @param fn callable to time; invoked with no arguments
+     * @param ops operations performed by each call of fn; results are
+     * reported per operation
+     */
+    template <typename fn_t>
+    void run(const std::string& name, fn_t&& fn, std::size_t ops = 1)
+    {
+        if (!selected(name))
+        {
+            return;
+        }
+
+        using clock = std::chrono::steady_clock;
+        std::size_t iters = 1;
+        for (;; iters *= 2)
+        {
+            const auto start = clock::now();
+            for (std::size_t i = 0; i < iters; ++i)
+            {
+                fn();
+            }
+            if (clock::now() - start >= min_time_)
+            {
+                break;
+            }
+        }
+
+        double best = 0;
+        counters used{0, 0};
+        for (int r = 0; r < repeat_; ++r)
+        {
+            const auto before = allocations();
+            const auto start = clock::now();
+            for (std::size_t i = 0; i < iters; ++i)
+            {
+                fn();
+            }
+            const auto elapsed = clock::now() - start;
+            const auto after = allocations();
+
+            const double ns = std::chrono::duration<double, std::nano>(
+                    elapsed).count() / static_cast<double>(iters);
+            if (r == 0 || ns < best)
+            {
+                best = ns;
+            }
+            used = {after.allocs - before.allocs, after.bytes - before.bytes};
+        }
+
+        const double n = static_cast<double>(ops);
+        record({name, best / n,
+                static_cast<double>(used.allocs) / static_cast<double>(iters) / n,
+                static_cast<double>(used.bytes) / static_cast<double>(iters) / n,
+                iters * ops});
+    }
+
+    /**
+     * @brief Write results and report any baseline comparison.
+     * 
+     * @return process exit code
+     */
+    int finish();
+
+  private:
+
+    bool selected(const std::string& name) const;
+
+    void record(result&& row);
+
+    std::string name_;
+    std::string filter_;
+    std::string out_;
+    std::string baseline_;
+    std::chrono::nanoseconds min_time_;
+    int repeat_;
+    std::vector<result> results_;
+    std::vector<result> baseline_results_;
+};
+
+/**
+ * @brief Worker threads that each run the same function once per batch,
+ * for timing code under contention.
+ */
+class pool
+{
+  public:
+
+    pool(int threads, std::function<void()> work) : work_(std::move(work))
+    {
+        for (int i = 0; i < threads; ++i)
+        {
+            threads_.emplace_back([this] { loop(); });
+        }
+    }
+
+    ~pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (auto& t : threads_)
+        {
+            t.join();
+        }
+    }
+
+    void run_batch()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ++batch_;
+        running_ = static_cast<int>(threads_.size());
+        start_.notify_all();
+        done_.wait(lock, [this] { return running_ == 0; });
+    }
+
+  private:
+
+    void loop()
+    {
+        unsigned long seen = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_.wait(lock, [&] { return stop_ || batch_ != seen; });
+                if (stop_)
+                {
+                    return;
+                }
+                seen = batch_;
+            }
+            work_();
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--running_ == 0)
+            {
+                done_.notify_one();
+            }
+        }
+    }
+
+    std::function<void()> work_;
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    unsigned long batch_ = 0;
+    int running_ = 0;
+    bool stop_ = false;
+};
+
+} // namespace bench
+
+#endif // #ifndef
@@ -0,0 +1,81 @@
+// Routing a retry on the root cause of an error that passed through
+// three layers.  Before contexts carried codes, the low-level code had
+// to be written into the description & parsed back out of it.
+
+#include <cstdlib>
+#include <cstring>
+
+#include "bench.hpp"
+#include "jack/error.hpp"
+
+BENCH_NOINLINE static jack::error fail_coded()
+{
+    jack::error e(110, "connection timed out");
+    e.wrap_as(2001, "fetching shard ", 12);
+    e.wrap_as(3001, "loading user ", 4242);
+    e.wrap_as(4001, "handling request ", 77);
+    return e;
+}
+
+BENCH_NOINLINE static jack::error fail_parsed()
+{
+    jack::error e(110, "[code 110] connection timed out");
+    e.wrap("[code 2001] fetching shard ", 12);
+    e.wrap("[code 3001] loading user ", 4242);
+    e.wrap("[code 4001] handling request ", 77);
+    e.code = 4001;
+    return e;
+}
+
+// the innermost "[code n]" in the description
+static int parse_root_code(const jack::error& e)
+{
+    const char* s = e.desc.c_str();
+    const char* last = nullptr;
+    while ((s = std::strstr(s, "[code ")) != nullptr)
+    {
+        last = s;
+        s += 6;
+    }
+    return last ? std::atoi(last + 6) : e.code;
+}
+
+static bool retryable(int code)
+{
+    return code == 110 || code == 111;
+}
+
+int main(int argc, char** argv)
+{
+    bench::suite suite("root cause of a wrapped error", argc, argv);
+
+    const jack::error coded = fail_coded();
+    const jack::error parsed = fail_parsed();
+
+    suite.run("root_code()", [&] {
+        bench::keep(retryable(coded.root_code()));
+    });
+    suite.run("parse description", [&] {
+        bench::keep(retryable(parse_root_code(parsed)));
+    });
+
+    // the description is rendered once per error, so a fresh error
+    // pays for that too
+    suite.run("build + root_code()", [] {
+        bench::keep(retryable(fail_coded().root_code()));
+    });
+    suite.run("build + parse description", [] {
+        bench::keep(retryable(parse_root_code(fail_parsed())));
+    });
+
+    // walking the chain for every code, without rendering
+    suite.run("for_each_context", [&] {
+        int codes = 0;
+        coded.desc.for_each_context([&codes](const jack::context& c) {
+            codes += c.coded;
+        });
+        bench::keep(codes);
+    });
+
+    return suite.finish();
+}
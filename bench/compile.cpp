@@ -0,0 +1,124 @@
+// Compile time of code that uses jack::error: a set of generated
+// translation units, each making & wrapping a few errors the way a
+// service would, compiled with the header alone and against the
+// jack-error library (JACK_ERROR_COMPILED).  The "include only" rows are
+// the floor: parsing the header & the standard library.  ns/op is the
+// time to compile one translation unit.
+//
+// The compiler, flags & include directory are the ones CMake built this
+// benchmark with.  Save results with --out & compare with --baseline to
+// catch changes that make the header slower to compile.
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+static const int units = 8;
+
+// a translation unit with its own string literals, so that nothing is
+// shared between units but what the library shares
+static std::string unit_source(int i)
+{
+    const std::string n = std::to_string(i);
+    return "#include \"jack/error.hpp\"\n"
+            "#include <ostream>\n"
+            "#include <string>\n"
+            "\n"
+            "namespace unit" + n + "\n"
+            "{\n"
+            "struct endpoint { std::string host; int port; };\n"
+            "inline std::ostream& operator<<(std::ostream& os, const endpoint& e)\n"
+            "{\n"
+            "    return os << e.host << ':' << e.port;\n"
+            "}\n"
+            "\n"
+            "jack::error open_file(const std::string& path, int attempt)\n"
+            "{\n"
+            "    jack::error e(" + n + "01, \"cannot open " + n + " \", path);\n"
+            "    e.wrap(\"attempt \", attempt, \" of unit " + n + "\");\n"
+            "    return e;\n"
+            "}\n"
+            "\n"
+            "jack::error connect(const endpoint& to, std::size_t bytes)\n"
+            "{\n"
+            "    jack::error e(" + n + "02, \"connection reset by \", to);\n"
+            "    e.extend(\"after \", bytes);\n"
+            "    e.wrap(\"syncing shard " + n + "\").trace();\n"
+            "    return e;\n"
+            "}\n"
+            "\n"
+            "jack::reason describe(const jack::reason& r, const char* table)\n"
+            "{\n"
+            "    jack::reason copy(r);\n"
+            "    copy.wrap(\"loading table \", table);\n"
+            "    copy.limit(16);\n"
+            "    return copy;\n"
+            "}\n"
+            "\n"
+            "std::string log_line(const jack::error& e)\n"
+            "{\n"
+            "    return jack::debug::str(e) + \" in unit " + n + "\";\n"
+            "}\n"
+            "} // namespace unit" + n + "\n";
+}
+
+static std::string write_units(const std::string& dir, bool include_only)
+{
+    const std::string stem = dir + (include_only ? "/include_only_" : "/unit_");
+    for (int i = 0; i < units; ++i)
+    {
+        std::ofstream out(stem + std::to_string(i) + ".cpp");
+        out << (include_only ? "#include \"jack/error.hpp\"\n" : unit_source(i));
+    }
+    return stem;
+}
+
+static bool compile(const std::string& stem, const std::string& flags)
+{
+    for (int i = 0; i < units; ++i)
+    {
+        const std::string command = std::string(JACK_BENCH_CXX) +
+                " -std=c++" JACK_BENCH_STD " -I\"" JACK_BENCH_INCLUDE "\" " +
+                flags + " -c \"" + stem + std::to_string(i) + ".cpp\" -o \"" +
+                stem + std::to_string(i) + ".o\"";
+        if (std::system(command.c_str()) != 0)
+        {
+            std::fprintf(stderr, "failed: %s\n", command.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    bench::suite suite("compiling code that uses jack::error", argc, argv);
+
+    const std::string units_stem = write_units(JACK_BENCH_WORK_DIR, false);
+    const std::string include_stem = write_units(JACK_BENCH_WORK_DIR, true);
+
+    bool ok = true;
+    for (const char* opt : {"-O0", "-O2"})
+    {
+        const std::string o(opt);
+        suite.run("include only/" + o, [&] {
+            ok = ok && compile(include_stem, o);
+        }, units);
+        suite.run("include only, library/" + o, [&] {
+            ok = ok && compile(include_stem, o + " -DJACK_ERROR_COMPILED");
+        }, units);
+        suite.run("header-only/" + o, [&] {
+            ok = ok && compile(units_stem, o);
+        }, units);
+        suite.run("jack-error library/" + o, [&] {
+            ok = ok && compile(units_stem, o + " -DJACK_ERROR_COMPILED");
+        }, units);
+    }
+
+    const int status = suite.finish();
+    return ok ? status : 1;
+}
@@ -0,0 +1,84 @@
+#include <string>
+
+#include "bench.hpp"
+#include "jack/error.hpp"
+
+// a value only operator<< knows how to write
+struct endpoint
+{
+    const char* host;
+    int port;
+};
+
+static std::ostream& operator<<(std::ostream& os, const endpoint& ep)
+{
+    return os << ep.host << ':' << ep.port;
+}
+
+// most errors are handled by their code (retry, fallback) & dropped
+template <typename... args_t>
+BENCH_NOINLINE static int handle_by_code(const args_t&... args)
+{
+    const jack::error e(1001, args...);
+    bench::keep(e);
+    return e.code;
+}
+
+int main(int argc, char** argv)
+{
+    const std::string path("/var/lib/app/shard-0042.db");
+    const endpoint ep{"10.0.0.1", 8080};
+    const double elapsed = 1.2345;
+
+    bench::suite suite("deferred vs eager formatting", argc, argv);
+
+    // numbers only; nothing needs copying into the pool
+    suite.run("numbers/eager unread",
+            [&] { bench::keep(handle_by_code("read ", 4096, " of ", 8192,
+                    " bytes in ", elapsed, "s")); });
+    suite.run("numbers/deferred unread",
+            [&] { bench::keep(handle_by_code(jack::deferred, "read ", 4096,
+                    " of ", 8192, " bytes in ", elapsed, "s")); });
+
+    // a std::string is copied into the pool
+    suite.run("string/eager unread",
+            [&] { bench::keep(handle_by_code("read ", 4096,
+                    " bytes from ", path)); });
+    suite.run("string/deferred unread",
+            [&] { bench::keep(handle_by_code(jack::deferred, "read ", 4096,
+                    " bytes from ", path)); });
+
+    // the operator<< fallback is where deferral saves the most
+    suite.run("stream fallback/eager unread",
+            [&] { bench::keep(handle_by_code("connect to ", ep,
+                    " timed out")); });
+    suite.run("stream fallback/deferred unread",
+            [&] { bench::keep(handle_by_code(jack::deferred, "connect to ",
+                    ep, " timed out")); });
+
+    // the cost of deferral when the description is read after all
+    suite.run("string/eager read", [&] {
+        const jack::error e(1001, "read ", 4096, " bytes from ", path);
+        bench::keep(e.desc.c_str());
+    });
+    suite.run("string/deferred read", [&] {
+        const jack::error e(1001, jack::deferred, "read ", 4096,
+                " bytes from ", path);
+        bench::keep(e.desc.c_str());
+    });
+
+    // wrapped on the way up, but never read
+    suite.run("string/eager wrapped x2 unread", [&] {
+        jack::error e(1001, "read ", 4096, " bytes from ", path);
+        e.wrap("loading shard ", 42).wrap("handling request");
+        bench::keep(e);
+    });
+    suite.run("string/deferred wrapped x2 unread", [&] {
+        jack::error e(1001, jack::deferred, "read ", 4096,
+                " bytes from ", path);
+        e.wrap("loading shard ", 42).wrap("handling request");
+        bench::keep(e);
+    });
+
+    return suite.finish();
+}
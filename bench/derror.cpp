@@ -0,0 +1,94 @@
+#include <cstdio>
+
+#if __cplusplus < 201703L
+int main() { std::printf("This benchmark requires C++17\n"); }
+#else
+
+#include <optional>
+
+#include "bench.hpp"
+#include "jack/error.hpp"
+
+// fail once every `period` calls; 0 never fails
+static volatile unsigned period = 0;
+
+static bool should_fail(unsigned i)
+{
+    return period && i % period == 0;
+}
+
+// the pattern from examples/ex1.cpp
+BENCH_NOINLINE std::optional<jack::error> opt_leaf(unsigned i)
+{
+    return should_fail(i) ?
+        std::make_optional<jack::error>(1001, "rand was odd w/ val ", i) :
+        std::nullopt;
+}
+
+template <int depth>
+BENCH_NOINLINE std::optional<jack::error> opt_call(unsigned i)
+{
+    auto maybe_err = depth == 1 ? opt_leaf(i) : opt_call<depth - 1>(i);
+    if (maybe_err)
+    {
+        maybe_err->wrap("layer ", depth);
+    }
+    return maybe_err;
+}
+
+template <>
+std::optional<jack::error> opt_call<0>(unsigned i)
+{
+    return opt_leaf(i);
+}
+
+BENCH_NOINLINE jack::derror derror_leaf(unsigned i)
+{
+    if (should_fail(i))
+    {
+        return {1001, "rand was odd w/ val ", i};
+    }
+    return {};
+}
+
+template <int depth>
+BENCH_NOINLINE jack::derror derror_call(unsigned i)
+{
+    auto maybe_err = depth == 1 ? derror_leaf(i) : derror_call<depth - 1>(i);
+    if (maybe_err)
+    {
+        maybe_err.wrap("layer ", depth);
+    }
+    return maybe_err;
+}
+
+template <>
+jack::derror derror_call<0>(unsigned i)
+{
+    return derror_leaf(i);
+}
+
+int main(int argc, char** argv)
+{
+    std::printf("sizeof(std::optional<jack::error>) = %zu, "
+            "sizeof(jack::derror) = %zu\n\n",
+            sizeof(std::optional<jack::error>), sizeof(jack::derror));
+
+    bench::suite suite("returning success or failure through 8 calls",
+            argc, argv);
+    for (unsigned p : {0u, 1000u, 10u, 1u})
+    {
+        const std::string suffix = p == 0 ? "/never fails" :
+                p == 1 ? "/always fails" :
+                "/fails 1 in " + std::to_string(p);
+        unsigned i = 0;
+        period = p;
+        suite.run("std::optional<jack::error>" + suffix,
+                [&] { bench::keep(static_cast<bool>(opt_call<8>(++i))); });
+        suite.run("jack::derror" + suffix,
+                [&] { bench::keep(static_cast<bool>(derror_call<8>(++i))); });
+    }
+    return suite.finish();
+}
+
+#endif // __cplusplus < 201703L
@@ -0,0 +1,87 @@
+#include <string>
+
+#include "bench.hpp"
+#include "jack/error.hpp"
+
+#if __cplusplus >= 201703L
+enum class net_errc { refused = 1001 };
+
+template <>
+struct jack::code_catalog<net_errc>
+{
+    static constexpr jack::literal domain = "net";
+    static constexpr jack::code_info<net_errc> entries[] = {
+        {net_errc::refused, "refused", "connection refused by upstream host",
+                jack::severity::error},
+    };
+};
+#endif
+
+int main(int argc, char** argv)
+{
+    const char* cstr = "connection refused by upstream host 10.0.0.1";
+    const std::string str(cstr);
+    const jack::reason reason(cstr);
+    const jack::error small(1001, "timed out");
+    const jack::error large(1001, cstr);
+    const jack::error wrapped = [&] {
+        jack::error e(large);
+        for (int i = 0; i < 8; ++i)
+        {
+            e.wrap("layer ", i).extend("attempt ", i);
+        }
+        return e;
+    }();
+
+    bench::suite suite("jack::error", argc, argv);
+
+    // construction from each overload
+    suite.run("construct/c string",
+            [&] { bench::keep(jack::error(1001, cstr)); });
+    suite.run("construct/literal", [&] { bench::keep(jack::error(1001,
+            jack::literal("connection refused by upstream host 10.0.0.1"))); });
+#if __cplusplus >= 201703L
+    suite.run("construct/catalog code",
+            [&] { bench::keep(jack::error(net_errc::refused)); });
+    suite.run("construct/std::error_code (catalog)", [&] {
+        bench::keep(jack::error(jack::make_error_code(net_errc::refused)));
+    });
+#endif
+    suite.run("construct/copy std::string",
+            [&] { bench::keep(jack::error(1001, str)); });
+    suite.run("construct/copy + move std::string", [&] {
+        std::string src(str);
+        bench::keep(jack::error(1001, std::move(src)));
+    });
+    suite.run("construct/copy reason",
+            [&] { bench::keep(jack::error(1001, reason)); });
+    suite.run("construct/copy + move reason", [&] {
+        jack::reason src(reason);
+        bench::keep(jack::error(1001, std::move(src)));
+    });
+    suite.run("construct/variadic (4 args)",
+            [&] { bench::keep(jack::error(1001, "read ", 4096,
+                    " bytes from ", str)); });
+
+    // copy & move
+    for (const auto* e : {&small, &large, &wrapped})
+    {
+        const std::string suffix = e == &small ? "/short" :
+                e == &large ? "/long" : "/wrapped x16";
+        suite.run("copy construct" + suffix,
+                [&] { bench::keep(jack::error(*e)); });
+        suite.run("copy + move construct" + suffix, [&] {
+            jack::error src(*e);
+            bench::keep(jack::error(std::move(src)));
+        });
+        suite.run("copy assign" + suffix, [&] {
+            jack::error dst(0, "");
+            dst = *e;
+            bench::keep(dst);
+        });
+        suite.run("debug::str" + suffix,
+                [&] { bench::keep(jack::debug::str(*e)); });
+    }
+
+    return suite.finish();
+}
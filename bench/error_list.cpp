@@ -0,0 +1,103 @@
+#include <cstdio>
+#include <vector>
+
+#include "bench.hpp"
+#include "jack/error.hpp"
+
+// a batch of records failing validation: a few codes & messages, each
+// wrapped with the column it was found in
+static const char* const messages[] = {"missing field", "bad type",
+        "out of range", "duplicate key"};
+
+constexpr int batch = 1000;
+
+static jack::error make_error(int i)
+{
+    jack::error e(1000 + i % 3, jack::literal(messages[i % 4],
+            std::char_traits<char>::length(messages[i % 4])));
+    e.wrap("validating column ", i % 16);
+    return e;
+}
+
+static std::vector<jack::error> build_vector()
+{
+    std::vector<jack::error> errors;
+    for (int i = 0; i < batch; ++i)
+    {
+        errors.push_back(make_error(i));
+    }
+    return errors;
+}
+
+static jack::error_list build_list()
+{
+    jack::error_list errors;
+    for (int i = 0; i < batch; ++i)
+    {
+        errors.push_back(make_error(i));
+    }
+    return errors;
+}
+
+int main(int argc, char** argv)
+{
+    bench::suite suite("1000 errors from one batch (per error)", argc, argv);
+
+    // building includes making each error; the wrap rows add one context
+    // to all of them, so wrap cost is the difference
+    suite.run("build/vector<error>",
+            [] { bench::keep(build_vector()); }, batch);
+    suite.run("build/error_list",
+            [] { bench::keep(build_list()); }, batch);
+    suite.run("build + wrap all/vector<error>", [] {
+        auto errors = build_vector();
+        for (auto& e : errors)
+        {
+            e.wrap("importing users.csv");
+        }
+        bench::keep(errors);
+    }, batch);
+    suite.run("build + wrap all/error_list", [] {
+        auto errors = build_list();
+        errors.wrap("importing users.csv");
+        bench::keep(errors);
+    }, batch);
+
+    // 8 worker results combined
+    const std::vector<jack::error> vector_part = build_vector();
+    const jack::error_list list_part = build_list();
+    suite.run("merge 8/vector<error>", [&] {
+        std::vector<jack::error> all;
+        for (int i = 0; i < 8; ++i)
+        {
+            all.insert(all.end(), vector_part.begin(), vector_part.end());
+        }
+        bench::keep(all);
+    }, 8 * batch);
+    suite.run("merge 8/error_list", [&] {
+        jack::error_list all;
+        for (int i = 0; i < 8; ++i)
+        {
+            all.merge(list_part);
+        }
+        bench::keep(all);
+    }, 8 * batch);
+
+    // memory kept per error once built; the vector is sized exactly so
+    // that growth isn't counted against it
+    const auto before = bench::allocations();
+    std::vector<jack::error> kept;
+    kept.reserve(batch);
+    for (int i = 0; i < batch; ++i)
+    {
+        kept.push_back(make_error(i));
+    }
+    const auto after = bench::allocations();
+    bench::keep(kept);
+    std::printf("\nkept per error: vector<error> %.1f bytes, error_list %.1f bytes\n",
+            static_cast<double>(after.bytes - before.bytes) / batch,
+            static_cast<double>(sizeof(jack::error_list) +
+                    list_part.heap_bytes()) / batch);
+
+    return suite.finish();
+}
@@ -0,0 +1,127 @@
+// Throwing versus returning an error, across call depths, to set policy
+// from: returning a jack::result up every call, throwing a
+// jack::exception that try_call turns back into an error at the top,
+// & throwing a std::runtime_error that the top catches & copies into a
+// jack::error (what boundaries did before jack/exception.hpp).  No call
+// in between adds context.
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+#include "bench.hpp"
+#include "jack/exception.hpp"
+
+// fail every call when set
+static volatile bool failing = false;
+
+BENCH_NOINLINE jack::result<std::size_t> result_leaf(unsigned i)
+{
+    if (failing)
+    {
+        return jack::derror(1001, "short read at offset ", i);
+    }
+    return std::size_t{i};
+}
+
+template <int depth>
+BENCH_NOINLINE jack::result<std::size_t> result_call(unsigned i)
+{
+    return (depth == 1 ? result_leaf(i) : result_call<depth - 1>(i))
+        .and_then([](std::size_t n) -> jack::result<std::size_t> {
+            return n + depth;
+        });
+}
+
+template <>
+jack::result<std::size_t> result_call<0>(unsigned i)
+{
+    return result_leaf(i);
+}
+
+BENCH_NOINLINE std::size_t jack_leaf(unsigned i)
+{
+    if (failing)
+    {
+        throw jack::exception(1001, "short read at offset ", i);
+    }
+    return i;
+}
+
+template <int depth>
+BENCH_NOINLINE std::size_t jack_call(unsigned i)
+{
+    return (depth == 1 ? jack_leaf(i) : jack_call<depth - 1>(i)) + depth;
+}
+
+template <>
+std::size_t jack_call<0>(unsigned i)
+{
+    return jack_leaf(i);
+}
+
+BENCH_NOINLINE std::size_t std_leaf(unsigned i)
+{
+    if (failing)
+    {
+        throw std::runtime_error("short read at offset " + std::to_string(i));
+    }
+    return i;
+}
+
+template <int depth>
+BENCH_NOINLINE std::size_t std_call(unsigned i)
+{
+    return (depth == 1 ? std_leaf(i) : std_call<depth - 1>(i)) + depth;
+}
+
+template <>
+std::size_t std_call<0>(unsigned i)
+{
+    return std_leaf(i);
+}
+
+// the boundary before jack/exception.hpp
+template <int depth>
+static jack::result<std::size_t> std_boundary(unsigned i)
+{
+    try
+    {
+        return std_call<depth>(i);
+    }
+    catch (const std::exception& e)
+    {
+        return jack::error(1001, e.what());
+    }
+}
+
+template <int depth>
+static void run(bench::suite& suite, const std::string& suffix)
+{
+    const std::string d = "/" + std::to_string(depth) + " deep";
+    unsigned i = 0;
+    suite.run("return jack::result" + d + suffix, [&] {
+        bench::keep(result_call<depth>(++i).has_value());
+    });
+    suite.run("throw jack::exception" + d + suffix, [&] {
+        bench::keep(jack::try_call(jack_call<depth>, ++i).has_value());
+    });
+    suite.run("throw std::runtime_error" + d + suffix, [&] {
+        bench::keep(std_boundary<depth>(++i).has_value());
+    });
+}
+
+int main(int argc, char** argv)
+{
+    bench::suite suite("throwing or returning an error", argc, argv);
+    for (const bool fail : {false, true})
+    {
+        const std::string suffix = fail ? "/always fails" : "/never fails";
+        failing = fail;
+        run<1>(suite, suffix);
+        run<4>(suite, suffix);
+        run<16>(suite, suffix);
+        run<64>(suite, suffix);
+    }
+    return suite.finish();
+}
@@ -0,0 +1,57 @@
+#include <sstream>
+#include <string>
+
+#include "bench.hpp"
+#include "jack/error.hpp"
+
+// how detail::make_str worked before: one std::stringstream per call
+template <typename... ts>
+static std::string stream_str(const ts&... args)
+{
+    std::stringstream ss;
+    using expand = int[];
+    (void)expand{0, (ss << args, 0)...};
+    return ss.str();
+}
+
+int main(int argc, char** argv)
+{
+    const std::string path("/var/lib/service/data.bin");
+    const jack::reason inner("connection reset by peer");
+
+    bench::suite suite("formatting an error description", argc, argv);
+
+    suite.run("stringstream/literal + int",
+            [] { bench::keep(stream_str("bad fd ", 7)); });
+    suite.run("make_str/literal + int",
+            [] { bench::keep(jack::detail::make_str("bad fd ", 7)); });
+
+    suite.run("stringstream/mixed strings & ints",
+            [&] { bench::keep(stream_str("read ", 4096, " of ", 8192l,
+                    " bytes from ", path, ": ", inner)); });
+    suite.run("make_str/mixed strings & ints",
+            [&] { bench::keep(jack::detail::make_str("read ", 4096, " of ",
+                    8192l, " bytes from ", path, ": ", inner)); });
+#if __cplusplus >= 201703L
+    suite.run("JACK_FMT/mixed strings & ints",
+            [&] { bench::keep(jack::debug::str(JACK_FMT(
+                    "read {:d} of {:d} bytes from {:s}: {:s}"),
+                    4096, 8192l, path, inner)); });
+#endif
+
+    suite.run("stringstream/floating point",
+            [] { bench::keep(stream_str("latency ", 12.75, "ms over ",
+                    0.25f, "ms budget")); });
+    suite.run("make_str/floating point",
+            [] { bench::keep(jack::detail::make_str("latency ", 12.75,
+                    "ms over ", 0.25f, "ms budget")); });
+
+    suite.run("stringstream/error(code, ...)",
+            [&] { bench::keep(jack::error(1001, jack::reason(stream_str(
+                    "open ", path, " failed w/ errno ", 13)))); });
+    suite.run("make_str/error(code, ...)",
+            [&] { bench::keep(jack::error(1001, "open ", path,
+                    " failed w/ errno ", 13)); });
+
+    return suite.finish();
+}
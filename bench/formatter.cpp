@@ -0,0 +1,202 @@
+// User types in error messages: an IPv4 address, a request id & an
+// enum, written with operator<< (the fallback, which streams each value
+// into a temporary string) against the same types with a
+// jack::formatter, which write straight into the reason's buffer.
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+
+#include "bench.hpp"
+#include "jack/error.hpp"
+
+namespace streamed
+{
+
+struct ipv4
+{
+    unsigned char octets[4];
+};
+
+struct request_id
+{
+    std::uint64_t value;
+};
+
+enum class state
+{
+    connecting,
+    established
+};
+
+std::ostream& operator<<(std::ostream& os, const ipv4& ip)
+{
+    return os << unsigned(ip.octets[0]) << '.' << unsigned(ip.octets[1]) << '.'
+            << unsigned(ip.octets[2]) << '.' << unsigned(ip.octets[3]);
+}
+
+std::ostream& operator<<(std::ostream& os, const request_id& id)
+{
+    static const char digits[] = "0123456789abcdef";
+    char buf[16];
+    for (int i = 0; i < 16; ++i)
+    {
+        buf[i] = digits[(id.value >> (60 - 4 * i)) & 0xf];
+    }
+    return os.write(buf, 16);
+}
+
+std::ostream& operator<<(std::ostream& os, state s)
+{
+    return os << (s == state::connecting ? "connecting" : "established");
+}
+
+} // namespace streamed
+
+namespace formatted
+{
+
+struct ipv4
+{
+    unsigned char octets[4];
+};
+
+struct request_id
+{
+    std::uint64_t value;
+};
+
+enum class state
+{
+    connecting,
+    established
+};
+
+} // namespace formatted
+
+namespace jack
+{
+
+template <>
+struct formatter<formatted::ipv4>
+{
+    static std::size_t size(const formatted::ipv4& ip)
+    {
+        std::size_t n = 3;
+        for (unsigned char o : ip.octets)
+        {
+            n += o >= 100 ? 3 : o >= 10 ? 2 : 1;
+        }
+        return n;
+    }
+
+    static char* write(const formatted::ipv4& ip, char* out)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            const unsigned o = ip.octets[i];
+            if (o >= 100)
+            {
+                *out++ = static_cast<char>('0' + o / 100);
+            }
+            if (o >= 10)
+            {
+                *out++ = static_cast<char>('0' + o / 10 % 10);
+            }
+            *out++ = static_cast<char>('0' + o % 10);
+            if (i != 3)
+            {
+                *out++ = '.';
+            }
+        }
+        return out;
+    }
+};
+
+template <>
+struct formatter<formatted::request_id>
+{
+    static std::size_t size(const formatted::request_id&)
+    {
+        return 16;
+    }
+
+    static char* write(const formatted::request_id& id, char* out)
+    {
+        static const char digits[] = "0123456789abcdef";
+        for (int i = 0; i < 16; ++i)
+        {
+            *out++ = digits[(id.value >> (60 - 4 * i)) & 0xf];
+        }
+        return out;
+    }
+};
+
+template <>
+struct formatter<formatted::state>
+{
+    static std::size_t size(formatted::state s)
+    {
+        return s == formatted::state::connecting ? 10 : 11;
+    }
+
+    static char* write(formatted::state s, char* out)
+    {
+        const char* name = s == formatted::state::connecting ?
+                "connecting" : "established";
+        std::memcpy(out, name, size(s));
+        return out + size(s);
+    }
+};
+
+} // namespace jack
+
+template <typename ip_t, typename id_t, typename state_t>
+BENCH_NOINLINE static jack::error fail(const ip_t& ip, const id_t& id,
+        state_t s)
+{
+    jack::error e(1001, "connection to ", ip, " reset while ", s);
+    e.wrap("request ", id);
+    return e;
+}
+
+int main(int argc, char** argv)
+{
+    bench::suite suite("user types in an error", argc, argv);
+
+    const streamed::ipv4 sip{{10, 0, 128, 255}};
+    const formatted::ipv4 fip{{10, 0, 128, 255}};
+    const streamed::request_id sid{0x5eed1234abcdef01ull};
+    const formatted::request_id fid{0x5eed1234abcdef01ull};
+
+    suite.run("operator<</ipv4", [&] {
+        bench::keep(jack::reason("peer ", sip));
+    });
+    suite.run("formatter/ipv4", [&] {
+        bench::keep(jack::reason("peer ", fip));
+    });
+
+    suite.run("operator<</request id", [&] {
+        bench::keep(jack::reason("request ", sid));
+    });
+    suite.run("formatter/request id", [&] {
+        bench::keep(jack::reason("request ", fid));
+    });
+
+    suite.run("operator<</enum", [&] {
+        bench::keep(jack::reason("state ", streamed::state::established));
+    });
+    suite.run("formatter/enum", [&] {
+        bench::keep(jack::reason("state ", formatted::state::established));
+    });
+
+    // all three in one error, wrapped once
+    suite.run("operator<</error + wrap", [&] {
+        bench::keep(fail(sip, sid, streamed::state::connecting));
+    });
+    suite.run("formatter/error + wrap", [&] {
+        bench::keep(fail(fip, fid, formatted::state::connecting));
+    });
+
+    return suite.finish();
+}
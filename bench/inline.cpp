@@ -0,0 +1,114 @@
+// How much of a reason to store inside the object.  The workload is a
+// failure returned by value up a call chain 0-3 deep, each caller
+// wrapping it with some context, and an occasional extend at the root.
+//
+// The table at the end gives sizeof & the share of errors that never
+// touch the heap, built alone and built then read once.
+
+#include <cstdio>
+
+#include "bench.hpp"
+#include "jack/error.hpp"
+
+template <std::size_t n>
+using reason_t = jack::basic_reason<std::allocator<char>, n>;
+
+static const char* const roots[] = {
+    "timeout",
+    "connection refused",
+    "no such file or directory",
+    "permission denied: /var/lib/app/state.db",
+    "unexpected '}' at line 212, column 17 of config"
+};
+
+constexpr int workload = 60;
+
+template <std::size_t n>
+BENCH_NOINLINE static reason_t<n> fail(int i)
+{
+    reason_t<n> r(roots[i % 5]);
+    if (i % 6 == 0)
+    {
+        r.extend("attempt ", i % 3 + 1);
+    }
+    return r;
+}
+
+template <std::size_t n>
+BENCH_NOINLINE static reason_t<n> call(int i, int depth)
+{
+    if (depth == 0)
+    {
+        return fail<n>(i);
+    }
+    reason_t<n> r = call<n>(i, depth - 1);
+    switch (depth)
+    {
+    case 1:
+        r.wrap("fetching shard ", i % 64);
+        break;
+    case 2:
+        r.wrap("loading users");
+        break;
+    default:
+        r.wrap("handling request ", 48213 + i);
+        break;
+    }
+    return r;
+}
+
+template <std::size_t n>
+static void run(bench::suite& suite)
+{
+    const std::string suffix = "/capacity=" + std::to_string(n);
+    suite.run("build" + suffix, [] {
+        for (int i = 0; i < workload; ++i)
+        {
+            bench::keep(call<n>(i, i % 4));
+        }
+    }, workload);
+    suite.run("build + read" + suffix, [] {
+        for (int i = 0; i < workload; ++i)
+        {
+            bench::keep(call<n>(i, i % 4).c_str());
+        }
+    }, workload);
+}
+
+template <std::size_t n>
+static void report()
+{
+    int built = 0;
+    int read = 0;
+    for (int i = 0; i < workload; ++i)
+    {
+        const auto before = bench::allocations();
+        const reason_t<n> r = call<n>(i, i % 4);
+        built += bench::allocations().allocs == before.allocs;
+        bench::keep(r.c_str());
+        read += bench::allocations().allocs == before.allocs;
+    }
+    // an error is its code & its reason
+    std::printf("%8zu %15zu %14zu %13.0f%% %13.0f%%\n", n, sizeof(reason_t<n>),
+            sizeof(jack::error) - sizeof(jack::reason) + sizeof(reason_t<n>),
+            100.0 * built / workload, 100.0 * read / workload);
+}
+
+int main(int argc, char** argv)
+{
+    bench::suite suite("returning wrapped reasons (per error)", argc, argv);
+    run<16>(suite);
+    run<32>(suite);
+    run<64>(suite);
+    run<128>(suite);
+    run<256>(suite);
+
+    std::printf("\ncapacity  sizeof(reason)  sizeof(error)  no heap/built  no heap/read\n");
+    report<16>();
+    report<32>();
+    report<64>();
+    report<128>();
+    report<256>();
+
+    return suite.finish();
+}
@@ -0,0 +1,46 @@
+// An error raised & wrapped on a thread that must not allocate, e.g. an
+// audio callback, against the heap-backed error doing the same.
+
+#include "bench.hpp"
+#include "jack/error.hpp"
+
+BENCH_NOINLINE static jack::error fail_heap(int bus, int frames)
+{
+    jack::error e(1001, "buffer underrun by ", frames, " frames");
+    e.wrap("mixing bus ", bus).extend(jack::literal("dropping"));
+    return e;
+}
+
+BENCH_NOINLINE static jack::inplace_error<128> fail_inplace(int bus, int frames)
+{
+    jack::inplace_error<128> e(1001, "buffer underrun by ", frames, " frames");
+    e.wrap("mixing bus ", bus).extend(jack::literal("dropping"));
+    return e;
+}
+
+int main(int argc, char** argv)
+{
+    bench::suite suite("underrun error in a real-time callback", argc, argv);
+
+    suite.run("error/build", [] {
+        bench::keep(fail_heap(3, 128));
+    });
+    suite.run("inplace_error<128>/build", [] {
+        bench::keep(fail_inplace(3, 128));
+    });
+
+    suite.run("error/build + read", [] {
+        bench::keep(fail_heap(3, 128).desc.c_str());
+    });
+    suite.run("inplace_error<128>/build + read", [] {
+        const auto e = fail_inplace(3, 128);
+        bench::keep(e.desc.c_str());
+    });
+
+    // handing the error to a thread that may allocate
+    suite.run("inplace_error<128>/build + to_error", [] {
+        bench::keep(fail_inplace(3, 128).to_error());
+    });
+
+    return suite.finish();
+}
@@ -0,0 +1,58 @@
+// An error wrapped on every attempt of a retry loop.  Unbounded, the
+// description grows with the number of attempts & each wrap copies more
+// of it; with a limit, wraps stay the same cost and the reason stays the
+// same size however long the loop runs.  Rows are per wrap.
+
+#include "bench.hpp"
+#include "jack/error.hpp"
+
+static constexpr int attempts = 1000;
+
+template <typename limit_fn>
+BENCH_NOINLINE static jack::error retry(int attempts, limit_fn&& limit)
+{
+    jack::error e(1001, "connection refused");
+    limit(e);
+    for (int i = 0; i < attempts; ++i)
+    {
+        e.wrap("attempt ", i, " of ", attempts);
+    }
+    return e;
+}
+
+int main(int argc, char** argv)
+{
+    bench::suite suite("wrapping in a retry loop", argc, argv);
+
+    const auto none = [](jack::error&) {};
+    const auto frames = [](jack::error& e) { e.limit(8); };
+    const auto size = [](jack::error& e) { e.limit(0, 256); };
+
+    suite.run("unlimited/x1000", [&] {
+        bench::keep(retry(attempts, none));
+    }, attempts);
+    suite.run("limit(8)/x1000", [&] {
+        bench::keep(retry(attempts, frames));
+    }, attempts);
+    suite.run("limit(0, 256)/x1000", [&] {
+        bench::keep(retry(attempts, size));
+    }, attempts);
+
+    // reading once at the end renders all that was kept
+    suite.run("unlimited/x1000 + read", [&] {
+        bench::keep(retry(attempts, none).desc.c_str());
+    }, attempts);
+    suite.run("limit(8)/x1000 + read", [&] {
+        bench::keep(retry(attempts, frames).desc.c_str());
+    }, attempts);
+
+    // a short loop never reaches the limit, so pays only for the check
+    suite.run("unlimited/x4", [&] {
+        bench::keep(retry(4, none));
+    }, 4);
+    suite.run("limit(8)/x4", [&] {
+        bench::keep(retry(4, frames));
+    }, 4);
+
+    return suite.finish();
+}
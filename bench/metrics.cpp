@@ -0,0 +1,64 @@
+// Built twice: jack_bench_metrics with JACK_ERROR_METRICS defined and
+// jack_bench_metrics_off without it.  The rows share names, so the cost
+// of counting is the difference reported by
+//
+//   jack_bench_metrics_off --out off.csv
+//   jack_bench_metrics --baseline off.csv
+//
+// Each row is one batch of errors built on every worker thread at once;
+// ns/op is the time one core spends per error.
+
+#include <algorithm>
+#include <string>
+#include <thread>
+
+#include "bench.hpp"
+#include "jack/error.hpp"
+
+int main(int argc, char** argv)
+{
+    constexpr int per_thread = 16384;
+    const int cores = static_cast<int>(std::max(1u,
+            std::thread::hardware_concurrency()));
+
+#ifdef JACK_ERROR_METRICS
+    bench::suite suite("errors per thread (metrics on)", argc, argv);
+#else
+    bench::suite suite("errors per thread (metrics off)", argc, argv);
+#endif
+
+    for (int threads : {1, 2, 4, 8, 16, 32, 64})
+    {
+        const std::string suffix = "/threads=" + std::to_string(threads);
+        const std::size_t ops = static_cast<std::size_t>(per_thread) *
+                static_cast<std::size_t>(threads) /
+                static_cast<std::size_t>(std::min(threads, cores));
+
+        // the cheapest error there is, so counting is most visible
+        bench::pool literal(threads, [] {
+            for (int i = 0; i < per_thread; ++i)
+            {
+                bench::keep(jack::error(1000 + i % 16,
+                        jack::literal("connection refused")));
+            }
+        });
+        suite.run("literal" + suffix, [&] { literal.run_batch(); }, ops);
+
+        // built, then wrapped on the way up
+        bench::pool wrapped(threads, [] {
+            for (int i = 0; i < per_thread; ++i)
+            {
+                jack::error e(1000 + i % 16, jack::literal("connection refused"));
+                e.wrap(jack::literal("fetching shard"));
+                bench::keep(e);
+            }
+        });
+        suite.run("literal + wrap" + suffix, [&] { wrapped.run_batch(); }, ops);
+    }
+
+#ifdef JACK_ERROR_METRICS
+    const auto snap = jack::metrics::collect();
+    bench::keep(snap);
+#endif
+    return suite.finish();
+}
@@ -0,0 +1,47 @@
+#include <cstdio>
+
+#if __cplusplus < 201703L
+int main() { std::printf("This benchmark requires C++17\n"); }
+#else
+
+#include <memory_resource>
+#include <vector>
+
+#include "bench.hpp"
+#include "jack/error.hpp"
+
+// one request's worth of errors: built, wrapped, read, then all dropped
+template <typename error_t, typename alloc_t>
+static void handle_request(const alloc_t& alloc, int errors)
+{
+    std::vector<error_t, alloc_t> errs(alloc);
+    errs.reserve(static_cast<std::size_t>(errors));
+    for (int i = 0; i < errors; ++i)
+    {
+        errs.emplace_back(1001, "connection refused by upstream host ", i);
+        errs.back().wrap("while fetching shard ", i).wrap("handling request");
+        bench::keep(errs.back().desc.c_str());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bench::suite suite("errors built per request", argc, argv);
+    for (int errors : {1, 8, 64})
+    {
+        const auto suffix = "/errors=" + std::to_string(errors);
+        suite.run("jack::error (global heap)" + suffix, [errors] {
+            handle_request<jack::error>(std::allocator<jack::error>(), errors);
+        });
+        suite.run("jack::pmr::error (monotonic buffer)" + suffix, [errors] {
+            alignas(std::max_align_t) char buf[64 * 1024];
+            std::pmr::monotonic_buffer_resource res(buf, sizeof(buf));
+            handle_request<jack::pmr::error>(
+                    std::pmr::polymorphic_allocator<jack::pmr::error>(&res),
+                    errors);
+        });
+    }
+    return suite.finish();
+}
+
+#endif // __cplusplus < 201703L
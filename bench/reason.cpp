@@ -0,0 +1,75 @@
+#include <string>
+
+#include "bench.hpp"
+#include "jack/error.hpp"
+
+int main(int argc, char** argv)
+{
+    const char* short_cstr = "timed out";
+    const char* long_cstr = "connection refused by upstream host 10.0.0.1";
+    const std::string long_str(long_cstr);
+    const jack::reason long_reason(long_cstr);
+
+    bench::suite suite("jack::reason", argc, argv);
+
+    // construction from each overload
+    suite.run("construct/c string (short)",
+            [&] { bench::keep(jack::reason(short_cstr)); });
+    suite.run("construct/c string (long)",
+            [&] { bench::keep(jack::reason(long_cstr)); });
+    suite.run("construct/literal", [&] { bench::keep(jack::reason(
+            jack::literal("connection refused by upstream host 10.0.0.1"))); });
+    suite.run("construct/copy std::string",
+            [&] { bench::keep(jack::reason(long_str)); });
+    suite.run("construct/copy + move std::string", [&] {
+        std::string str(long_str);
+        bench::keep(jack::reason(std::move(str)));
+    });
+    suite.run("construct/copy reason",
+            [&] { bench::keep(jack::reason(long_reason)); });
+    suite.run("construct/copy + move reason", [&] {
+        jack::reason src(long_reason);
+        bench::keep(jack::reason(std::move(src)));
+    });
+    suite.run("construct/variadic (4 args)",
+            [&] { bench::keep(jack::reason("read ", 4096, " bytes from ",
+                    long_str)); });
+
+    // wrap & extend at increasing depth, then read once
+    for (int depth : {1, 4, 16, 64})
+    {
+        const auto suffix = "/depth=" + std::to_string(depth);
+        suite.run("wrap/c string" + suffix, [&] {
+            jack::reason r(long_cstr);
+            for (int i = 0; i < depth; ++i) r.wrap("while handling request");
+            bench::keep(r.c_str());
+        });
+        suite.run("wrap/std::string" + suffix, [&] {
+            jack::reason r(long_cstr);
+            for (int i = 0; i < depth; ++i) r.wrap(long_str);
+            bench::keep(r.c_str());
+        });
+        suite.run("wrap/reason" + suffix, [&] {
+            jack::reason r(long_cstr);
+            for (int i = 0; i < depth; ++i) r.wrap(long_reason);
+            bench::keep(r.c_str());
+        });
+        suite.run("wrap/variadic" + suffix, [&] {
+            jack::reason r(long_cstr);
+            for (int i = 0; i < depth; ++i) r.wrap("layer ", i, " failed");
+            bench::keep(r.c_str());
+        });
+        suite.run("extend/c string" + suffix, [&] {
+            jack::reason r(long_cstr);
+            for (int i = 0; i < depth; ++i) r.extend("while handling request");
+            bench::keep(r.c_str());
+        });
+        suite.run("extend/variadic" + suffix, [&] {
+            jack::reason r(long_cstr);
+            for (int i = 0; i < depth; ++i) r.extend("attempt ", i);
+            bench::keep(r.c_str());
+        });
+    }
+
+    return suite.finish();
+}
@@ -0,0 +1,139 @@
+// Rendering errors as JSON for a log pipeline: debug::str followed by an
+// escaping pass (what callers do without jack/render.hpp), against
+// render::json into a buffer & into a string.  Then the throughput of
+// render::json & json_size on long descriptions, in GB/s.
+//
+// The escape search is chosen when compiling; compare
+// jack_bench_render (SSE2 on x86-64) with jack_bench_render_avx2 &
+// jack_bench_render_scalar (JACK_ERROR_NO_SIMD).
+
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+#include <string>
+
+#include "bench.hpp"
+#include "jack/render.hpp"
+
+// the escaping pass a caller writes on top of debug::str
+static std::string escape(const std::string& in)
+{
+    static const char hex[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(in.size());
+    for (const char c : in)
+    {
+        const unsigned char u = static_cast<unsigned char>(c);
+        if (u == '"' || u == '\\')
+        {
+            out += '\\';
+            out += c;
+        }
+        else if (u < 0x20)
+        {
+            out += "\\u00";
+            out += hex[u >> 4];
+            out += hex[u & 0xf];
+        }
+        else
+        {
+            out += c;
+        }
+    }
+    return out;
+}
+
+BENCH_NOINLINE static jack::error make_error(int i)
+{
+    jack::error e(1001, "unexpected \"}\" at line ", 200 + i % 64,
+            " of the request body");
+    e.wrap("parsing ", "/etc/service/routes.json");
+    e.wrap("loading routes");
+    return e;
+}
+
+// a description of about size characters with a quote every 1000
+static jack::error long_error(std::size_t size)
+{
+    std::string text;
+    while (text.size() < size)
+    {
+        text += "the quick brown fox jumps over the lazy dog; ";
+        if (text.size() % 1000 < 45)
+        {
+            text += '"';
+        }
+    }
+    text.resize(size);
+    return jack::error(1, text);
+}
+
+// bytes of description per second, in GB/s
+template <typename fn_t>
+static double throughput(std::size_t bytes, fn_t&& fn)
+{
+    using clock = std::chrono::steady_clock;
+    std::size_t iters = 1;
+    for (;; iters *= 2)
+    {
+        const auto start = clock::now();
+        for (std::size_t i = 0; i < iters; ++i)
+        {
+            fn();
+        }
+        const double ns = std::chrono::duration<double, std::nano>(
+                clock::now() - start).count();
+        if (ns >= 2e8)
+        {
+            return static_cast<double>(bytes * iters) / ns;
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+#if defined(JACK_DETAIL_ESCAPE_AVX2)
+    const char* const search = "avx2";
+#elif defined(JACK_DETAIL_ESCAPE_SSE2)
+    const char* const search = "sse2";
+#else
+    const char* const search = "scalar";
+#endif
+    const std::string name = std::string("errors as JSON (") + search + ")";
+    bench::suite suite(name.c_str(), argc, argv);
+
+    int i = 0;
+    suite.run("debug::str + escape", [&] {
+        bench::keep(escape(jack::debug::str(make_error(++i))));
+    });
+
+    char buf[64 * 1024 + 64];
+    suite.run("render::json into buffer", [&] {
+        bench::keep(jack::render::json(make_error(++i), buf, sizeof(buf)));
+    });
+
+    suite.run("render::json into string", [&] {
+        const jack::error e = make_error(++i);
+        std::string out;
+        out.reserve(jack::render::json_size(e));
+        jack::render::json(e, std::back_inserter(out));
+        bench::keep(out);
+    });
+
+    // the table above is printed as rows finish; this one follows it
+    std::printf("\n%-24s %8s %12s %12s\n", "long descriptions", "size",
+            "json GB/s", "size GB/s");
+    for (const std::size_t size : {256u, 4096u, 65536u})
+    {
+        const jack::error e = long_error(size);
+        const double write = throughput(size, [&] {
+            bench::keep(jack::render::json(e, buf, sizeof(buf)));
+        });
+        const double measure = throughput(size, [&] {
+            bench::keep(jack::render::json_size(e));
+        });
+        std::printf("%-24s %8zu %12.2f %12.2f\n", "", size, write, measure);
+    }
+
+    return suite.finish();
+}
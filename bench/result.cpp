@@ -0,0 +1,151 @@
+// Returning a value or an error up a deep call chain, each layer adding
+// context to a failure: std::variant<std::size_t, jack::error> (what
+// callers glue together without jack::result), jack::result, & throwing
+// a jack::error that each layer catches, wraps & rethrows.
+
+#include <cstdio>
+
+#if __cplusplus < 201703L
+int main() { std::printf("This benchmark requires C++17\n"); }
+#else
+
+#include <variant>
+
+#include "bench.hpp"
+#include "jack/error.hpp"
+
+// fail once every `period` calls; 0 never fails
+static volatile unsigned period = 0;
+
+static bool should_fail(unsigned i)
+{
+    return period && i % period == 0;
+}
+
+using variant = std::variant<std::size_t, jack::error>;
+
+BENCH_NOINLINE variant variant_leaf(unsigned i)
+{
+    if (should_fail(i))
+    {
+        return jack::error(1001, "short read at offset ", i);
+    }
+    return std::size_t{i};
+}
+
+template <int depth>
+BENCH_NOINLINE variant variant_call(unsigned i)
+{
+    variant v = depth == 1 ? variant_leaf(i) : variant_call<depth - 1>(i);
+    if (std::size_t* n = std::get_if<std::size_t>(&v))
+    {
+        return *n + depth;
+    }
+    std::get<jack::error>(v).wrap("layer ", depth);
+    return v;
+}
+
+template <>
+variant variant_call<0>(unsigned i)
+{
+    return variant_leaf(i);
+}
+
+BENCH_NOINLINE jack::result<std::size_t> result_leaf(unsigned i)
+{
+    if (should_fail(i))
+    {
+        return jack::derror(1001, "short read at offset ", i);
+    }
+    return std::size_t{i};
+}
+
+template <int depth>
+BENCH_NOINLINE jack::result<std::size_t> result_call(unsigned i)
+{
+    return (depth == 1 ? result_leaf(i) : result_call<depth - 1>(i))
+        .and_then([](std::size_t n) -> jack::result<std::size_t> {
+            return n + depth;
+        })
+        .wrap("layer ", depth);
+}
+
+template <>
+jack::result<std::size_t> result_call<0>(unsigned i)
+{
+    return result_leaf(i);
+}
+
+BENCH_NOINLINE std::size_t throw_leaf(unsigned i)
+{
+    if (should_fail(i))
+    {
+        throw jack::error(1001, "short read at offset ", i);
+    }
+    return i;
+}
+
+template <int depth>
+BENCH_NOINLINE std::size_t throw_call(unsigned i)
+{
+    try
+    {
+        return (depth == 1 ? throw_leaf(i) : throw_call<depth - 1>(i)) + depth;
+    }
+    catch (jack::error& e)
+    {
+        e.wrap("layer ", depth);
+        throw;
+    }
+}
+
+template <>
+std::size_t throw_call<0>(unsigned i)
+{
+    return throw_leaf(i);
+}
+
+template <int depth>
+static void run(bench::suite& suite, const std::string& suffix)
+{
+    const std::string d = "/" + std::to_string(depth) + " deep";
+    unsigned i = 0;
+    suite.run("std::variant" + d + suffix, [&] {
+        bench::keep(variant_call<depth>(++i).index());
+    });
+    suite.run("jack::result" + d + suffix, [&] {
+        bench::keep(result_call<depth>(++i).has_value());
+    });
+    suite.run("throw & catch" + d + suffix, [&] {
+        try
+        {
+            bench::keep(throw_call<depth>(++i));
+        }
+        catch (const jack::error& e)
+        {
+            bench::keep(e.code);
+        }
+    });
+}
+
+int main(int argc, char** argv)
+{
+    std::printf("sizeof(std::variant<std::size_t, jack::error>) = %zu, "
+            "sizeof(jack::result<std::size_t>) = %zu\n\n",
+            sizeof(variant), sizeof(jack::result<std::size_t>));
+
+    bench::suite suite("returning a value or an error through deep calls",
+            argc, argv);
+    for (unsigned p : {0u, 1000u, 10u, 1u})
+    {
+        const std::string suffix = p == 0 ? "/never fails" :
+                p == 1 ? "/always fails" :
+                "/fails 1 in " + std::to_string(p);
+        period = p;
+        run<8>(suite, suffix);
+        run<32>(suite, suffix);
+    }
+    return suite.finish();
+}
+
+#endif // __cplusplus < 201703L
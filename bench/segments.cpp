@@ -0,0 +1,83 @@
+// Writing an error to a file: building the flat line with debug::str &
+// writing it, against handing its segments to writev, and against
+// copying the segments into a caller's buffer.  Output goes to /dev/null,
+// so the rows compare formatting, copying and system calls rather than
+// the disk.  Each row makes a fresh error, as a logger would see it.
+
+#include <cstdio>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "bench.hpp"
+#include "jack/error.hpp"
+
+static const std::string path("/var/lib/service/shards/0012/segment-000341.data");
+
+BENCH_NOINLINE static jack::error make_error(int i)
+{
+    jack::error e(1001, "unexpected end of file after ", 4096 + i % 512,
+            " bytes while reading the index block");
+    e.wrap("reading ", path);
+    e.wrap("loading shard ", i % 64, " of table 'accounts'");
+    e.wrap("starting the storage engine");
+    return e;
+}
+
+int main(int argc, char** argv)
+{
+    const int fd = ::open("/dev/null", O_WRONLY);
+    if (fd < 0)
+    {
+        std::perror("/dev/null");
+        return 1;
+    }
+
+    bench::suite suite("logging an error to a file", argc, argv);
+
+    int i = 0;
+    suite.run("debug::str + write", [&] {
+        std::string line = jack::debug::str(make_error(++i));
+        line += '\n';
+        bench::keep(::write(fd, line.data(), line.size()));
+    });
+
+    suite.run("segments + writev", [&] {
+        const jack::error e = make_error(++i);
+        const jack::segments out(e);
+        iovec iov[jack::segments::max_segments + 1];
+        std::size_t n = out.to_iovec(iov);
+        iov[n].iov_base = const_cast<char*>("\n");
+        iov[n].iov_len = 1;
+        bench::keep(::writev(fd, iov, static_cast<int>(n + 1)));
+    });
+
+    // into a buffer the caller already has, e.g. a log ring
+    char buffer[1024];
+    suite.run("segments + copy", [&] {
+        const jack::error e = make_error(++i);
+        const jack::segments out(e);
+        if (out.bytes() < sizeof(buffer))
+        {
+            *out.copy(buffer) = '\n';
+        }
+        bench::keep(buffer);
+    });
+
+    // debug::str renders the description into the reason, then copies
+    // it again into the line; segments copy only the short pieces
+    const jack::error e = make_error(0);
+    const jack::segments out(e);
+    const std::size_t line = out.bytes() + 1;
+    std::printf("\nbytes copied per error (%zu byte line, %zu segments):\n",
+            line, out.size());
+    std::printf("  debug::str + write  %zu\n", e.desc.size() + line);
+    std::printf("  segments + writev   %zu\n", out.copied());
+    std::printf("  segments + copy     %zu\n", out.copied() + line);
+
+    const int status = suite.finish();
+    ::close(fd);
+    return status;
+}
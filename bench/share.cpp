@@ -0,0 +1,101 @@
+// One error copied to several consumers: a log, a response, a retry
+// tracker & metrics.  Long errors share their heap storage between
+// copies, so a copy is a reference count update whatever the length.
+// Rows share names with a build of this file against an earlier header,
+// so the cost of deep copies is reported by
+//
+//   jack_bench_share --baseline <csv from the earlier build's --out>
+//
+// The threaded rows copy, read & drop one error on every worker at once.
+// All copies update the same count, so ns/op rising with the number of
+// threads is the cost of moving its cache line between cores.
+
+#include <algorithm>
+#include <string>
+#include <thread>
+
+#include "bench.hpp"
+#include "jack/error.hpp"
+
+static jack::error make_short()
+{
+    jack::error e(1001, "connection refused");
+    e.wrap("dialing ", 80);
+    return e;
+}
+
+static jack::error make_long()
+{
+    jack::error e(1001, "unexpected '}' at line 212, column 17 of "
+            "/etc/app/config.json: expected a string or a number");
+    e.wrap("loading configuration for shard ", 12);
+    e.wrap("starting worker ", 3, " of 8");
+    e.trace(jack::location{"src/worker.cpp", "start", 88});
+    e.extend("retrying in ", 250, " ms");
+    return e;
+}
+
+BENCH_NOINLINE static void consume(const jack::error& e)
+{
+    bench::keep(e);
+}
+
+int main(int argc, char** argv)
+{
+    bench::suite suite("copying one error", argc, argv);
+
+    const jack::error shorter = make_short();
+    const jack::error longer = make_long();
+    bench::keep(longer.desc.c_str());
+
+    suite.run("copy/short", [&] {
+        jack::error copy(shorter);
+        consume(copy);
+    });
+    suite.run("copy/long", [&] {
+        jack::error copy(longer);
+        consume(copy);
+    });
+
+    // the usual fan-out: made, copied four times, each copy read once
+    suite.run("fan-out x4 + read/long", [] {
+        const jack::error e = make_long();
+        const jack::error log(e);
+        const jack::error response(e);
+        const jack::error retry(e);
+        const jack::error metrics(e);
+        bench::keep(log.desc.c_str());
+        bench::keep(response.desc.c_str());
+        bench::keep(retry.desc.c_str());
+        bench::keep(metrics.desc.c_str());
+    });
+
+    // a copy that is then wrapped pays for its own storage
+    suite.run("copy + wrap/long", [&] {
+        jack::error copy(longer);
+        copy.wrap("handling request");
+        consume(copy);
+    });
+
+    constexpr int per_thread = 4096;
+    const int cores = static_cast<int>(std::max(1u,
+            std::thread::hardware_concurrency()));
+    for (int threads : {1, 2, 4, 8})
+    {
+        const std::string suffix = "/threads=" + std::to_string(threads);
+        const std::size_t ops = static_cast<std::size_t>(per_thread) *
+                static_cast<std::size_t>(threads) /
+                static_cast<std::size_t>(std::min(threads, cores));
+
+        bench::pool copies(threads, [&longer] {
+            for (int i = 0; i < per_thread; ++i)
+            {
+                const jack::error copy(longer);
+                bench::keep(copy.desc.c_str());
+            }
+        });
+        suite.run("copy + read/long" + suffix, [&] { copies.run_batch(); }, ops);
+    }
+
+    return suite.finish();
+}
@@ -0,0 +1,102 @@
+// Logging errors from many threads at once: formatting & writing each one
+// on the thread that failed, against handing it to a jack::sink.  Output
+// goes to /dev/null, so the rows compare formatting, system calls and
+// contention rather than the disk.
+//
+// Each row is one batch of errors logged on every worker thread at once;
+// the sink rows end with flush(), so they include the flusher's work.
+// ns/op is the time one core spends per error.
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "bench.hpp"
+#include "jack/sink.hpp"
+
+static jack::error make_error(int i)
+{
+    jack::error e(1001, "connection refused by 10.0.0.", i % 256, ":", 8080);
+    e.wrap("fetching shard ", i % 64);
+    return e;
+}
+
+int main(int argc, char** argv)
+{
+    constexpr int per_thread = 4096;
+    const int cores = static_cast<int>(std::max(1u,
+            std::thread::hardware_concurrency()));
+    const int fd = ::open("/dev/null", O_WRONLY);
+    if (fd < 0)
+    {
+        std::perror("/dev/null");
+        return 1;
+    }
+
+    bench::suite suite("logging errors from worker threads", argc, argv);
+
+    jack::sink_options blocking;
+    blocking.when_full = jack::backpressure::block;
+    jack::sink sink(fd, blocking);
+
+    jack::sink_options dropping;
+    dropping.capacity = 1024;
+    jack::sink lossy(fd, dropping);
+
+    for (int threads : {1, 2, 4, 8, 16})
+    {
+        const std::string suffix = "/threads=" + std::to_string(threads);
+        const std::size_t ops = static_cast<std::size_t>(per_thread) *
+                static_cast<std::size_t>(threads) /
+                static_cast<std::size_t>(std::min(threads, cores));
+
+        // today: one write per error on the request path
+        bench::pool inline_write(threads, [fd] {
+            for (int i = 0; i < per_thread; ++i)
+            {
+                std::string line = jack::debug::str(make_error(i));
+                line += '\n';
+                bench::keep(::write(fd, line.data(), line.size()));
+            }
+        });
+        suite.run("inline debug::str + write" + suffix,
+                [&] { inline_write.run_batch(); }, ops);
+
+        bench::pool pushed(threads, [&sink] {
+            for (int i = 0; i < per_thread; ++i)
+            {
+                sink.push(make_error(i));
+            }
+        });
+        suite.run("sink push (block)" + suffix, [&] {
+            pushed.run_batch();
+            sink.flush();
+        }, ops);
+
+        // the request path alone; whatever the flusher can't keep up with
+        // is dropped
+        bench::pool dropped(threads, [&lossy] {
+            for (int i = 0; i < per_thread; ++i)
+            {
+                lossy.push(make_error(i));
+            }
+        });
+        suite.run("sink push (drop)" + suffix, [&] { dropped.run_batch(); }, ops);
+    }
+
+    lossy.flush();
+    std::printf("\nblocking sink: %llu written, %llu overflows\n",
+            static_cast<unsigned long long>(sink.written()),
+            static_cast<unsigned long long>(sink.overflows()));
+    std::printf("dropping sink: %llu written, %llu dropped\n",
+            static_cast<unsigned long long>(lossy.written()),
+            static_cast<unsigned long long>(lossy.dropped()));
+
+    const int status = suite.finish();
+    ::close(fd);
+    return status;
+}
@@ -0,0 +1,75 @@
+#include <vector>
+
+#include "bench.hpp"
+#include "jack/error.hpp"
+
+// each call adds its own call site, as one function per stack frame would
+BENCH_NOINLINE static void add_formatted(jack::error& e)
+{
+    e.wrap(__FILE__, ":", __LINE__, " in ", __func__);
+}
+
+BENCH_NOINLINE static void add_traced(jack::error& e)
+{
+    e.trace();
+}
+
+// what the trace is meant to cost: a push of a small struct per frame
+BENCH_NOINLINE static void add_struct(std::vector<jack::location>& trace)
+{
+    trace.push_back(jack::location::current());
+}
+
+int main(int argc, char** argv)
+{
+    constexpr int depth = 10;
+
+    bench::suite suite("10-frame call-site trace", argc, argv);
+
+    suite.run("vector<location>::push_back", [] {
+        std::vector<jack::location> trace;
+        trace.reserve(depth);
+        for (int i = 0; i < depth; ++i)
+        {
+            add_struct(trace);
+        }
+        bench::keep(trace);
+    });
+
+    // most errors are handled by code & never printed
+    suite.run("wrap(__FILE__, __LINE__, __func__)/unread", [] {
+        jack::error e(1001, jack::literal("connection refused"));
+        for (int i = 0; i < depth; ++i)
+        {
+            add_formatted(e);
+        }
+        bench::keep(e);
+    });
+    suite.run("trace()/unread", [] {
+        jack::error e(1001, jack::literal("connection refused"));
+        for (int i = 0; i < depth; ++i)
+        {
+            add_traced(e);
+        }
+        bench::keep(e);
+    });
+
+    suite.run("wrap(__FILE__, __LINE__, __func__)/read", [] {
+        jack::error e(1001, jack::literal("connection refused"));
+        for (int i = 0; i < depth; ++i)
+        {
+            add_formatted(e);
+        }
+        bench::keep(e.desc.c_str());
+    });
+    suite.run("trace()/read", [] {
+        jack::error e(1001, jack::literal("connection refused"));
+        for (int i = 0; i < depth; ++i)
+        {
+            add_traced(e);
+        }
+        bench::keep(e.desc.c_str());
+    });
+
+    return suite.finish();
+}
@@ -0,0 +1,75 @@
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "jack/error.hpp"
+
+// the receiving side of today's string transport: pull the code & the
+// description back out of debug::str's output
+static jack::error parse_debug_str(const std::string& str)
+{
+    static const char code_key[] = "code: ";
+    static const char desc_key[] = "desc: \"";
+    const std::size_t code_pos = str.find(code_key) + sizeof(code_key) - 1;
+    const int code = static_cast<int>(std::strtol(str.c_str() + code_pos,
+            nullptr, 10));
+    const std::size_t desc_pos = str.find(desc_key) + sizeof(desc_key) - 1;
+    return jack::error(code, str.substr(desc_pos, str.size() - desc_pos - 3));
+}
+
+int main(int argc, char** argv)
+{
+    const jack::error short_err(1001, "connection refused");
+    const jack::error wrapped_err = [] {
+        jack::error e(1001, "connection refused by upstream host 10.0.0.1");
+        for (int i = 0; i < 8; ++i)
+        {
+            e.wrap("layer ", i).extend("attempt ", i);
+        }
+        return e;
+    }();
+
+    bench::suite suite("error transport", argc, argv);
+
+    for (const auto* e : {&short_err, &wrapped_err})
+    {
+        const std::string suffix = e == &short_err ? "/short" : "/wrapped x16";
+        std::vector<char> buf(jack::wire::encoded_size(*e));
+        jack::wire::encode(*e, buf.data(), buf.size());
+        const std::string str = jack::debug::str(*e);
+
+        // sender
+        suite.run("encode/debug::str" + suffix,
+                [&] { bench::keep(jack::debug::str(*e)); });
+        suite.run("encode/wire::encode" + suffix, [&] {
+            bench::keep(jack::wire::encode(*e, buf.data(), buf.size()));
+            bench::keep(buf);
+        });
+
+        // receiver
+        suite.run("decode/parse debug::str" + suffix,
+                [&] { bench::keep(parse_debug_str(str)); });
+        suite.run("decode/error_view" + suffix, [&] {
+            const jack::error_view view(buf.data(), buf.size());
+            bench::keep(view.code());
+            bench::keep(view.c_str());
+        });
+        suite.run("decode/error_view::to_error" + suffix, [&] {
+            bench::keep(jack::error_view(buf.data(), buf.size()).to_error());
+        });
+
+        // both ends
+        suite.run("round trip/debug::str" + suffix,
+                [&] { bench::keep(parse_debug_str(jack::debug::str(*e))); });
+        suite.run("round trip/wire + view" + suffix, [&] {
+            jack::wire::encode(*e, buf.data(), buf.size());
+            const jack::error_view view(buf.data(), buf.size());
+            bench::keep(view.code());
+            bench::keep(view.c_str());
+        });
+    }
+
+    return suite.finish();
+}
@@ -0,0 +1,43 @@
+#include <string>
+
+#include "bench.hpp"
+#include "jack/error.hpp"
+
+// how the description was built before frames: shift the whole
+// buffer on every wrap
+static std::string flat_wrap(int depth)
+{
+    std::string desc("connection refused by upstream host");
+    for (int i = 0; i < depth; ++i)
+    {
+        desc.reserve(desc.size() + 22);
+        desc.insert(0, ": ").insert(0, "while handling request");
+    }
+    return desc;
+}
+
+static jack::reason frame_wrap(int depth)
+{
+    jack::reason desc("connection refused by upstream host");
+    for (int i = 0; i < depth; ++i)
+    {
+        desc.wrap("while handling request");
+    }
+    desc.c_str();
+    return desc;
+}
+
+int main(int argc, char** argv)
+{
+    // build, wrap N times, read once
+    bench::suite suite("wrap depth scaling", argc, argv);
+    for (int depth : {1, 2, 4, 8, 16, 32, 64, 128, 256, 512})
+    {
+        const auto suffix = "/depth=" + std::to_string(depth);
+        suite.run("std::string insert" + suffix,
+                [depth] { bench::keep(flat_wrap(depth)); });
+        suite.run("jack::reason::wrap" + suffix,
+                [depth] { bench::keep(frame_wrap(depth)); });
+    }
+    return suite.finish();
+}
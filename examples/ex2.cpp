@@ -0,0 +1,30 @@
+#include <ctime>
+#include <iostream>
+
+#include "jack/error.hpp"
+
+jack::derror foo_may_fail() {
+    const auto val = std::rand();
+    if (val % 2) {
+        return {1001, "rand was odd w/ val ", val};
+    }
+    return {};
+}
+
+jack::derror bar_may_fail() {
+    auto maybe_err = foo_may_fail();
+    if (maybe_err) {
+        maybe_err.wrap("foo failed"); // now == "foo failed: rand was odd w/ val ..." 
+    }
+    return maybe_err;
+}
+
+int main()
+{
+    std::srand(std::time(nullptr));
+    for (int i = 0; i < 10; ++i)
+    {
+        auto v = bar_may_fail();
+        if (v) std::cout << jack::debug::str(*v) << '\n';
+    }
+}
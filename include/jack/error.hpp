@@ -28,93 +28,7273 @@
 #define JACK_ERROR_VERSION_PATCH 0
 
 #include <string>
-#include <sstream>
-#include <cstring>          // dangling?
+#include <vector>
+#include <memory>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <utility>
 #include <type_traits>
+#include <tuple>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#define JACK_DETAIL_CPP17
+#include <string_view>
+#include <system_error>
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#define JACK_DETAIL_HAS_CHARCONV
+#endif
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define JACK_DETAIL_HAS_PMR
+#endif
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define JACK_DETAIL_COLD __attribute__((cold, noinline))
+#define JACK_DETAIL_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#elif defined(_MSC_VER)
+#define JACK_DETAIL_COLD __declspec(noinline)
+#define JACK_DETAIL_UNLIKELY(x) (x)
+#else
+#define JACK_DETAIL_COLD
+#define JACK_DETAIL_UNLIKELY(x) (x)
+#endif
+
+// lets a type with a non-trivial destructor be returned in registers
+#if defined(__clang__) && defined(__has_cpp_attribute)
+#if __has_cpp_attribute(clang::trivial_abi)
+#define JACK_DETAIL_TRIVIAL_ABI [[clang::trivial_abi]]
+#endif
+#endif
+#ifndef JACK_DETAIL_TRIVIAL_ABI
+#define JACK_DETAIL_TRIVIAL_ABI
+#endif
+
+// call-site capture for jack::location::current
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_FILE) && __has_builtin(__builtin_FUNCTION) && \
+        __has_builtin(__builtin_LINE)
+#define JACK_DETAIL_HAS_BUILTIN_LOCATION
+#endif
+#elif defined(__GNUC__) || (defined(_MSC_VER) && _MSC_VER >= 1926)
+#define JACK_DETAIL_HAS_BUILTIN_LOCATION
+#endif
+#if !defined(JACK_DETAIL_HAS_BUILTIN_LOCATION) && defined(__has_include)
+#if __has_include(<source_location>) && __cplusplus >= 202002L
+#include <source_location>
+#define JACK_DETAIL_HAS_SOURCE_LOCATION
+#endif
+#endif
+
+// opt-in per-code error counters (see jack::metrics); define
+// JACK_ERROR_METRICS for every translation unit of the program
+#ifdef JACK_ERROR_METRICS
+#ifndef JACK_DETAIL_CPP17
+#error "JACK_ERROR_METRICS requires C++17"
+#endif
+#include <chrono>
+#include <mutex>
+#include <algorithm>
+#if defined(__linux__)
+#include <time.h>
+#endif
+// per-thread table size; a power of two
+#ifndef JACK_ERROR_METRICS_SLOTS
+#define JACK_ERROR_METRICS_SLOTS 128
+#endif
+#define JACK_DETAIL_ERROR_CREATED(err) \
+    ::jack::detail::metrics_created((err).code, (err).desc)
+#define JACK_DETAIL_ERROR_PROPAGATED(err) \
+    ::jack::detail::metrics_propagated((err).code)
+#else
+#define JACK_DETAIL_ERROR_CREATED(err) ((void)0)
+#define JACK_DETAIL_ERROR_PROPAGATED(err) ((void)0)
+#endif
+
+// JACK_ERROR_COMPILED is defined by the jack-error CMake target, which
+// compiles the larger members of jack::reason & jack::error, the common
+// formatting instantiations and the operator<< fallback once, in
+// src/error.cpp, instead of in every translation unit
+#ifdef JACK_ERROR_COMPILED
+#define JACK_DETAIL_OUT_OF_LINE
+#else
+#define JACK_DETAIL_OUT_OF_LINE inline
+#include <sstream>
+#endif
+
+// characters of a reason stored inside the object before it allocates
+// (see jack::basic_reason); define the same value for every translation
+// unit of the program
+#ifndef JACK_ERROR_INLINE_CAPACITY
+#define JACK_ERROR_INLINE_CAPACITY 64
+#endif
+
+#ifdef JACK_DETAIL_CPP17
+/**
+ * @brief Create a format string that is checked while compiling, for use
+ * as the first argument of reason's & error's variadic constructors,
+ * wrap, extend, and debug::str.  Placeholders are {} or {:t} where t is
+ * one of s (string), d (decimal), x / X (hex), c (character), e, f or g
+ * (floating point).  Use {{ and }} for literal braces.
+ * 
+ * @code
+ * jack::error e(1001, JACK_FMT("read {:d} of {:d} bytes from {:s}"), n, size, path);
+ * e.wrap(JACK_FMT("loading config {}"), name);
+ * @endcode
+ * 
+ * Requires C++17.
+ */
+#define JACK_FMT(str)                                                       \
+    [] {                                                                    \
+        struct jack_fmt : ::jack::detail::fmt_base                          \
+        {                                                                   \
+            static constexpr ::std::string_view value() { return str; }     \
+        };                                                                  \
+        return jack_fmt{};                                                  \
+    }()
+#endif
+
+namespace jack
+{
+
+template <typename alloc_t = std::allocator<char>,
+        std::size_t inline_capacity = JACK_ERROR_INLINE_CAPACITY>
+class basic_reason;
+
+namespace detail
+{
+struct reason_access;
+} // namespace detail
+
+/**
+ * @brief A reference to a string with static storage duration, such as
+ * a string literal.  A reason or error constructed from a literal only
+ * records its pointer & length; the characters are never copied, even
+ * when the reason is later wrapped or extended.
+ * 
+ * @code
+ * return jack::error(1001, jack::literal("connection refused"));
+ * @endcode
+ */
+struct literal
+{
+    /**
+     * @brief Refer to a string literal or static character array.
+     * 
+     * @param str null-terminated array that outlives every reason made
+     * from this literal
+     */
+    template <std::size_t n>
+    constexpr literal(const char (&str)[n]) noexcept : data(str), size(n - 1)
+    {
+    }
+
+    /**
+     * @brief Refer to a static string.
+     * 
+     * @param str first character; str[size] must be '\0' and the string
+     * must outlive every reason made from this literal
+     * @param size number of characters before the terminator
+     */
+    constexpr literal(const char* str, std::size_t size) noexcept :
+            data(str), size(size)
+    {
+    }
+
+    /// @brief First character of the null-terminated string.
+    const char* data;
+
+    /// @brief Number of characters before the terminator.
+    std::size_t size;
+};
+
+/**
+ * @brief Tag type that selects the deferred constructors of reason &
+ * error.
+ */
+struct deferred_t
+{
+    explicit deferred_t() = default;
+};
+
+/**
+ * @brief Pass as the first reason argument to format the description
+ * only when it is first read (c_str, size, operator<<, debug::str, or
+ * use as an argument).  Arithmetic values are stored as they are and
+ * strings are copied into a single allocation, so none of the arguments
+ * need to outlive the error.  Errors that are handled by their code
+ * alone never pay for formatting.
+ *
+ * @code
+ * return jack::error(1001, jack::deferred, "read ", n, " bytes from ", path);
+ * @endcode
+ */
+constexpr deferred_t deferred{};
+
+/**
+ * @brief A place in the source code: pointers to the file & function
+ * names (which have static storage duration) and a line number.  A
+ * reason wrapped or extended with a location stores the location itself
+ * and only writes "file:line in function" when the description is read,
+ * so tracing an error through many calls costs a small copy per call.
+ * 
+ * @code
+ * if (auto err = read_block(n))
+ *     return err->trace(); // "storage.cpp:42 in load: short read"
+ * @endcode
+ */
+struct location
+{
+    /**
+     * @brief Get the location of the caller.  As a default argument,
+     * this is the location of the call that uses the default.
+     */
+#if defined(JACK_DETAIL_HAS_BUILTIN_LOCATION)
+    static constexpr location current(const char* file = __builtin_FILE(),
+            const char* function = __builtin_FUNCTION(),
+            unsigned line = __builtin_LINE()) noexcept
+    {
+        return location{file, function, line};
+    }
+#elif defined(JACK_DETAIL_HAS_SOURCE_LOCATION)
+    static constexpr location current(const std::source_location& where =
+            std::source_location::current()) noexcept
+    {
+        return location{where.file_name(), where.function_name(),
+                static_cast<unsigned>(where.line())};
+    }
+#else
+    static constexpr location current() noexcept
+    {
+        return location{"unknown", "unknown", 0};
+    }
+#endif
+
+    /// @brief Null-terminated name of the source file.
+    const char* file;
+
+    /// @brief Null-terminated name of the function.
+    const char* function;
+
+    /// @brief Line number within the file.
+    unsigned line;
+};
+
+/**
+ * @brief One wrap or extend of a reason, as visited by
+ * basic_reason::for_each_context without rendering the description.
+ */
+struct context
+{
+    /// @brief First character of the context; not null-terminated.
+    /// Null for a located context.
+    const char* data;
+
+    /// @brief Number of characters in the context.
+    std::size_t size;
+
+    /// @brief Location the context refers to; its file & function are
+    /// null unless the context is located.
+    location where;
+
+    /// @brief Whether the context was a wrap (prepended) rather than an
+    /// extend (appended).
+    bool wrap;
+
+    /// @brief Whether the context was added with a code (see
+    /// basic_reason::wrap_as).
+    bool coded;
+
+    /// @brief Code the context was added with; 0 unless coded.
+    int code;
+};
+
+/**
+ * @brief Customization point for writing a user type into a reason
+ * without operator<<.  Specialize it for a class or enum with two
+ * static member functions:
+ * 
+ *     static std::size_t size(const t& value);
+ *     static char* write(const t& value, char* out);
+ * 
+ * size gives the exact number of characters, and write writes that
+ * many to out and returns the end.  The characters go straight into
+ * the reason's buffer, so nothing is streamed or copied twice.  Types
+ * without a specialization are written with operator<<.  Neither
+ * function should throw when the type is written to an inplace_reason,
+ * whose operations are noexcept.
+ * 
+ * @tparam t type of the argument
+ */
+template <typename t, typename = void>
+struct formatter
+{
+};
+
+namespace detail
+{
+
+/**
+ * @brief Write a value with operator<< into a new string.
+ * 
+ * @param put function that streams value into its first argument
+ * @param value value to write
+ * @return characters written
+ */
+#ifdef JACK_ERROR_COMPILED
+std::string stream_str(void (*put)(std::ostream&, const void*), const void* value);
+#else
+inline std::string stream_str(void (*put)(std::ostream&, const void*),
+        const void* value)
+{
+    std::ostringstream ss;
+    put(ss, value);
+    return ss.str();
+}
+#endif
+
+/**
+ * @brief The characters for one argument of an arbitrary series of
+ * parameters.  Every piece is built before anything is copied so that
+ * the output can be sized up front and written with a single
+ * allocation.  write(out, limit) writes at most limit characters, for
+ * output that has to fit a fixed buffer.  This primary template is the
+ * fallback for types that can only be written with operator<<; it
+ * streams the value into a temporary std::string.
+ * 
+ * @tparam t decayed type of the argument
+ */
+template <typename t, typename = void>
+class piece
+{
+  public:
+
+    /// @brief Building the piece uses the heap.
+    static constexpr bool allocates = true;
+
+    explicit piece(const t& value) : str_(stream_str(
+            [](std::ostream& os, const void* v) { os << *static_cast<const t*>(v); },
+            &value))
+    {
+    }
+
+    std::size_t size() const
+    {
+        return str_.size();
+    }
+
+    char* write(char* out) const
+    {
+        std::memcpy(out, str_.data(), str_.size());
+        return out + str_.size();
+    }
+
+    char* write(char* out, std::size_t limit) const
+    {
+        const std::size_t size = std::min(limit, str_.size());
+        std::memcpy(out, str_.data(), size);
+        return out + size;
+    }
+
+  private:
+
+    std::string str_;
+};
+
+/**
+ * @brief A piece that refers to characters owned by the argument.
+ */
+class view_piece
+{
+  public:
+
+    view_piece(const char* data, std::size_t size) :
+            data_(data), size_(size)
+    {
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    char* write(char* out) const
+    {
+        std::memcpy(out, data_, size_);
+        return out + size_;
+    }
+
+    char* write(char* out, std::size_t limit) const
+    {
+        const std::size_t size = std::min(limit, size_);
+        std::memcpy(out, data_, size);
+        return out + size;
+    }
+
+  private:
+
+    const char* data_;
+    std::size_t size_;
+};
+
+/**
+ * @brief A piece holding characters converted into inline storage.
+ * 
+ * @tparam capacity largest number of characters the piece can hold
+ */
+template <std::size_t capacity>
+class buffer_piece
+{
+  public:
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    char* write(char* out) const
+    {
+        std::memcpy(out, buf_, size_);
+        return out + size_;
+    }
+
+    char* write(char* out, std::size_t limit) const
+    {
+        const std::size_t size = std::min(limit, size_);
+        std::memcpy(out, buf_, size);
+        return out + size;
+    }
+
+  protected:
+
+    char buf_[capacity];
+    std::size_t size_ = 0;
+};
+
+template <>
+class piece<const char*> : public view_piece
+{
+  public:
+
+    explicit piece(const char* value) : view_piece(value,
+            value ? std::char_traits<char>::length(value) : 0)
+    {
+    }
+};
+
+template <>
+class piece<literal> : public view_piece
+{
+  public:
+
+    explicit piece(literal value) : view_piece(value.data, value.size)
+    {
+    }
+};
+
+template <>
+class piece<char*> : public piece<const char*>
+{
+  public:
+
+    using piece<const char*>::piece;
+};
+
+template <typename traits_t, typename alloc_t>
+class piece<std::basic_string<char, traits_t, alloc_t>> : public view_piece
+{
+  public:
+
+    explicit piece(const std::basic_string<char, traits_t, alloc_t>& value) :
+            view_piece(value.data(), value.size())
+    {
+    }
+};
+
+#ifdef JACK_DETAIL_CPP17
+template <typename traits_t>
+class piece<std::basic_string_view<char, traits_t>> : public view_piece
+{
+  public:
+
+    explicit piece(std::basic_string_view<char, traits_t> value) :
+            view_piece(value.data(), value.size())
+    {
+    }
+};
+#endif
+
+/**
+ * @brief Character types are written as a single character, as they
+ * are by operator<<.
+ */
+template <typename t>
+class piece<t, typename std::enable_if<
+        std::is_same<t, char>::value ||
+        std::is_same<t, signed char>::value ||
+        std::is_same<t, unsigned char>::value>::type> : public buffer_piece<1>
+{
+  public:
+
+    explicit piece(t value)
+    {
+        buf_[0] = static_cast<char>(value);
+        size_ = 1;
+    }
+};
+
+/**
+ * @brief Booleans are written as 1 or 0, as they are by operator<<.
+ */
+template <>
+class piece<bool> : public buffer_piece<1>
+{
+  public:
+
+    explicit piece(bool value)
+    {
+        buf_[0] = value ? '1' : '0';
+        size_ = 1;
+    }
+};
+
+/**
+ * @brief Whether a type is written by detail::int_piece.  Character
+ * types are excluded; they are written as characters or left to
+ * operator<<.
+ */
+template <typename t>
+struct is_int_arg : std::integral_constant<bool,
+        std::is_integral<t>::value &&
+        !std::is_same<t, bool>::value &&
+        !std::is_same<t, char>::value &&
+        !std::is_same<t, signed char>::value &&
+        !std::is_same<t, unsigned char>::value &&
+        !std::is_same<t, wchar_t>::value &&
+        !std::is_same<t, char16_t>::value &&
+        !std::is_same<t, char32_t>::value>
+{
+};
+
+/**
+ * @brief Integers are converted in decimal with std::to_chars when
+ * available.
+ */
+template <typename t>
+class piece<t, typename std::enable_if<is_int_arg<t>::value>::type> :
+        public buffer_piece<std::numeric_limits<t>::digits10 + 2>
+{
+  public:
+
+    explicit piece(t value)
+    {
+#ifdef JACK_DETAIL_HAS_CHARCONV
+        this->size_ = static_cast<std::size_t>(std::to_chars(this->buf_,
+                this->buf_ + sizeof(this->buf_), value).ptr - this->buf_);
+#else
+        // write digits backwards from the end then shift them down
+        using unsigned_t = typename std::make_unsigned<t>::type;
+        char* const end = this->buf_ + sizeof(this->buf_);
+        char* pos = end;
+        unsigned_t mag = value < 0 ? unsigned_t(0) - static_cast<unsigned_t>(value) :
+                static_cast<unsigned_t>(value);
+        do
+        {
+            *--pos = static_cast<char>('0' + mag % 10);
+            mag /= 10;
+        } while (mag);
+        if (value < 0)
+        {
+            *--pos = '-';
+        }
+        this->size_ = static_cast<std::size_t>(end - pos);
+        std::memmove(this->buf_, pos, this->size_);
+#endif
+    }
+};
+
+/// @brief Room for the digits of any line number.
+constexpr std::size_t line_digits = std::numeric_limits<unsigned>::digits10 + 1;
+
+/**
+ * @brief Write a line number at the end of a buffer.
+ * 
+ * @param line line number
+ * @param out buffer of line_digits characters
+ * @return number of digits, which end at out + line_digits
+ */
+inline std::size_t format_line(unsigned line, char* out) noexcept
+{
+    char* const end = out + line_digits;
+    char* pos = end;
+    do
+    {
+        *--pos = static_cast<char>('0' + line % 10);
+        line /= 10;
+    } while (line);
+    return static_cast<std::size_t>(end - pos);
+}
+
+/**
+ * @brief Characters of a source location, as "file:line in function".
+ */
+template <>
+class piece<location>
+{
+  public:
+
+    explicit piece(const location& where) : where_(where),
+            file_(std::char_traits<char>::length(where.file)),
+            function_(std::char_traits<char>::length(where.function)),
+            line_(format_line(where.line, digits_))
+    {
+    }
+
+    std::size_t size() const
+    {
+        return file_ + 1 + line_ + 4 + function_;
+    }
+
+    char* write(char* out) const
+    {
+        std::memcpy(out, where_.file, file_);
+        out += file_;
+        *out++ = ':';
+        std::memcpy(out, digits_ + line_digits - line_, line_);
+        out += line_;
+        std::memcpy(out, " in ", 4);
+        out += 4;
+        std::memcpy(out, where_.function, function_);
+        return out + function_;
+    }
+
+    char* write(char* out, std::size_t limit) const
+    {
+        if (limit >= size())
+        {
+            return write(out);
+        }
+        char* const end = out + limit;
+        const auto put = [&out, end](const char* data, std::size_t size) {
+            size = std::min(size, static_cast<std::size_t>(end - out));
+            std::memcpy(out, data, size);
+            out += size;
+        };
+        put(where_.file, file_);
+        put(":", 1);
+        put(digits_ + line_digits - line_, line_);
+        put(" in ", 4);
+        put(where_.function, function_);
+        return out;
+    }
+
+  private:
+
+    location where_;
+    std::size_t file_;
+    std::size_t function_;
+    std::size_t line_;
+    char digits_[line_digits];
+};
+
+/**
+ * @brief Floating point values are converted like operator<< with the
+ * default stream precision (%g with 6 significant digits).
+ */
+template <typename t>
+class piece<t, typename std::enable_if<
+        std::is_floating_point<t>::value>::type> : public buffer_piece<32>
+{
+  public:
+
+    explicit piece(t value)
+    {
+#ifdef __cpp_lib_to_chars
+        this->size_ = static_cast<std::size_t>(std::to_chars(this->buf_,
+                this->buf_ + sizeof(this->buf_), value,
+                std::chars_format::general, 6).ptr - this->buf_);
+#else
+        const int n = std::snprintf(this->buf_, sizeof(this->buf_), "%.6Lg",
+                static_cast<long double>(value));
+        this->size_ = n < 0 ? 0 : static_cast<std::size_t>(n);
+#endif
+    }
+};
+
+/**
+ * @brief Whether jack::formatter is specialized for a class or enum.
+ */
+template <typename t, typename = void>
+struct has_formatter : std::false_type
+{
+};
+
+template <typename t>
+struct has_formatter<t, typename std::enable_if<
+        (std::is_class<t>::value || std::is_enum<t>::value) &&
+        std::is_convertible<decltype(formatter<t>::size(std::declval<const t&>())),
+                std::size_t>::value &&
+        std::is_same<decltype(formatter<t>::write(std::declval<const t&>(),
+                std::declval<char*>())), char*>::value>::type> : std::true_type
+{
+};
+
+/**
+ * @brief Types with a jack::formatter are sized up front & written
+ * straight into the output.  Output cut to a limit is written through
+ * a small buffer first; a longer value that doesn't fit is left out.
+ */
+template <typename t>
+class piece<t, typename std::enable_if<has_formatter<t>::value>::type>
+{
+  public:
+
+    explicit piece(const t& value) :
+            value_(value), size_(formatter<t>::size(value))
+    {
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    char* write(char* out) const
+    {
+        return formatter<t>::write(value_, out);
+    }
+
+    char* write(char* out, std::size_t limit) const
+    {
+        if (size_ <= limit)
+        {
+            return write(out);
+        }
+        char buf[cut_capacity];
+        if (size_ > sizeof(buf))
+        {
+            return out;
+        }
+        formatter<t>::write(value_, buf);
+        std::memcpy(out, buf, limit);
+        return out + limit;
+    }
+
+  private:
+
+    /// @brief Longest value that can be cut to a limit.
+    static constexpr std::size_t cut_capacity = 256;
+
+    const t& value_;
+    std::size_t size_;
+};
+
+/**
+ * @brief Whether any of the given boolean traits is true.
+ */
+template <typename... traits>
+struct any_of : std::false_type
+{
+};
+
+template <typename first, typename... rest>
+struct any_of<first, rest...> : std::integral_constant<bool,
+        first::value || any_of<rest...>::value>
+{
+};
+
+/**
+ * @brief Whether building a piece may use the heap.
+ */
+template <typename piece_t, typename = void>
+struct piece_allocates : std::false_type
+{
+};
+
+template <typename piece_t>
+struct piece_allocates<piece_t, typename std::enable_if<
+        piece_t::allocates>::type> : std::true_type
+{
+};
+
+/**
+ * @brief Whether the first of the given types is std::allocator_arg_t.
+ */
+template <typename... ts>
+struct is_allocator_arg : std::false_type
+{
+};
+
+template <typename first, typename... rest>
+struct is_allocator_arg<first, rest...> : std::is_same<
+        typename std::decay<first>::type, std::allocator_arg_t>
+{
+};
+
+/**
+ * @brief Whether the first of the given types is jack::deferred_t.
+ */
+template <typename... ts>
+struct is_deferred_arg : std::false_type
+{
+};
+
+template <typename first, typename... rest>
+struct is_deferred_arg<first, rest...> : std::is_same<
+        typename std::decay<first>::type, deferred_t>
+{
+};
+
+/**
+ * @brief Sum the sizes of the given pieces, append them to a string
+ * with at most one allocation, and copy each piece into place.
+ * 
+ * @param out string to append to
+ * @param pieces pieces to append
+ */
+template <typename string_t, typename... piece_ts>
+inline void append_pieces(string_t& out, const piece_ts&... pieces)
+{
+    using expand = int[];
+    const std::size_t offset = out.size();
+    std::size_t size = offset;
+    (void)expand{0, (size += pieces.size(), 0)...};
+    out.resize(size);
+    char* pos = &out[0] + offset;
+    (void)expand{0, (pos = pieces.write(pos), 0)...};
+}
+
+/**
+ * @brief Append an arbitrary series of parameters to a string.
+ * 
+ * @param out string to append to
+ * @param args values to append
+ */
+template <typename string_t, typename... str_ts>
+inline void append_str(string_t& out, const str_ts&... args)
+{
+    append_pieces(out, piece<typename std::decay<str_ts>::type>(args)...);
+}
+
+#ifdef JACK_DETAIL_CPP17
+
+/**
+ * @brief Base of the types created by JACK_FMT.  Each derived type
+ * carries its format string in a constexpr static member function,
+ * value(), so the string can be checked while compiling.
+ */
+struct fmt_base
+{
+};
+
+template <typename t>
+using is_fmt = std::is_base_of<fmt_base, t>;
+
+/**
+ * @brief Whether a type is accepted by a {:s} placeholder.
+ */
+template <typename t>
+struct is_string_arg : std::integral_constant<bool,
+        std::is_same<t, const char*>::value ||
+        std::is_same<t, char*>::value ||
+        std::is_same<t, std::string_view>::value ||
+        std::is_same<t, literal>::value>
+{
+};
+
+template <typename alloc_t, std::size_t n>
+struct is_string_arg<basic_reason<alloc_t, n>> : std::true_type
+{
+};
+
+template <typename traits_t, typename alloc_t>
+struct is_string_arg<std::basic_string<char, traits_t, alloc_t>> :
+        std::true_type
+{
+};
+
+/**
+ * @brief Whether a decayed argument type is accepted by a placeholder
+ * with the given presentation type (0 for {}).
+ */
+template <typename t>
+constexpr bool fmt_accepts(char spec)
+{
+    switch (spec)
+    {
+      case '\0':
+        return true;
+      case 's':
+        return is_string_arg<t>::value;
+      case 'd': case 'x': case 'X': case 'c':
+        return std::is_integral<t>::value && !std::is_same<t, bool>::value;
+      case 'e': case 'f': case 'g':
+        return std::is_floating_point<t>::value;
+      default:
+        return false;
+    }
+}
+
+enum class fmt_status
+{
+    ok,
+    unmatched_open,
+    unmatched_close,
+    bad_spec
+};
+
+/**
+ * @brief Result of scanning a format string: its validity, number of
+ * placeholders, and number of literal characters once escapes ({{ and
+ * }}) are collapsed.
+ */
+struct fmt_summary
+{
+    fmt_status status;
+    std::size_t args;
+    std::size_t chars;
+};
+
+/**
+ * @brief Scan a format string.  Placeholders are {} or {:t} where t is
+ * one of s, d, x, X, c, e, f or g.
+ * 
+ * @param str format string
+ * @return summary of str
+ */
+constexpr fmt_summary fmt_scan(std::string_view str)
+{
+    fmt_summary sum{fmt_status::ok, 0, 0};
+    for (std::size_t i = 0; i < str.size(); ++i)
+    {
+        const bool doubled = i + 1 < str.size() && str[i + 1] == str[i];
+        if (str[i] == '{' && !doubled)
+        {
+            std::size_t end = i + 1;
+            if (end < str.size() && str[end] == ':')
+            {
+                ++end;
+                if (end < str.size() && str[end] != '}')
+                {
+                    if (!fmt_accepts<int>(str[end]) &&
+                            !fmt_accepts<double>(str[end]) &&
+                            !fmt_accepts<const char*>(str[end]))
+                    {
+                        return {fmt_status::bad_spec, sum.args, sum.chars};
+                    }
+                    ++end;
+                }
+            }
+            if (end >= str.size())
+            {
+                return {fmt_status::unmatched_open, sum.args, sum.chars};
+            }
+            if (str[end] != '}')
+            {
+                return {fmt_status::bad_spec, sum.args, sum.chars};
+            }
+            ++sum.args;
+            i = end;
+        }
+        else if (str[i] == '}' && !doubled)
+        {
+            return {fmt_status::unmatched_close, sum.args, sum.chars};
+        }
+        else
+        {
+            i += doubled && (str[i] == '{' || str[i] == '}');
+            ++sum.chars;
+        }
+    }
+    return sum;
+}
+
+/**
+ * @brief A format string split into literal runs and placeholders.
+ * Run i is text[run_end[i - 1], run_end[i]) and is followed by
+ * placeholder i, except for the last run.
+ * 
+ * @tparam args number of placeholders
+ * @tparam chars number of literal characters
+ */
+template <std::size_t args, std::size_t chars>
+struct fmt_layout
+{
+    char text[chars + 1];
+    std::size_t run_end[args + 1];
+    char spec[args + 1];
+};
+
+/**
+ * @brief Split a valid format string into its layout.
+ * 
+ * @param str format string
+ * @return layout of str
+ */
+template <std::size_t args, std::size_t chars>
+constexpr fmt_layout<args, chars> fmt_compile(std::string_view str)
+{
+    const auto at = [str](std::size_t i) {
+        return i < str.size() ? str[i] : '\0';
+    };
+
+    fmt_layout<args, chars> layout{};
+    std::size_t arg = 0;
+    std::size_t len = 0;
+    for (std::size_t i = 0; i < str.size() && len < chars + 1; ++i)
+    {
+        const bool doubled = at(i + 1) == str[i];
+        if (str[i] == '{' && !doubled && arg < args)
+        {
+            const bool typed = at(i + 1) == ':' && at(i + 2) != '}';
+            layout.run_end[arg] = len;
+            layout.spec[arg] = typed ? at(i + 2) : '\0';
+            i += at(i + 1) == ':' ? 2 + typed : 1;
+            ++arg;
+        }
+        else
+        {
+            i += doubled && (str[i] == '{' || str[i] == '}');
+            layout.text[len++] = str[i];
+        }
+    }
+    layout.run_end[args] = chars;
+    return layout;
+}
+
+/**
+ * @brief Everything known at compile time about a JACK_FMT string.
+ */
+template <typename fmt_t>
+struct fmt_info
+{
+    static constexpr std::string_view str = fmt_t::value();
+    static constexpr fmt_summary summary = fmt_scan(str);
+    static constexpr auto layout =
+            fmt_compile<summary.args, summary.chars>(str);
+};
+
+/**
+ * @brief An integer written in hexadecimal.
+ */
+template <typename t, bool upper>
+class hex_piece : public buffer_piece<sizeof(t) * 2 + 1>
+{
+  public:
+
+    explicit hex_piece(t value)
+    {
+        using unsigned_t = typename std::make_unsigned<t>::type;
+        const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+        char* const end = this->buf_ + sizeof(this->buf_);
+        char* pos = end;
+        unsigned_t mag = value < 0 ? unsigned_t(0) - static_cast<unsigned_t>(value) :
+                static_cast<unsigned_t>(value);
+        do
+        {
+            *--pos = digits[mag & 0xf];
+            mag >>= 4;
+        } while (mag);
+        if (value < 0)
+        {
+            *--pos = '-';
+        }
+        this->size_ = static_cast<std::size_t>(end - pos);
+        std::memmove(this->buf_, pos, this->size_);
+    }
+};
+
+/**
+ * @brief A floating point value written in fixed (%f) or scientific
+ * (%e) notation with 6 digits after the decimal point.
+ */
+template <typename t, bool fixed>
+class float_piece : public buffer_piece<
+        std::numeric_limits<t>::max_exponent10 + 16>
+{
+  public:
+
+    explicit float_piece(t value)
+    {
+#ifdef __cpp_lib_to_chars
+        this->size_ = static_cast<std::size_t>(std::to_chars(this->buf_,
+                this->buf_ + sizeof(this->buf_), value, fixed ?
+                        std::chars_format::fixed : std::chars_format::scientific,
+                6).ptr - this->buf_);
+#else
+        const int n = std::snprintf(this->buf_, sizeof(this->buf_),
+                fixed ? "%.6Lf" : "%.6Le", static_cast<long double>(value));
+        this->size_ = n < 0 ? 0 : static_cast<std::size_t>(n);
+#endif
+    }
+};
+
+/**
+ * @brief The piece for an argument of a placeholder with the given
+ * presentation type.  {}, {:s} and {:g} write like operator<<.
+ */
+template <typename t, char spec, typename = void>
+class fmt_piece : public piece<t>
+{
+  public:
+
+    using piece<t>::piece;
+};
+
+template <typename t>
+class fmt_piece<t, 'd', typename std::enable_if<!is_int_arg<t>::value>::type> :
+        public piece<long long>
+{
+  public:
+
+    explicit fmt_piece(t value) : piece<long long>(static_cast<long long>(value))
+    {
+    }
+};
+
+template <typename t>
+class fmt_piece<t, 'c'> : public piece<char>
+{
+  public:
+
+    explicit fmt_piece(t value) : piece<char>(static_cast<char>(value))
+    {
+    }
+};
+
+template <typename t>
+class fmt_piece<t, 'x'> : public hex_piece<t, false>
+{
+  public:
+
+    using hex_piece<t, false>::hex_piece;
+};
+
+template <typename t>
+class fmt_piece<t, 'X'> : public hex_piece<t, true>
+{
+  public:
+
+    using hex_piece<t, true>::hex_piece;
+};
+
+template <typename t>
+class fmt_piece<t, 'f'> : public float_piece<t, true>
+{
+  public:
+
+    using float_piece<t, true>::float_piece;
+};
+
+template <typename t>
+class fmt_piece<t, 'e'> : public float_piece<t, false>
+{
+  public:
+
+    using float_piece<t, false>::float_piece;
+};
+
+/**
+ * @brief Whether every argument is accepted by its placeholder.
+ */
+template <typename info, typename... str_ts, std::size_t... i>
+constexpr bool fmt_check(std::index_sequence<i...>)
+{
+    return (fmt_accepts<typename std::decay<str_ts>::type>(
+            info::layout.spec[i]) && ... && true);
+}
+
+/**
+ * @brief Append the literal runs of a format string interleaved with
+ * the given pieces.  The literal length is a compile-time constant, so
+ * the output is sized and allocated exactly once.
+ */
+template <typename info, typename string_t, std::size_t... i,
+        typename... piece_ts>
+inline void append_layout(string_t& out, std::index_sequence<i...>,
+        const piece_ts&... pieces)
+{
+    constexpr auto& layout = info::layout;
+    const std::size_t offset = out.size();
+    out.resize(offset + (info::summary.chars + ... + pieces.size()));
+    char* pos = &out[0] + offset;
+    std::size_t run = 0;
+    ((std::memcpy(pos, layout.text + run, layout.run_end[i] - run),
+            pos += layout.run_end[i] - run,
+            run = layout.run_end[i],
+            pos = pieces.write(pos)), ...);
+    std::memcpy(pos, layout.text + run, info::summary.chars - run);
+}
+
+template <typename info, typename string_t, std::size_t... i,
+        typename... str_ts>
+inline void append_fmt(string_t& out, std::index_sequence<i...> seq,
+        const str_ts&... args)
+{
+    append_layout<info>(out, seq, fmt_piece<typename std::decay<str_ts>::type,
+            info::layout.spec[i]>(args)...);
+}
+
+/**
+ * @brief Append arguments to a string according to a JACK_FMT format
+ * string.  The format string is validated against the arguments while
+ * compiling.
+ * 
+ * @param out string to append to
+ * @param args values to substitute for the placeholders
+ */
+template <typename string_t, typename fmt_t, typename... str_ts>
+inline typename std::enable_if<is_fmt<fmt_t>::value>::type
+append_str(string_t& out, const fmt_t&, const str_ts&... args)
+{
+    using info = fmt_info<fmt_t>;
+    static_assert(info::summary.status != fmt_status::unmatched_open,
+            "jack format string: '{' without a matching '}' (use {{ for a literal '{')");
+    static_assert(info::summary.status != fmt_status::unmatched_close,
+            "jack format string: '}' without a matching '{' (use }} for a literal '}')");
+    static_assert(info::summary.status != fmt_status::bad_spec,
+            "jack format string: placeholders must be {} or {:t} with t one of s, d, x, X, c, e, f, g");
+    static_assert(info::summary.status != fmt_status::ok ||
+            info::summary.args == sizeof...(str_ts),
+            "jack format string: number of placeholders does not match number of arguments");
+    if constexpr (info::summary.status == fmt_status::ok &&
+            info::summary.args == sizeof...(str_ts))
+    {
+        static_assert(fmt_check<info, str_ts...>(
+                std::index_sequence_for<str_ts...>()),
+                "jack format string: argument type does not match its placeholder's type");
+        append_fmt<info>(out, std::index_sequence_for<str_ts...>(), args...);
+    }
+}
+
+#endif // #ifdef JACK_DETAIL_CPP17
+
+// prevent collisions with other jack defs
+#ifndef JACK_DETAIL_VARIADIC_MAKE_STR
+#define JACK_DETAIL_VARIADIC_MAKE_STR
+
+/**
+ * @brief Construct a string from an arbitrary series of parameters.
+ * Strings are copied directly, arithmetic values are converted
+ * in place, and anything else is written with operator<<.
+ * 
+ * @return std::string constructed from given args
+ */
+template <typename... str_ts>
+inline std::string make_str(str_ts&&... args)
+{
+    std::string out;
+    append_str(out, args...);
+    return out;
+}
+
+/**
+ * @brief No-argument overload of detail::make_str that avoids
+ * useless calls when returning an empty std::string.
+ * 
+ * @return empty std::string
+ */
+inline std::string make_str()
+{
+    return {};
+}
+
+#endif // #ifndef
+
+/**
+ * @brief A compile-time list of indices, for expanding a tuple.
+ */
+template <std::size_t... i>
+struct indices
+{
+};
+
+template <std::size_t n, std::size_t... i>
+struct make_indices : make_indices<n - 1, n - 1, i...>
+{
+};
+
+template <std::size_t... i>
+struct make_indices<0, i...>
+{
+    using type = indices<i...>;
+};
+
+/**
+ * @brief A string argument of a deferred reason, copied into the
+ * reason's pool.  It is recorded by position so a pool can be copied
+ * with memcpy.
+ */
+struct pooled_str
+{
+    std::size_t offset;
+    std::size_t size;
+};
+
+/**
+ * @brief How a deferred reason holds one argument until it is
+ * formatted.  This primary template stores a copy of the value.
+ *
+ * @tparam t decayed type of the argument
+ */
+template <typename t, typename = void>
+struct capture
+{
+    using type = t;
+
+    static std::size_t pool_size(const t&)
+    {
+        return 0;
+    }
+
+    static const t& make(const t& value, char*, char*&)
+    {
+        return value;
+    }
+
+    static const t& view(const t& value, const char*)
+    {
+        return value;
+    }
+};
+
+/**
+ * @brief Arguments that refer to characters they don't own are copied
+ * into the pool, null-terminated.
+ */
+template <typename t>
+struct capture_str
+{
+    using type = pooled_str;
+
+    static std::size_t pool_size(const t& value)
+    {
+        return piece<t>(value).size() + 1;
+    }
+
+    static pooled_str make(const t& value, char* pool, char*& pos)
+    {
+        const piece<t> p(value);
+        const pooled_str str{static_cast<std::size_t>(pos - pool), p.size()};
+        pos = p.write(pos);
+        *pos++ = '\0';
+        return str;
+    }
+
+    static literal view(pooled_str str, const char* pool)
+    {
+        return literal(pool + str.offset, str.size);
+    }
+};
+
+template <>
+struct capture<const char*> : capture_str<const char*>
+{
+};
+
+template <>
+struct capture<char*> : capture_str<char*>
+{
+};
+
+template <typename traits_t, typename alloc_t>
+struct capture<std::basic_string<char, traits_t, alloc_t>> :
+        capture_str<std::basic_string<char, traits_t, alloc_t>>
+{
+};
+
+#ifdef JACK_DETAIL_CPP17
+template <typename traits_t>
+struct capture<std::basic_string_view<char, traits_t>> :
+        capture_str<std::basic_string_view<char, traits_t>>
+{
+};
+#endif
+
+template <typename alloc_t, std::size_t n>
+struct capture<basic_reason<alloc_t, n>> : capture_str<basic_reason<alloc_t, n>>
+{
+};
+
+/**
+ * @brief The captured arguments of a deferred reason.  They are
+ * formatted the first time str is called and the result is kept for
+ * every later call.
+ *
+ * @tparam alloc_t allocator of the owning reason
+ */
+template <typename alloc_t>
+class deferred_args
+{
+  public:
+
+    using string_type = std::basic_string<char, std::char_traits<char>, alloc_t>;
+
+    deferred_args(const deferred_args&) = delete;
+    deferred_args& operator=(const deferred_args&) = delete;
+
+    /**
+     * @brief Get the formatted arguments, formatting them on the first
+     * call.
+     *
+     * @return formatted arguments
+     */
+    const string_type& str()
+    {
+        if (!done_)
+        {
+            format(str_);
+            done_ = true;
+        }
+        return str_;
+    }
+
+    /**
+     * @brief Copy the arguments (& their formatted string, if any).
+     *
+     * @param alloc allocator for the copy
+     * @return new arguments; release with release
+     */
+    virtual deferred_args* clone(const alloc_t& alloc) const = 0;
+
+    /**
+     * @brief Share these arguments with a copy of the owning reason.
+     * Only formatted arguments are shared, as they are never written
+     * again; others are cloned.
+     *
+     * @param alloc allocator of the copy
+     * @return arguments for the copy; release with release
+     */
+    deferred_args* share(const alloc_t& alloc)
+    {
+        if (done_ && alloc == str_.get_allocator())
+        {
+            refs_.fetch_add(1, std::memory_order_relaxed);
+            return this;
+        }
+        return clone(alloc);
+    }
+
+    /**
+     * @brief Drop one owner's reference, destroying the arguments after
+     * the last.
+     */
+    void release() noexcept
+    {
+        // the last owner can't race with a share, so skips the atomic write
+        if (refs_.load(std::memory_order_acquire) == 1 ||
+                refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            destroy();
+        }
+    }
+
+    /**
+     * @brief Destroy these arguments & release their storage.
+     */
+    virtual void destroy() noexcept = 0;
+
+  protected:
+
+    explicit deferred_args(const alloc_t& alloc) : str_(alloc)
+    {
+    }
+
+    ~deferred_args() = default;
+
+    /**
+     * @brief Take the formatted string of other, if it has one.
+     *
+     * @param other arguments being cloned
+     */
+    void copy_str(const deferred_args& other)
+    {
+        if (other.done_)
+        {
+            str_ = other.str_;
+            done_ = true;
+        }
+    }
+
+    virtual void format(string_type& out) const = 0;
+
+  private:
+
+    string_type str_;
+    std::atomic<std::size_t> refs_{1};
+    bool done_ = false;
+};
+
+/**
+ * @brief Deferred arguments of specific types.  The node & a pool
+ * holding every copied string share a single allocation from alloc_t.
+ *
+ * @tparam alloc_t allocator of the owning reason
+ * @tparam arg_ts decayed types of the arguments
+ */
+template <typename alloc_t, typename... arg_ts>
+class deferred_node final : public deferred_args<alloc_t>
+{
+  public:
+
+    using typename deferred_args<alloc_t>::string_type;
+
+    /**
+     * @brief Capture a series of arguments.
+     *
+     * @param alloc allocator for the node
+     * @param args values to capture
+     * @return new node; release with destroy
+     */
+    template <typename... str_ts>
+    static deferred_node* create(const alloc_t& alloc, const str_ts&... args)
+    {
+        using expand = int[];
+        std::size_t pool = 0;
+        (void)expand{0, (pool += capture<arg_ts>::pool_size(args), 0)...};
+        void* const mem = allocate(alloc, pool);
+        try
+        {
+            return ::new (mem) deferred_node(alloc, pool,
+                    static_cast<char*>(mem) + sizeof(deferred_node), args...);
+        }
+        catch (...)
+        {
+            deallocate(alloc, mem, pool);
+            throw;
+        }
+    }
+
+    deferred_args<alloc_t>* clone(const alloc_t& alloc) const override
+    {
+        void* const mem = allocate(alloc, pool_size_);
+        try
+        {
+            return ::new (mem) deferred_node(*this, alloc);
+        }
+        catch (...)
+        {
+            deallocate(alloc, mem, pool_size_);
+            throw;
+        }
+    }
+
+    void destroy() noexcept override
+    {
+        const alloc_t alloc(alloc_);
+        const std::size_t pool = pool_size_;
+        this->~deferred_node();
+        deallocate(alloc, this, pool);
+    }
+
+  protected:
+
+    void format(string_type& out) const override
+    {
+        format(out, typename make_indices<sizeof...(arg_ts)>::type());
+    }
+
+  private:
+
+    using block_t = std::max_align_t;
+    using block_alloc_t = typename std::allocator_traits<
+            alloc_t>::template rebind_alloc<block_t>;
+
+    static_assert(alignof(std::tuple<typename capture<arg_ts>::type...>) <=
+            alignof(block_t), "over-aligned arguments can't be deferred");
+
+    template <typename... str_ts>
+    deferred_node(const alloc_t& alloc, std::size_t pool_size, char* pos,
+            const str_ts&... args) :
+            deferred_args<alloc_t>(alloc), alloc_(alloc), pool_size_(pool_size),
+            args_{capture<arg_ts>::make(args, pool(), pos)...}
+    {
+    }
+
+    deferred_node(const deferred_node& other, const alloc_t& alloc) :
+            deferred_args<alloc_t>(alloc), alloc_(alloc),
+            pool_size_(other.pool_size_), args_(other.args_)
+    {
+        std::memcpy(pool(), other.pool(), pool_size_);
+        this->copy_str(other);
+    }
+
+    static std::size_t blocks(std::size_t pool)
+    {
+        return (sizeof(deferred_node) + pool + sizeof(block_t) - 1) /
+                sizeof(block_t);
+    }
+
+    static void* allocate(const alloc_t& alloc, std::size_t pool)
+    {
+        block_alloc_t blocks_alloc(alloc);
+        return std::allocator_traits<block_alloc_t>::allocate(
+                blocks_alloc, blocks(pool));
+    }
+
+    static void deallocate(const alloc_t& alloc, void* mem, std::size_t pool)
+    {
+        block_alloc_t blocks_alloc(alloc);
+        std::allocator_traits<block_alloc_t>::deallocate(blocks_alloc,
+                static_cast<block_t*>(mem), blocks(pool));
+    }
+
+    char* pool()
+    {
+        return reinterpret_cast<char*>(this) + sizeof(deferred_node);
+    }
+
+    const char* pool() const
+    {
+        return reinterpret_cast<const char*>(this) + sizeof(deferred_node);
+    }
+
+    template <std::size_t... i>
+    void format(string_type& out, indices<i...>) const
+    {
+        append_str(out, capture<arg_ts>::view(std::get<i>(args_), pool())...);
+    }
+
+    alloc_t alloc_;
+    std::size_t pool_size_;
+    std::tuple<typename capture<arg_ts>::type...> args_;
+};
+
+/**
+ * @brief Heap storage with a reference count in front, so that copies
+ * of an inline_vector or inline_string can share it.  A block is only
+ * written while its count is 1; an owner that wants to change a shared
+ * block copies it first.
+ *
+ * @tparam alloc_t allocator of the owner, rebound to the count
+ */
+template <typename alloc_t>
+class shared_block
+{
+  public:
+
+    /**
+     * @brief Allocate a block with room for size bytes, owned once.
+     *
+     * @return first byte after the count
+     */
+    static void* allocate(const alloc_t& alloc, std::size_t size)
+    {
+        header_alloc_t header_alloc(alloc);
+        header* const h = traits::allocate(header_alloc, units(size));
+        ::new (static_cast<void*>(h)) header();
+        h->refs.store(1, std::memory_order_relaxed);
+        return h + 1;
+    }
+
+    /// @brief Add an owner to the block holding data.
+    static void share(const void* data) noexcept
+    {
+        of(data)->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// @brief Whether any other owner holds the block holding data.
+    static bool shared(const void* data) noexcept
+    {
+        return of(data)->refs.load(std::memory_order_acquire) != 1;
+    }
+
+    /**
+     * @brief Drop one owner of the block holding data, freeing it after
+     * the last.
+     */
+    static void release(const alloc_t& alloc, const void* data,
+            std::size_t size) noexcept
+    {
+        header* const h = of(data);
+        // the last owner can't race with a share, so skips the atomic write
+        if (h->refs.load(std::memory_order_acquire) == 1 ||
+                h->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            h->~header();
+            header_alloc_t header_alloc(alloc);
+            traits::deallocate(header_alloc, h, units(size));
+        }
+    }
+
+    /// @brief Bytes allocated for a block with room for size bytes.
+    static std::size_t bytes(std::size_t size) noexcept
+    {
+        return units(size) * sizeof(header);
+    }
+
+  private:
+
+    struct header
+    {
+        std::atomic<std::size_t> refs;
+    };
+
+    using header_alloc_t = typename std::allocator_traits<alloc_t>::template
+            rebind_alloc<header>;
+    using traits = std::allocator_traits<header_alloc_t>;
+
+    static std::size_t units(std::size_t size) noexcept
+    {
+        return 1 + (size + sizeof(header) - 1) / sizeof(header);
+    }
+
+    static header* of(const void* data) noexcept
+    {
+        return static_cast<header*>(const_cast<void*>(data)) - 1;
+    }
+};
+
+/**
+ * @brief A vector of trivially copyable elements whose first n elements
+ * are stored inline, so small lists never allocate.  Copies made with
+ * share use the same heap storage until either one changes.
+ * 
+ * @tparam t element type
+ * @tparam n elements stored inline
+ * @tparam alloc_t allocator, rebound to t for larger sizes
+ */
+template <typename t, std::size_t n, typename alloc_t>
+class inline_vector : private std::allocator_traits<alloc_t>::template
+        rebind_alloc<t>
+{
+  public:
+
+    using t_alloc_t = typename std::allocator_traits<alloc_t>::template
+            rebind_alloc<t>;
+
+    explicit inline_vector(const alloc_t& alloc) : t_alloc_t(alloc)
+    {
+    }
+
+    inline_vector(const inline_vector& other, const alloc_t& alloc) :
+            t_alloc_t(alloc)
+    {
+        append(other.data_, other.size_);
+    }
+
+    inline_vector(inline_vector&& other) noexcept : t_alloc_t(other.alloc())
+    {
+        steal(other);
+    }
+
+    inline_vector(inline_vector&& other, const alloc_t& alloc) :
+            t_alloc_t(alloc)
+    {
+        if (this->alloc() == other.alloc())
+        {
+            steal(other);
+        }
+        else
+        {
+            append(other.data_, other.size_);
+        }
+    }
+
+    inline_vector& operator=(const inline_vector& other)
+    {
+        if (this != &other)
+        {
+            size_ = 0;
+            append(other.data_, other.size_);
+        }
+        return *this;
+    }
+
+    inline_vector& operator=(inline_vector&& other)
+    {
+        if (this != &other)
+        {
+            if (alloc() == other.alloc())
+            {
+                release();
+                steal(other);
+            }
+            else
+            {
+                size_ = 0;
+                append(other.data_, other.size_);
+            }
+        }
+        return *this;
+    }
+
+    ~inline_vector()
+    {
+        release();
+    }
+
+    t* begin() noexcept { return data_; }
+    t* end() noexcept { return data_ + size_; }
+    const t* begin() const noexcept { return data_; }
+    const t* end() const noexcept { return data_ + size_; }
+    t& operator[](std::size_t i) noexcept { return data_[i]; }
+    const t& operator[](std::size_t i) const noexcept { return data_[i]; }
+    const t& front() const noexcept { return data_[0]; }
+    t& back() noexcept { return data_[size_ - 1]; }
+    const t& back() const noexcept { return data_[size_ - 1]; }
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    void clear() noexcept { size_ = 0; }
+
+    void push_back(const t& value)
+    {
+        if (size_ == capacity_ || shared())
+        {
+            grow(size_ + 1);
+        }
+        data_[size_++] = value;
+    }
+
+    void append(const t* values, std::size_t count)
+    {
+        if (size_ + count > capacity_ || shared())
+        {
+            grow(size_ + count);
+        }
+        if (count != 0)
+        {
+            std::memcpy(data_ + size_, values, count * sizeof(t));
+        }
+        size_ += count;
+    }
+
+    void reserve(std::size_t count)
+    {
+        if (count > capacity_ || shared())
+        {
+            grow(count);
+        }
+    }
+
+    /// @brief Remove the elements in [first, last).
+    void erase(std::size_t first, std::size_t last)
+    {
+        if (shared())
+        {
+            grow(size_);
+        }
+        if (last != size_)
+        {
+            std::memmove(data_ + first, data_ + last, (size_ - last) * sizeof(t));
+        }
+        size_ -= last - first;
+    }
+
+    /**
+     * @brief Become a copy of other, sharing its heap storage when it
+     * has some & the allocators are equal.
+     */
+    void share(const inline_vector& other)
+    {
+        if (other.data_ == other.inline_)
+        {
+            release();
+            std::memcpy(inline_, other.inline_, other.size_ * sizeof(t));
+            size_ = other.size_;
+            return;
+        }
+        if (!(alloc() == other.alloc()))
+        {
+            size_ = 0;
+            append(other.data_, other.size_);
+            return;
+        }
+        block::share(other.data_);
+        release();
+        data_ = other.data_;
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+    }
+
+    /// @brief Bytes allocated outside the object.
+    std::size_t heap_bytes() const noexcept
+    {
+        return data_ == inline_ ? 0 : block::bytes(capacity_ * sizeof(t));
+    }
+
+  private:
+
+    using block = shared_block<t_alloc_t>;
+
+    static_assert(std::is_trivially_copyable<t>::value,
+            "inline_vector holds trivially copyable types");
+    static_assert(alignof(t) <= alignof(std::atomic<std::size_t>),
+            "inline_vector elements fit the alignment of a shared block");
+
+    t_alloc_t& alloc() noexcept
+    {
+        return *this;
+    }
+
+    const t_alloc_t& alloc() const noexcept
+    {
+        return *this;
+    }
+
+    bool shared() const noexcept
+    {
+        return data_ != inline_ && block::shared(data_);
+    }
+
+    /**
+     * @brief Move to a larger block, or to a block of our own when the
+     * current one is shared.
+     */
+    void grow(std::size_t min)
+    {
+        std::size_t capacity = capacity_;
+        if (capacity < min)
+        {
+            capacity = std::max(capacity * 2, min);
+        }
+        t* data = static_cast<t*>(block::allocate(alloc(), capacity * sizeof(t)));
+        if (size_ != 0)
+        {
+            std::memcpy(data, data_, size_ * sizeof(t));
+        }
+        release();
+        data_ = data;
+        capacity_ = capacity;
+    }
+
+    void release() noexcept
+    {
+        if (data_ != inline_)
+        {
+            block::release(alloc(), data_, capacity_ * sizeof(t));
+            data_ = inline_;
+            capacity_ = n;
+        }
+    }
+
+    void steal(inline_vector& other) noexcept
+    {
+        if (other.data_ == other.inline_)
+        {
+            std::memcpy(inline_, other.inline_, other.size_ * sizeof(t));
+        }
+        else
+        {
+            data_ = other.data_;
+            capacity_ = other.capacity_;
+            other.data_ = other.inline_;
+            other.capacity_ = n;
+        }
+        size_ = other.size_;
+        other.size_ = 0;
+    }
+
+    t* data_ = inline_;
+    std::size_t size_ = 0;
+    std::size_t capacity_ = n;
+    t inline_[n];
+};
+
+/**
+ * @brief A string whose first n characters are stored inline, so short
+ * strings never allocate.  It has just what basic_reason needs: appending
+ * in place, spare room past the end for the rendered description, and
+ * copies (made with share) that use the same heap storage until either
+ * one changes.
+ * 
+ * @tparam n characters stored inline, not counting the terminator
+ * @tparam alloc_t allocator for larger strings
+ */
+template <std::size_t n, typename alloc_t>
+class inline_string : private alloc_t
+{
+  public:
+
+    explicit inline_string(const alloc_t& alloc) noexcept(
+            std::is_nothrow_copy_constructible<alloc_t>::value) : alloc_t(alloc)
+    {
+        inline_[0] = '\0';
+    }
+
+    inline_string(const char* data, std::size_t size, const alloc_t& alloc) :
+            inline_string(alloc)
+    {
+        append(data, size);
+    }
+
+    inline_string(const inline_string& other) : inline_string(
+            std::allocator_traits<alloc_t>::select_on_container_copy_construction(
+                    other.get_allocator()))
+    {
+        append(other.data_, other.size_);
+    }
+
+    inline_string(const inline_string& other, const alloc_t& alloc) :
+            inline_string(alloc)
+    {
+        append(other.data_, other.size_);
+    }
+
+    inline_string(inline_string&& other) noexcept : alloc_t(other.get_allocator())
+    {
+        steal(other);
+    }
+
+    inline_string(inline_string&& other, const alloc_t& alloc) :
+            inline_string(alloc)
+    {
+        if (get_allocator() == other.get_allocator())
+        {
+            steal(other);
+        }
+        else
+        {
+            append(other.data_, other.size_);
+        }
+    }
+
+    inline_string& operator=(const inline_string& other)
+    {
+        if (this != &other)
+        {
+            size_ = 0;
+            append(other.data_, other.size_);
+        }
+        return *this;
+    }
+
+    inline_string& operator=(inline_string&& other)
+    {
+        if (this != &other)
+        {
+            if (get_allocator() == other.get_allocator())
+            {
+                release();
+                steal(other);
+            }
+            else
+            {
+                size_ = 0;
+                append(other.data_, other.size_);
+            }
+        }
+        return *this;
+    }
+
+    ~inline_string()
+    {
+        release();
+    }
+
+    alloc_t get_allocator() const noexcept
+    {
+        return *this;
+    }
+
+    char* data() noexcept { return data_; }
+    const char* data() const noexcept { return data_; }
+    const char* c_str() const noexcept { return data_; }
+    char& operator[](std::size_t i) noexcept { return data_[i]; }
+    std::size_t size() const noexcept { return size_; }
+
+    /**
+     * @brief Change the length.  New characters are left for the caller
+     * to write.
+     */
+    void resize(std::size_t size)
+    {
+        if (size > capacity_ || shared())
+        {
+            grow(size);
+        }
+        size_ = size;
+        data_[size_] = '\0';
+    }
+
+    void append(const char* data, std::size_t size)
+    {
+        if (size_ + size > capacity_ || shared())
+        {
+            grow(size_ + size);
+        }
+        if (size != 0)
+        {
+            std::memcpy(data_ + size_, data, size);
+        }
+        size_ += size;
+        data_[size_] = '\0';
+    }
+
+    /**
+     * @brief Get room for count characters just past the terminator.  It
+     * is overwritten by the next append or resize, and is shared by
+     * copies made with share.
+     */
+    char* spare(std::size_t count)
+    {
+        if (size_ + count > capacity_ || shared())
+        {
+            grow(size_ + count);
+        }
+        return data_ + size_ + 1;
+    }
+
+    /**
+     * @brief Become a copy of other, sharing its heap storage (including
+     * the spare room) when it has some & the allocators are equal.
+     */
+    void share(const inline_string& other)
+    {
+        if (other.data_ == other.inline_)
+        {
+            release();
+            std::memcpy(inline_, other.inline_, other.size_ + 1);
+            size_ = other.size_;
+            return;
+        }
+        if (!(get_allocator() == other.get_allocator()))
+        {
+            size_ = 0;
+            append(other.data_, other.size_);
+            return;
+        }
+        block::share(other.data_);
+        release();
+        data_ = other.data_;
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+    }
+
+    /// @brief Bytes allocated outside the object.
+    std::size_t heap_bytes() const noexcept
+    {
+        return data_ == inline_ ? 0 : block::bytes(capacity_ + 1);
+    }
+
+  private:
+
+    using block = shared_block<alloc_t>;
+
+    alloc_t& alloc() noexcept
+    {
+        return *this;
+    }
+
+    bool shared() const noexcept
+    {
+        return data_ != inline_ && block::shared(data_);
+    }
+
+    /**
+     * @brief Move to a larger block, or to a block of our own when the
+     * current one is shared.
+     */
+    void grow(std::size_t min)
+    {
+        std::size_t capacity = capacity_;
+        if (capacity < min)
+        {
+            capacity = std::max(capacity * 2, min);
+        }
+        char* data = static_cast<char*>(block::allocate(alloc(), capacity + 1));
+        std::memcpy(data, data_, size_ + 1);
+        release();
+        data_ = data;
+        capacity_ = capacity;
+    }
+
+    void release() noexcept
+    {
+        if (data_ != inline_)
+        {
+            block::release(alloc(), data_, capacity_ + 1);
+            data_ = inline_;
+            capacity_ = n;
+        }
+    }
+
+    void steal(inline_string& other) noexcept
+    {
+        if (other.data_ == other.inline_)
+        {
+            std::memcpy(inline_, other.inline_, other.size_ + 1);
+        }
+        else
+        {
+            data_ = other.data_;
+            capacity_ = other.capacity_;
+            other.data_ = other.inline_;
+            other.capacity_ = n;
+        }
+        size_ = other.size_;
+        other.size_ = 0;
+        other.inline_[0] = '\0';
+    }
+
+    char* data_ = inline_;
+    std::size_t size_ = 0;
+    std::size_t capacity_ = n;
+    char inline_[n + 1];
+};
+
+} // namespace detail
+
+/**
+ * @brief A human-readable error description.
+ * 
+ * A reason is stored as a root message plus a list of context frames,
+ * one per call to wrap or extend.  Frames are appended to a single
+ * buffer in the order they arrive, so wrapping and extending are both
+ * amortized O(1) regardless of how long the description has grown.  The
+ * flat ": " joined description is only built when it is asked for (see
+ * basic_reason::c_str) and is cached until the reason changes again.
+ * 
+ * The first inline_capacity characters, the first few frames, and the
+ * rendered description (when it fits in what is left) are stored inside
+ * the object, so a typical wrapped message never allocates.  Longer
+ * reasons move to storage from alloc_t; see jack::reason for the usual
+ * std::allocator instantiation and jack::pmr::reason for one that uses
+ * a std::pmr::memory_resource.
+ * 
+ * Copies share that storage through an atomic reference count, so a
+ * long reason is copied in constant time.  Shared storage is never
+ * written: a copy that is wrapped or extended moves to storage of its
+ * own first.  Copies can be read, copied & destroyed on different
+ * threads at once.  The first copy renders the original's description
+ * (as c_str would) so that no copy needs to write it later.
+ * 
+ * A reason that is wrapped in a loop can be bounded with limit, which
+ * keeps its innermost & outermost contexts and elides those between.
+ * 
+ * A wrap can carry the code of the layer that added it (see wrap_as),
+ * and the contexts can be read back with for_each_context, so callers
+ * can inspect the cause chain without parsing the description.
+ * 
+ * @tparam alloc_t allocator for the description & its frames
+ * @tparam inline_capacity characters stored inside the object; defaults
+ * to JACK_ERROR_INLINE_CAPACITY (64)
+ */
+template <typename alloc_t, std::size_t inline_capacity>
+class basic_reason
+{
+  public:
+
+    /// @brief Allocator used for all of this reason's storage.
+    using allocator_type = alloc_t;
+
+    /// @brief String type that shares this reason's allocator.
+    using string_type = std::basic_string<char, std::char_traits<char>, alloc_t>;
+
+    /**
+     * @brief Prevent default reason construction.
+     */
+    basic_reason() = delete;
+
+    /**
+     * @brief Construct a new reason object by moving from
+     * another reason object.
+     * 
+     * @param reason reason to move from
+     */
+    basic_reason(basic_reason&& reason) noexcept :
+            text_(std::move(reason.text_)), frames_(std::move(reason.frames_)),
+            lit_(reason.lit_), deferred_(reason.deferred_),
+            limits_(reason.limits_), limited_(reason.limited_),
+            coded_(reason.coded_)
+    {
+        reason.deferred_ = nullptr;
+        reason.forget_limits();
+    }
+
+    /**
+     * @brief Construct a new reason object by copying from
+     * another reason object.  Heap storage is shared, not copied.
+     * 
+     * @param reason reason to copy from
+     */
+    basic_reason(const basic_reason& reason) : basic_reason(reason,
+            std::allocator_traits<alloc_t>::select_on_container_copy_construction(
+                    reason.get_allocator()))
+    {
+    }
+
+    /**
+     * @brief Construct a new reason object by moving from
+     * another reason object, using the given allocator.
+     * 
+     * @param reason reason to move from
+     * @param alloc allocator for the new reason
+     */
+    basic_reason(basic_reason&& reason, const alloc_t& alloc);
+
+    /**
+     * @brief Construct a new reason object by copying from
+     * another reason object, using the given allocator.  Heap storage is
+     * shared when the allocators are equal.
+     * 
+     * @param reason reason to copy from
+     * @param alloc allocator for the new reason
+     */
+    basic_reason(const basic_reason& reason, const alloc_t& alloc) :
+            text_(alloc), frames_(alloc)
+    {
+        share(reason);
+    }
+
+    /**
+     * @brief Construct a new reason object that refers to a static
+     * string without copying it.  Nothing is allocated.
+     * 
+     * @param lit static string to refer to
+     * @param alloc allocator for any later wraps & extends
+     */
+    basic_reason(literal lit, const alloc_t& alloc = alloc_t()) noexcept(
+            std::is_nothrow_copy_constructible<alloc_t>::value) :
+            text_(alloc), frames_(alloc), lit_(lit)
+    {
+    }
+
+    /**
+     * @brief Construct a new reason object by copying from
+     * a c string.
+     * 
+     * @param c_str c string to copy from
+     * @param alloc allocator for the new reason
+     */
+    basic_reason(const char* c_str, const alloc_t& alloc = alloc_t()) :
+            text_(c_str, std::char_traits<char>::length(c_str), alloc),
+            frames_(alloc)
+    {
+    }
+
+    /**
+     * @brief Construct a new reason object by copying from
+     * a string.
+     * 
+     * @param str string to copy from
+     * @param alloc allocator for the new reason
+     */
+    basic_reason(const string_type& str, const alloc_t& alloc = alloc_t()) :
+            text_(str.data(), str.size(), alloc), frames_(alloc)
+    {
+    }
+
+    /**
+     * @brief Construct a new reason object by copying from
+     * a string.  The reason adopts the string's allocator.
+     * 
+     * @param str string to copy from
+     */
+    basic_reason(string_type&& str) :
+            text_(str.data(), str.size(), str.get_allocator()),
+            frames_(str.get_allocator())
+    {
+    }
+
+    /**
+     * @brief Construct a new reason object from an arbitrary series
+     * of parameters (see detail::make_str).
+     * 
+     * @tparam str_args types of arguments used to construct the reason
+     * @param str values to construct a reason from
+     */
+    template <typename... str_args, typename = typename std::enable_if<
+            !detail::is_allocator_arg<str_args...>::value &&
+            !detail::is_deferred_arg<str_args...>::value &&
+            !detail::any_of<std::is_same<typename std::decay<str_args>::type,
+                    alloc_t>...>::value>::type>
+    explicit basic_reason(str_args&&... str) :
+            basic_reason(std::allocator_arg, alloc_t(),
+                    std::forward<str_args>(str)...)
+    {
+    }
+
+    /**
+     * @brief Construct a new reason object from an arbitrary series
+     * of parameters (see detail::make_str), using the given allocator.
+     * 
+     * @tparam str_args types of arguments used to construct the reason
+     * @param alloc allocator for the new reason
+     * @param str values to construct a reason from
+     */
+    template <typename... str_args, typename = typename std::enable_if<
+            !detail::is_deferred_arg<str_args...>::value>::type>
+    basic_reason(std::allocator_arg_t, const alloc_t& alloc,
+            const str_args&... str) :
+            text_(alloc), frames_(alloc)
+    {
+        format_root<typename std::decay<const str_args>::type...>(str...);
+    }
+
+    /**
+     * @brief Construct a new reason object that captures an arbitrary
+     * series of parameters & formats them (see detail::make_str) only
+     * when the description is first read.  Strings are copied, so the
+     * arguments need not outlive the reason.
+     * 
+     * @tparam str_args types of arguments used to construct the reason
+     * @param str values to construct a reason from
+     */
+    template <typename... str_args>
+    basic_reason(deferred_t, const str_args&... str) :
+            basic_reason(std::allocator_arg, alloc_t(), deferred, str...)
+    {
+    }
+
+    /**
+     * @brief Construct a new reason object that captures an arbitrary
+     * series of parameters & formats them only when the description is
+     * first read, using the given allocator.
+     * 
+     * @tparam str_args types of arguments used to construct the reason
+     * @param alloc allocator for the new reason
+     * @param str values to construct a reason from
+     */
+    template <typename... str_args>
+    basic_reason(std::allocator_arg_t, const alloc_t& alloc, deferred_t,
+            const str_args&... str) :
+            text_(alloc), frames_(alloc),
+            deferred_(detail::deferred_node<alloc_t, typename std::decay<
+                    const str_args>::type...>::create(alloc, str...))
+    {
+    }
+
+    /**
+     * @brief Construct a new reason object that refers to a static
+     * string without copying it.
+     * 
+     * @param alloc allocator for any later wraps & extends
+     * @param lit static string to refer to
+     */
+    basic_reason(std::allocator_arg_t, const alloc_t& alloc, literal lit)
+            noexcept(std::is_nothrow_copy_constructible<alloc_t>::value) :
+            basic_reason(lit, alloc)
+    {
+    }
+
+    /**
+     * @brief Construct a new reason object by copying from
+     * another reason object, using the given allocator.
+     * 
+     * @param alloc allocator for the new reason
+     * @param reason reason to copy from
+     */
+    basic_reason(std::allocator_arg_t, const alloc_t& alloc,
+            const basic_reason& reason) : basic_reason(reason, alloc)
+    {
+    }
+
+    /**
+     * @brief Construct a new reason object by moving from
+     * another reason object, using the given allocator.
+     * 
+     * @param alloc allocator for the new reason
+     * @param reason reason to move from
+     */
+    basic_reason(std::allocator_arg_t, const alloc_t& alloc,
+            basic_reason&& reason) : basic_reason(std::move(reason), alloc)
+    {
+    }
+
+    /**
+     * @brief Copy assignment operator.
+     * 
+     * @param other reason to copy from
+     * @return reference to this reason
+     */
+    basic_reason& operator=(const basic_reason& other)
+    {
+        if (this != &other)
+        {
+            share(other);
+        }
+        return *this;
+    }
+    
+    /**
+     * @brief Move assignment operator.
+     * 
+     * @param from reason to move from
+     * @return reference to this reason
+     */
+    basic_reason& operator=(basic_reason&& from);
+
+    ~basic_reason()
+    {
+        reset_deferred(nullptr);
+    }
+
+    /**
+     * @brief Get the allocator used for this reason's storage.
+     * 
+     * @return copy of the allocator
+     */
+    allocator_type get_allocator() const
+    {
+        return text_.get_allocator();
+    }
+
+    /**
+     * @brief Get the full description as a c string.  The description
+     * is rendered on the first call after a wrap or extend; later calls
+     * return the cached result.
+     * 
+     * @return null-terminated description owned by this reason
+     */
+    const char* c_str() const
+    {
+        if (frames_.empty())
+        {
+            const literal r = root();
+            return r.data ? r.data : text_.c_str();
+        }
+        if (!rendered_)
+        {
+            render();
+        }
+        return rendered();
+    }
+
+    /**
+     * @brief Get the length of the full description without rendering it.
+     * The arguments of a deferred reason are formatted, though.
+     * 
+     * @return number of characters in the description
+     */
+    std::size_t size() const
+    {
+        if (limited_)
+        {
+            return limits_.live + marker_size(frame::wrap) +
+                    marker_size(frame::extend);
+        }
+        std::size_t size = root().size + text_.size() + frames_.size() * 2;
+        for (const auto& f : frames_)
+        {
+            if (f.located)
+            {
+                size += located_size(f);
+            }
+        }
+        return size;
+    }
+
+    /**
+     * @brief Wrap this reason with additional context (prepend).
+     * 
+     * @param context values to contruct a string from
+     * @return reference to this reason
+     */
+    template <typename... str_args>
+    basic_reason& wrap(str_args&&... context)
+    {
+        return format_frame<typename std::decay<str_args>::type...>(
+                frame::wrap, context...);
+    }
+    
+    /**
+     * @brief Wrap this reason with additional context (prepend).
+     * 
+     * @param context c string to copy from
+     * @return reference to this reason
+     */
+    basic_reason& wrap(const char* context)
+    {
+        return push_frame(frame::wrap, context,
+                std::char_traits<char>::length(context));
+    }
+
+    /**
+     * @brief Wrap this reason with additional context (prepend).
+     * 
+     * @param context string to copy from
+     * @return reference to this reason
+     */
+    basic_reason& wrap(const string_type& context)
+    {
+        return push_frame(frame::wrap, context.data(), context.size());
+    }
+
+    /**
+     * @brief Wrap this reason with additional context (prepend).
+     * 
+     * @param context reason to copy from
+     * @return reference to this reason
+     */
+    basic_reason& wrap(const basic_reason& context)
+    {
+        return push_frame(frame::wrap, context.c_str(), context.size());
+    }
+
+    /**
+     * @brief Wrap this reason with a source location (prepend).  Only
+     * the location is stored; it is written as "file:line in function"
+     * when the description is read.
+     * 
+     * @param where location to refer to
+     * @return reference to this reason
+     */
+    basic_reason& wrap(location where)
+    {
+        return push_location(frame::wrap, where);
+    }
+
+    /**
+     * @brief Wrap this reason with the location of the call (prepend).
+     * 
+     * @param where location to refer to; defaults to the caller's
+     * @return reference to this reason
+     */
+    basic_reason& trace(location where = location::current())
+    {
+        return push_location(frame::wrap, where);
+    }
+
+    /**
+     * @brief Wrap this reason with additional context (prepend) that
+     * carries the code of the layer adding it.  The code is kept with
+     * the context and read back by for_each_context.
+     * 
+     * @param code code of the wrapping layer
+     * @param context values to construct a string from
+     * @return reference to this reason
+     */
+    template <typename... str_args>
+    basic_reason& wrap_as(int code, str_args&&... context)
+    {
+        format_frame<typename std::decay<str_args>::type...>(
+                frame::wrap, context...);
+
+        // the newest frame is never elided, so it is still the last
+        frame& f = frames_.back();
+        f.coded = true;
+        f.code = code;
+        coded_ = true;
+        return *this;
+    }
+
+    /**
+     * @brief Extend this reason with additional information (append).
+     * 
+     * @param info values to construct a string from
+     * @return reference to this reason
+     */
+    template <typename... str_args>
+    basic_reason& extend(str_args&&... info)
+    {
+        return format_frame<typename std::decay<str_args>::type...>(
+                frame::extend, info...);
+    }
+
+    /**
+     * @brief Extend this reason with additional information (append).
+     * 
+     * @param info c string to copy from
+     * @return reference to this reason
+     */
+    basic_reason& extend(const char* info)
+    {
+        return push_frame(frame::extend, info,
+                std::char_traits<char>::length(info));
+    }
+
+    /**
+     * @brief Extend this reason with additional information (append).
+     * 
+     * @param info string to copy from
+     * @return reference to this reason
+     */
+    basic_reason& extend(const string_type& info)
+    {
+        return push_frame(frame::extend, info.data(), info.size());
+    }
+
+    /**
+     * @brief Extend this reason with additional information (append).
+     * 
+     * @param info reason to copy from
+     * @return reference to this reason
+     */
+    basic_reason& extend(const basic_reason& info)
+    {
+        return push_frame(frame::extend, info.c_str(), info.size());
+    }
+
+    /**
+     * @brief Extend this reason with a source location (append).  Only
+     * the location is stored; it is written as "file:line in function"
+     * when the description is read.
+     * 
+     * @param where location to refer to
+     * @return reference to this reason
+     */
+    basic_reason& extend(location where)
+    {
+        return push_location(frame::extend, where);
+    }
+
+    /**
+     * @brief Bound how far this reason grows, e.g. when it is wrapped on
+     * every attempt of a retry loop.  When a wrap or extend would pass a
+     * limit, the innermost half of the contexts are kept with the newest
+     * ones, and those in between are replaced by "[... n frames elided
+     * ...]".  From then on each wrap or extend elides the oldest of the
+     * outer contexts, in amortized O(1), and elided text is freed.
+     * 
+     * The root message, the inner contexts and the markers are never
+     * cut, so max_size should leave room for them.  If the newest
+     * context still doesn't fit, its end is cut (at a UTF-8 character
+     * boundary) and replaced by "...".
+     * 
+     * @param max_frames most contexts kept; 0 for no limit
+     * @param max_size most characters in the description; 0 for no limit
+     * @return reference to this reason
+     */
+    basic_reason& limit(std::size_t max_frames, std::size_t max_size = 0);
+
+    /**
+     * @brief Get the number of contexts elided to stay within the limits.
+     * 
+     * @return wraps & extends elided so far
+     */
+    std::size_t elided() const noexcept
+    {
+        return std::size_t(limits_.elided[frame::wrap]) +
+                limits_.elided[frame::extend];
+    }
+
+    /**
+     * @brief Check whether any context was added with a code, even one
+     * that has since been elided.
+     * 
+     * @return true once wrap_as has been called
+     */
+    bool coded() const noexcept
+    {
+        return coded_;
+    }
+
+    /**
+     * @brief Visit each wrap & extend in the order they were added, the
+     * innermost first, without rendering the description.  Contexts
+     * elided by limit are visited as one marker per role.  The context
+     * is only valid during the visit.
+     * 
+     * @param visit callable accepting (const jack::context&)
+     */
+    template <typename visitor_t>
+    void for_each_context(visitor_t&& visit) const
+    {
+        const char* base = text_.data();
+        for_each_kept([&](const frame& f) {
+            context c{nullptr, 0, location{nullptr, nullptr, 0},
+                    f.role == frame::wrap, f.coded, f.coded ? f.code : 0};
+            if (f.located)
+            {
+                c.where = location{f.file, f.function, f.line};
+            }
+            else
+            {
+                c.data = base + f.offset;
+                c.size = f.size;
+            }
+            visit(static_cast<const context&>(c));
+        }, [&](typename frame::kind role) {
+            char marker[64];
+            std::size_t size = 0;
+            auto append = [&marker, &size](const char* data, std::size_t n) {
+                std::memcpy(marker + size, data, n);
+                size += n;
+            };
+            visit_marker(role, append);
+            const context c{marker, size, location{nullptr, nullptr, 0},
+                    role == frame::wrap, false, 0};
+            visit(c);
+        });
+    }
+
+  private:
+
+    friend struct detail::reason_access;
+
+    /**
+     * @brief Location of a wrap or extend context within text_.  A
+     * located frame holds a jack::location instead, and adds nothing
+     * to text_.
+     */
+    struct frame
+    {
+        enum kind : unsigned char { wrap, extend };
+
+        union
+        {
+            std::size_t offset;
+            const char* file;
+        };
+        union
+        {
+            std::size_t size;
+            const char* function;
+        };
+
+        // only text frames carry codes, so the two can share
+        union
+        {
+            unsigned line;
+            int code;
+        };
+        kind role;
+        bool located;
+        bool coded;
+    };
+
+    /// @brief Frames stored inside the object, about one per 32
+    /// characters of inline_capacity.
+    static constexpr std::size_t inline_frames =
+            inline_capacity / 32 ? inline_capacity / 32 : 1;
+
+    /// @brief Frames reserved once they no longer fit inside the object.
+    static constexpr std::size_t initial_frames = 8;
+
+    /**
+     * @brief Append a context to the frame buffer and drop any
+     * previously rendered description.
+     * 
+     * @param role whether the context is prepended or appended
+     * @param data first character of the context
+     * @param size number of characters in the context
+     * @return reference to this reason
+     */
+    basic_reason& push_frame(typename frame::kind role,
+            const char* data, std::size_t size)
+    {
+        const std::size_t offset = text_.size();
+        text_.append(data, size);
+        return end_text_frame(role, offset);
+    }
+
+    /**
+     * @brief Append a source location to the frame buffer as it is.
+     * 
+     * @param role whether the location is prepended or appended
+     * @param where location to copy
+     * @return reference to this reason
+     */
+    basic_reason& push_location(typename frame::kind role, const location& where)
+    {
+        frame f;
+        f.file = where.file;
+        f.function = where.function;
+        f.line = where.line;
+        f.role = role;
+        f.located = true;
+        f.coded = false;
+        return end_frame(f);
+    }
+
+    /**
+     * @brief Get the location held by a located frame.
+     */
+    static location located_at(const frame& f) noexcept
+    {
+        return location{f.file, f.function, f.line};
+    }
+
+    /**
+     * @brief Get the length of a located frame once written out.
+     */
+    static std::size_t located_size(const frame& f) noexcept
+    {
+        char digits[detail::line_digits];
+        const location where = located_at(f);
+        return std::char_traits<char>::length(where.file) + 1 +
+                detail::format_line(where.line, digits) + 4 +
+                std::char_traits<char>::length(where.function);
+    }
+
+    /**
+     * @brief Visit the pieces of one frame's context.  The pieces of a
+     * located frame are only valid during the visit.
+     * 
+     * @param f frame to visit
+     * @param visit callable accepting (const char*, std::size_t)
+     */
+    template <typename visitor_t>
+    void visit_frame(const frame& f, visitor_t& visit) const
+    {
+        if (!f.located)
+        {
+            visit(text_.data() + f.offset, f.size);
+            return;
+        }
+        char digits[detail::line_digits];
+        const location where = located_at(f);
+        const std::size_t n = detail::format_line(where.line, digits);
+        visit(where.file, std::char_traits<char>::length(where.file));
+        visit(":", 1);
+        visit(digits + detail::line_digits - n, n);
+        visit(" in ", 4);
+        visit(where.function, std::char_traits<char>::length(where.function));
+    }
+
+    /**
+     * @brief Format a context directly onto the end of the frame buffer.
+     * A context that includes a reason is formatted separately first,
+     * as that reason may be this one and its characters could move
+     * while the buffer grows.
+     * 
+     * @param role whether the context is prepended or appended
+     * @param args values to construct the context from
+     * @return reference to this reason
+     */
+    template <typename... str_args>
+    basic_reason& format_frame(typename frame::kind role,
+            const str_args&... args);
+
+    /**
+     * @brief Format the root message into the empty frame buffer.
+     * 
+     * @param args values to construct the root message from
+     */
+    template <typename... str_args>
+    void format_root(const str_args&... args);
+
+    /**
+     * @brief Record the context that starts at offset and runs to the end
+     * of the frame buffer.
+     * 
+     * @param role whether the context is prepended or appended
+     * @param offset position of the context's first character in text_
+     * @return reference to this reason
+     */
+    basic_reason& end_text_frame(typename frame::kind role, std::size_t offset)
+    {
+        frame f;
+        f.offset = offset;
+        f.size = text_.size() - offset;
+        f.line = 0;
+        f.role = role;
+        f.located = false;
+        f.coded = false;
+        return end_frame(f);
+    }
+
+    /**
+     * @brief Record a frame and drop any previously rendered description.
+     * 
+     * @param f frame to record
+     * @return reference to this reason
+     */
+    basic_reason& end_frame(const frame& f);
+
+    /**
+     * @brief Visit each kept frame in arrival order, with a marker for
+     * the contexts of each role that were elided between the inner &
+     * outer ones.
+     * 
+     * @param on_frame callable accepting (const frame&)
+     * @param on_marker callable accepting (frame::kind)
+     */
+    template <typename frame_fn, typename marker_fn>
+    void for_each_kept(frame_fn&& on_frame, marker_fn&& on_marker) const
+    {
+        for (std::size_t i = 0; i < limits_.head; ++i)
+        {
+            on_frame(frames_[i]);
+        }
+        for (typename frame::kind role : {frame::wrap, frame::extend})
+        {
+            if (limits_.elided[role] != 0)
+            {
+                on_marker(role);
+            }
+        }
+        for (std::size_t i = limits_.first_kept; i < frames_.size(); ++i)
+        {
+            on_frame(frames_[i]);
+        }
+    }
+
+    /**
+     * @brief Drop the limits of a reason whose frames were moved out.
+     */
+    void forget_limits() noexcept
+    {
+        if (frames_.empty())
+        {
+            limits_ = limit_state();
+            limited_ = false;
+        }
+    }
+
+    /**
+     * @brief Get the length of a frame's context once written out.
+     */
+    static std::size_t frame_size(const frame& f) noexcept
+    {
+        return f.located ? located_size(f) : f.size;
+    }
+
+    /**
+     * @brief Get the length of the marker that stands for elided
+     * contexts of one role, with its separator.
+     */
+    std::size_t marker_size(typename frame::kind role) const noexcept
+    {
+        const std::uint32_t count = limits_.elided[role];
+        if (count == 0)
+        {
+            return 0;
+        }
+        char digits[detail::line_digits];
+        return 2 + sizeof("[...  frames elided ...]") - 1 - (count == 1) +
+                detail::format_line(count, digits);
+    }
+
+    /**
+     * @brief Visit the pieces of the marker that stands for elided
+     * contexts of one role, which are only valid during the visit.
+     */
+    template <typename visitor_t>
+    void visit_marker(typename frame::kind role, visitor_t& visit) const
+    {
+        static constexpr const char one[] = " frame elided ...]";
+        static constexpr const char many[] = " frames elided ...]";
+
+        const std::uint32_t count = limits_.elided[role];
+        char digits[detail::line_digits];
+        const std::size_t n = detail::format_line(count, digits);
+        visit("[... ", 5);
+        visit(digits + detail::line_digits - n, n);
+        if (count == 1)
+        {
+            visit(one, sizeof(one) - 1);
+        }
+        else
+        {
+            visit(many, sizeof(many) - 1);
+        }
+    }
+
+    /**
+     * @brief Whether the kept contexts pass a limit.
+     */
+    bool over_limit() const noexcept
+    {
+        const std::size_t kept = frames_.size() -
+                (limits_.first_kept - limits_.head);
+        return (limits_.max_frames != 0 && kept > limits_.max_frames) ||
+                (limits_.max_size != 0 && size() > limits_.max_size);
+    }
+
+    /**
+     * @brief Elide outer contexts, oldest first, until the reason is
+     * within its limits; the newest context is never elided, but may be
+     * cut.  Elided frames stay in place until they outnumber the kept
+     * ones, then are dropped all at once with their text.
+     */
+    void bound();
+
+    /**
+     * @brief Shorten the newest context, if it is text, by at least
+     * excess characters without splitting a UTF-8 character.  What is
+     * left ends in "..." when there is room for it.
+     */
+    void cut_newest(std::size_t excess);
+
+    /**
+     * @brief Remove elided frames & their text, moving the text of the
+     * kept frames down in place.  Text is in the order of its frames, so
+     * each move is to an earlier position.
+     */
+    void drop_elided();
+
+    /**
+     * @brief Get the length of the root message when it is in text_.
+     * Located frames add nothing to text_, so the root runs up to the
+     * first text frame.
+     */
+    std::size_t root_size() const noexcept
+    {
+        for (const auto& f : frames_)
+        {
+            if (!f.located)
+            {
+                return f.offset;
+            }
+        }
+        return text_.size();
+    }
+
+    /**
+     * @brief Visit each piece of the full description in order.  Wraps
+     * are visited newest first, then the root message, then extends
+     * oldest first.
+     * 
+     * @param visit callable accepting (const char*, std::size_t)
+     */
+    template <typename visitor_t>
+    void for_each_piece(visitor_t&& visit) const
+    {
+        static constexpr const char separator[] = ": ";
+
+        // contexts between the inner & outer ones kept may be elided
+        const std::size_t head = limits_.head;
+        const std::size_t outer = limits_.first_kept;
+
+        const char* base = text_.data();
+        for (std::size_t i = frames_.size(); i-- != outer;)
+        {
+            if (frames_[i].role == frame::wrap)
+            {
+                visit_frame(frames_[i], visit);
+                visit(separator, 2);
+            }
+        }
+        if (limits_.elided[frame::wrap] != 0)
+        {
+            visit_marker(frame::wrap, visit);
+            visit(separator, 2);
+        }
+        for (std::size_t i = head; i-- != 0;)
+        {
+            if (frames_[i].role == frame::wrap)
+            {
+                visit_frame(frames_[i], visit);
+                visit(separator, 2);
+            }
+        }
+        const literal r = root();
+        if (r.data)
+        {
+            visit(r.data, r.size);
+        }
+        else
+        {
+            visit(base, root_size());
+        }
+        for (std::size_t i = 0; i < head; ++i)
+        {
+            if (frames_[i].role == frame::extend)
+            {
+                visit(separator, 2);
+                visit_frame(frames_[i], visit);
+            }
+        }
+        if (limits_.elided[frame::extend] != 0)
+        {
+            visit(separator, 2);
+            visit_marker(frame::extend, visit);
+        }
+        for (std::size_t i = outer; i < frames_.size(); ++i)
+        {
+            if (frames_[i].role == frame::extend)
+            {
+                visit(separator, 2);
+                visit_frame(frames_[i], visit);
+            }
+        }
+    }
+
+    /**
+     * @brief Get the root message when it isn't stored in text_, i.e. it
+     * is a literal or deferred arguments, formatting those if needed.
+     * 
+     * @return root message, or a null literal if it is in text_
+     */
+    literal root() const
+    {
+        if (deferred_)
+        {
+            const string_type& str = deferred_->str();
+            return literal(str.c_str(), str.size());
+        }
+        return lit_;
+    }
+
+    /**
+     * @brief Release any deferred arguments & take ownership of others.
+     * 
+     * @param args arguments to hold; may be null
+     */
+    void reset_deferred(detail::deferred_args<alloc_t>* args) noexcept
+    {
+        if (deferred_)
+        {
+            deferred_->release();
+        }
+        deferred_ = args;
+    }
+
+    /**
+     * @brief Become a copy of other, sharing its heap storage when the
+     * allocators are equal.  The description is rendered before it is
+     * shared, so that none of the copies writes to the shared storage.
+     * 
+     * @param other reason to copy from
+     */
+    void share(const basic_reason& other);
+
+    /**
+     * @brief Build the flat description in the spare room past the end
+     * of text_, so that a short description is rendered without
+     * allocating either.
+     */
+    void render() const;
+
+    /**
+     * @brief Get the rendered description, if it is up to date.
+     * 
+     * @return null-terminated description, or null
+     */
+    const char* rendered() const noexcept
+    {
+        return rendered_ ? text_.data() + text_.size() + 1 : nullptr;
+    }
+
+    /// @brief Root message (unless it is lit_ or deferred_) followed by every
+    /// context, in arrival order.  The rendered description is cached just
+    /// past its end.
+    mutable detail::inline_string<inline_capacity, alloc_t> text_;
+
+    /// @brief One entry per wrap or extend, in arrival order.
+    detail::inline_vector<frame, inline_frames, alloc_t> frames_;
+
+    /// @brief Static root message; null when the root is in text_.
+    literal lit_ = literal(nullptr, 0);
+
+    /// @brief Captured root arguments; null unless the reason is deferred.
+    detail::deferred_args<alloc_t>* deferred_ = nullptr;
+
+    /// @brief Limits set with limit, & what they have elided so far.
+    struct limit_state
+    {
+        /// @brief Most contexts kept; 0 for no limit.
+        std::uint32_t max_frames = 0;
+
+        /// @brief Most characters in the description; 0 for no limit.
+        std::uint32_t max_size = 0;
+
+        /// @brief Innermost frames that are always kept.
+        std::uint32_t head = 0;
+
+        /// @brief First outer frame kept; frames from head up to it are
+        /// elided but not yet dropped.
+        std::uint32_t first_kept = 0;
+
+        /// @brief Contexts elided so far, by role.
+        std::uint32_t elided[2] = {0, 0};
+
+        /// @brief Length of the description, less the markers; kept up
+        /// to date once limit has been called.
+        std::uint32_t live = 0;
+    };
+
+    /// @brief Limits set with limit, & what they have elided so far.
+    limit_state limits_;
+
+    /// @brief Whether limit has been called.
+    bool limited_ = false;
+
+    /// @brief Whether wrap_as has been called.
+    bool coded_ = false;
+
+    /// @brief Whether the description past the end of text_ is current.
+    mutable bool rendered_ = false;
+};
+
+// the larger members are defined here, outside the class, so that the
+// compiled library can keep them out of other translation units
+
+template <typename alloc_t, std::size_t inline_capacity>
+JACK_DETAIL_OUT_OF_LINE basic_reason<alloc_t, inline_capacity>::basic_reason(
+        basic_reason&& reason, const alloc_t& alloc) :
+        text_(std::move(reason.text_), alloc),
+        frames_(std::move(reason.frames_), alloc), lit_(reason.lit_),
+        deferred_(reason.deferred_), limits_(reason.limits_),
+        limited_(reason.limited_), coded_(reason.coded_)
+{
+    reason.forget_limits();
+    if (deferred_ && !(alloc == reason.get_allocator()))
+    {
+        deferred_ = deferred_->clone(alloc);
+    }
+    else
+    {
+        reason.deferred_ = nullptr;
+    }
+}
+
+template <typename alloc_t, std::size_t inline_capacity>
+JACK_DETAIL_OUT_OF_LINE basic_reason<alloc_t, inline_capacity>&
+basic_reason<alloc_t, inline_capacity>::operator=(basic_reason&& from)
+{
+    if (this != &from)
+    {
+        text_ = std::move(from.text_);
+        frames_ = std::move(from.frames_);
+        rendered_ = false;
+        lit_ = from.lit_;
+        limits_ = from.limits_;
+        limited_ = from.limited_;
+        coded_ = from.coded_;
+        from.forget_limits();
+        if (from.deferred_ && !(get_allocator() == from.get_allocator()))
+        {
+            reset_deferred(from.deferred_->clone(get_allocator()));
+        }
+        else
+        {
+            reset_deferred(from.deferred_);
+            from.deferred_ = nullptr;
+        }
+    }
+    return *this;
+}
+
+template <typename alloc_t, std::size_t inline_capacity>
+JACK_DETAIL_OUT_OF_LINE basic_reason<alloc_t, inline_capacity>&
+basic_reason<alloc_t, inline_capacity>::limit(std::size_t max_frames,
+        std::size_t max_size)
+{
+    if (!limited_)
+    {
+        limits_.live = size();
+        limited_ = true;
+    }
+    limits_.max_frames = static_cast<std::uint32_t>(
+            std::min<std::size_t>(max_frames,
+                    std::numeric_limits<std::uint32_t>::max()));
+    limits_.max_size = static_cast<std::uint32_t>(
+            std::min<std::size_t>(max_size,
+                    std::numeric_limits<std::uint32_t>::max()));
+    if (!frames_.empty())
+    {
+        bound();
+    }
+    return *this;
+}
+
+template <typename alloc_t, std::size_t inline_capacity>
+template <typename... str_args>
+JACK_DETAIL_OUT_OF_LINE basic_reason<alloc_t, inline_capacity>&
+basic_reason<alloc_t, inline_capacity>::format_frame(typename frame::kind role,
+        const str_args&... args)
+{
+    if (detail::any_of<std::is_same<
+            typename std::decay<str_args>::type, basic_reason>...>::value)
+    {
+        string_type str(text_.get_allocator());
+        detail::append_str(str, args...);
+        return push_frame(role, str.data(), str.size());
+    }
+    const std::size_t offset = text_.size();
+    detail::append_str(text_, args...);
+    return end_text_frame(role, offset);
+}
+
+template <typename alloc_t, std::size_t inline_capacity>
+template <typename... str_args>
+JACK_DETAIL_OUT_OF_LINE void basic_reason<alloc_t, inline_capacity>::format_root(
+        const str_args&... args)
+{
+    detail::append_str(text_, args...);
+}
+
+template <typename alloc_t, std::size_t inline_capacity>
+JACK_DETAIL_OUT_OF_LINE basic_reason<alloc_t, inline_capacity>&
+basic_reason<alloc_t, inline_capacity>::end_frame(const frame& f)
+{
+    if (frames_.size() == inline_frames)
+    {
+        frames_.reserve(initial_frames);
+    }
+    frames_.push_back(f);
+    rendered_ = false;
+    if (limited_)
+    {
+        limits_.live += frame_size(f) + 2;
+        bound();
+    }
+    return *this;
+}
+
+template <typename alloc_t, std::size_t inline_capacity>
+JACK_DETAIL_OUT_OF_LINE void basic_reason<alloc_t, inline_capacity>::bound()
+{
+    if (!over_limit())
+    {
+        return;
+    }
+    if (elided() == 0)
+    {
+        // the innermost half of what was there is kept for good, so
+        // long as it takes no more than half of each limit
+        std::size_t head = (frames_.size() - 1) / 2;
+        if (limits_.max_frames != 0)
+        {
+            head = std::min<std::size_t>(head, limits_.max_frames / 2);
+        }
+        if (limits_.max_size != 0)
+        {
+            std::size_t inner = limits_.live;
+            for (const auto& f : frames_)
+            {
+                inner -= frame_size(f) + 2;
+            }
+            for (std::size_t i = 0; i < head; ++i)
+            {
+                inner += frame_size(frames_[i]) + 2;
+                if (inner > limits_.max_size / 2)
+                {
+                    head = i;
+                    break;
+                }
+            }
+        }
+        limits_.head = limits_.first_kept = static_cast<std::uint32_t>(head);
+    }
+    while (limits_.first_kept + 1 < frames_.size() && over_limit())
+    {
+        const frame& f = frames_[limits_.first_kept];
+        limits_.live -= static_cast<std::uint32_t>(frame_size(f) + 2);
+        ++limits_.elided[f.role];
+        ++limits_.first_kept;
+    }
+    if (limits_.max_size != 0 && size() > limits_.max_size)
+    {
+        cut_newest(size() - limits_.max_size);
+    }
+    if (limits_.first_kept - limits_.head >=
+            frames_.size() - limits_.first_kept + limits_.head)
+    {
+        drop_elided();
+    }
+}
+
+template <typename alloc_t, std::size_t inline_capacity>
+JACK_DETAIL_OUT_OF_LINE void
+basic_reason<alloc_t, inline_capacity>::cut_newest(std::size_t excess)
+{
+    frame& f = frames_.back();
+    if (f.located)
+    {
+        return;
+    }
+    const std::size_t room = f.size > excess ? f.size - excess : 0;
+    const bool dots = room > 3;
+    std::size_t cut = dots ? room - 3 : room;
+    const char* const data = text_.data() + f.offset;
+    while (cut != 0 && (static_cast<unsigned char>(data[cut]) & 0xc0) == 0x80)
+    {
+        --cut;
+    }
+    text_.resize(f.offset + cut);
+    if (dots)
+    {
+        text_.append("...", 3);
+    }
+    limits_.live -= static_cast<std::uint32_t>(f.size - (text_.size() - f.offset));
+    f.size = text_.size() - f.offset;
+}
+
+template <typename alloc_t, std::size_t inline_capacity>
+JACK_DETAIL_OUT_OF_LINE void basic_reason<alloc_t, inline_capacity>::drop_elided()
+{
+    std::size_t used = root_size();
+    frames_.erase(limits_.head, limits_.first_kept);
+    limits_.first_kept = limits_.head;
+
+    text_.resize(text_.size());
+    char* const data = text_.data();
+    for (auto& f : frames_)
+    {
+        if (!f.located)
+        {
+            std::memmove(data + used, data + f.offset, f.size);
+            f.offset = used;
+            used += f.size;
+        }
+    }
+    text_.resize(used);
+    rendered_ = false;
+}
+
+template <typename alloc_t, std::size_t inline_capacity>
+JACK_DETAIL_OUT_OF_LINE void
+basic_reason<alloc_t, inline_capacity>::share(const basic_reason& other)
+{
+    if (!other.rendered_ && !other.frames_.empty() &&
+            other.text_.heap_bytes() != 0 &&
+            get_allocator() == other.get_allocator())
+    {
+        other.render();
+    }
+    text_.share(other.text_);
+    frames_.share(other.frames_);
+    rendered_ = other.rendered_ && text_.data() == other.text_.data();
+    lit_ = other.lit_;
+    limits_ = other.limits_;
+    limited_ = other.limited_;
+    coded_ = other.coded_;
+    reset_deferred(other.deferred_ ?
+            other.deferred_->share(get_allocator()) : nullptr);
+}
+
+template <typename alloc_t, std::size_t inline_capacity>
+JACK_DETAIL_OUT_OF_LINE void basic_reason<alloc_t, inline_capacity>::render() const
+{
+    char* out = text_.spare(size() + 1);
+    for_each_piece([&out](const char* data, std::size_t size) {
+        std::memcpy(out, data, size);
+        out += size;
+    });
+    *out = '\0';
+    rendered_ = true;
+}
+
+/**
+ * @brief A human-readable error description using std::allocator.
+ */
+using reason = basic_reason<>;
+
+namespace detail
+{
+
+/**
+ * @brief Reasons are copied directly from their description.
+ */
+template <typename alloc_t, std::size_t n>
+class piece<basic_reason<alloc_t, n>> : public view_piece
+{
+  public:
+
+    /// @brief Reading the description may render it.
+    static constexpr bool allocates = true;
+
+    explicit piece(const basic_reason<alloc_t, n>& value) :
+            view_piece(value.c_str(), value.size())
+    {
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Implement stream operator for reason class.
+ * 
+ * @param os std::ostream reference to write to
+ * @param reason reason to write from
+ * @return reference to param os
+ */
+template <typename alloc_t, std::size_t n>
+inline std::ostream& operator<<(std::ostream& os,
+        const basic_reason<alloc_t, n>& reason)
+{
+    return os << reason.c_str();
+}
+
+#ifdef JACK_DETAIL_CPP17
+/**
+ * @brief How serious an error code is.
+ */
+enum class severity : unsigned char
+{
+    debug,
+    info,
+    warning,
+    error,
+    critical
+};
+
+/**
+ * @brief One entry of a code_catalog.
+ *
+ * @tparam enum_t enumeration of the catalog's codes
+ */
+template <typename enum_t>
+struct code_info
+{
+    /// @brief The code.
+    enum_t code;
+
+    /// @brief Short identifier, e.g. "timeout".
+    literal name;
+
+    /// @brief Default human-readable description.
+    literal message;
+
+    /// @brief How serious the code is.
+    jack::severity level;
+};
+
+/**
+ * @brief A catalog of error codes, declared by specializing this
+ * template for an enumeration.  A specialization has a static constexpr
+ * literal domain (the std::error_category name) and a static constexpr
+ * array of code_info entries, listed in order with consecutive values so
+ * that every lookup is a single index.  Requires C++17.
+ *
+ * @code
+ * enum class db_errc { timeout = 1001, refused, corrupt };
+ *
+ * template <>
+ * struct jack::code_catalog<db_errc>
+ * {
+ *     static constexpr jack::literal domain = "db";
+ *     static constexpr jack::code_info<db_errc> entries[] = {
+ *         {db_errc::timeout, "timeout", "operation timed out", jack::severity::warning},
+ *         {db_errc::refused, "refused", "connection refused", jack::severity::error},
+ *         {db_errc::corrupt, "corrupt", "page checksum mismatch", jack::severity::critical},
+ *     };
+ * };
+ * @endcode
+ *
+ * @tparam enum_t enumeration of the catalog's codes
+ */
+template <typename enum_t>
+struct code_catalog
+{
+};
+
+namespace detail
+{
+
+template <typename enum_t, typename = void>
+struct is_cataloged : std::false_type
+{
+};
+
+template <typename enum_t>
+struct is_cataloged<enum_t, std::void_t<decltype(
+        code_catalog<enum_t>::entries[0].code)>> : std::is_enum<enum_t>
+{
+};
+
+/// @brief Number of entries in a catalog.
+template <typename enum_t>
+constexpr std::size_t catalog_size = std::extent<
+        decltype(code_catalog<enum_t>::entries)>::value;
+
+/**
+ * @brief Whether a catalog's entries have consecutive values, in order.
+ */
+template <typename enum_t>
+constexpr bool catalog_dense()
+{
+    constexpr auto& entries = code_catalog<enum_t>::entries;
+    for (std::size_t i = 1; i < catalog_size<enum_t>; ++i)
+    {
+        if (static_cast<long long>(entries[i].code) !=
+                static_cast<long long>(entries[0].code) + static_cast<long long>(i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Get the index of a code's catalog entry.
+ *
+ * @param code code to look up
+ * @return index of the code's entry, or catalog_size if it isn't listed
+ */
+template <typename enum_t>
+constexpr std::size_t catalog_index(enum_t code) noexcept
+{
+    static_assert(catalog_dense<enum_t>(), "code_catalog entries "
+            "must be listed in order with consecutive values");
+    const long long i = static_cast<long long>(code) -
+            static_cast<long long>(code_catalog<enum_t>::entries[0].code);
+    return i >= 0 && i < static_cast<long long>(catalog_size<enum_t>) ?
+            static_cast<std::size_t>(i) : catalog_size<enum_t>;
+}
+
+} // namespace detail
+
+/**
+ * @brief Whether a type is an enumeration with a code_catalog.
+ */
+template <typename t>
+constexpr bool is_cataloged_v = detail::is_cataloged<t>::value;
+
+/**
+ * @brief Find the catalog entry of a code in constant time.
+ *
+ * @param code code to look up
+ * @return the code's entry, or null if the catalog doesn't list it
+ */
+template <typename enum_t, typename = std::enable_if_t<is_cataloged_v<enum_t>>>
+constexpr const code_info<enum_t>* find_code(enum_t code) noexcept
+{
+    const std::size_t i = detail::catalog_index(code);
+    return i < detail::catalog_size<enum_t> ?
+            &code_catalog<enum_t>::entries[i] : nullptr;
+}
+
+/**
+ * @brief Get the name of a code, e.g. for a log line.
+ *
+ * @param code code to look up
+ * @return the code's name, or "unknown" if the catalog doesn't list it
+ */
+template <typename enum_t, typename = std::enable_if_t<is_cataloged_v<enum_t>>>
+constexpr literal code_name(enum_t code) noexcept
+{
+    const std::size_t i = detail::catalog_index(code);
+    return i < detail::catalog_size<enum_t> ?
+            code_catalog<enum_t>::entries[i].name : literal("unknown");
+}
+
+/**
+ * @brief Get the default message of a code.
+ *
+ * @param code code to look up
+ * @return the code's message, or "unknown error" if the catalog doesn't
+ * list it
+ */
+template <typename enum_t, typename = std::enable_if_t<is_cataloged_v<enum_t>>>
+constexpr literal code_message(enum_t code) noexcept
+{
+    const std::size_t i = detail::catalog_index(code);
+    return i < detail::catalog_size<enum_t> ?
+            code_catalog<enum_t>::entries[i].message : literal("unknown error");
+}
+
+/**
+ * @brief Get the severity of a code.
+ *
+ * @param code code to look up
+ * @return the code's severity, or severity::error if the catalog doesn't
+ * list it
+ */
+template <typename enum_t, typename = std::enable_if_t<is_cataloged_v<enum_t>>>
+constexpr severity code_severity(enum_t code) noexcept
+{
+    const std::size_t i = detail::catalog_index(code);
+    return i < detail::catalog_size<enum_t> ?
+            code_catalog<enum_t>::entries[i].level : severity::error;
+}
+
+namespace detail
+{
+
+/**
+ * @brief Base of every catalog's std::error_category, which lets an
+ * error take a catalog message from a std::error_code without the
+ * std::string of std::error_category::message.
+ */
+class catalog_category_base : public std::error_category
+{
+  public:
+
+    virtual literal literal_message(int code) const noexcept = 0;
+};
+
+template <typename enum_t>
+class catalog_category final : public catalog_category_base
+{
+  public:
+
+    const char* name() const noexcept override
+    {
+        return code_catalog<enum_t>::domain.data;
+    }
+
+    std::string message(int code) const override
+    {
+        const literal msg = literal_message(code);
+        return std::string(msg.data, msg.size);
+    }
+
+    literal literal_message(int code) const noexcept override
+    {
+        return code_message(static_cast<enum_t>(code));
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Get the std::error_category of a catalog.  It is a single
+ * static object named after the catalog's domain.
+ *
+ * @tparam enum_t enumeration of the catalog's codes
+ * @return the catalog's category
+ */
+template <typename enum_t, typename = std::enable_if_t<is_cataloged_v<enum_t>>>
+inline const std::error_category& catalog_category() noexcept
+{
+    static const detail::catalog_category<enum_t> category;
+    return category;
+}
+
+/**
+ * @brief Make a std::error_code from a catalog code.  Bring this into
+ * the enumeration's namespace with a using-declaration, and specialize
+ * std::is_error_code_enum, for std::error_code to convert implicitly.
+ *
+ * @param code catalog code
+ * @return std::error_code in the catalog's category
+ */
+template <typename enum_t, typename = std::enable_if_t<is_cataloged_v<enum_t>>>
+inline std::error_code make_error_code(enum_t code) noexcept
+{
+    return std::error_code(static_cast<int>(code), catalog_category<enum_t>());
+}
+#endif // #ifdef JACK_DETAIL_CPP17
+
+#ifdef JACK_ERROR_METRICS
+/**
+ * @brief Per-code error counts, enabled by defining JACK_ERROR_METRICS.
+ * Every error built with a code bumps a counter in a table owned by the
+ * calling thread, and every wrap or extend bumps another; no lock or
+ * shared atomic is touched.  collect() merges every thread's table into
+ * a snapshot on demand.
+ * 
+ * Each thread's table holds JACK_ERROR_METRICS_SLOTS codes; errors with
+ * codes beyond that are only counted in snapshot::dropped.  Timestamps
+ * come from a coarse clock (a few ms resolution on Linux).
+ */
+namespace metrics
+{
+
+/**
+ * @brief Counts for one code, merged across threads.
+ */
+struct code_stats
+{
+    /// @brief The code.
+    int code;
+
+    /// @brief Number of errors built with the code.
+    std::uint64_t created;
+
+    /// @brief Number of wraps & extends of errors with the code.
+    std::uint64_t propagated;
+
+    /// @brief When an error with the code was first built.
+    std::chrono::steady_clock::time_point first_seen;
+
+    /// @brief When an error with the code was last built.
+    std::chrono::steady_clock::time_point last_seen;
+
+    /// @brief A few distinct descriptions of errors with the code,
+    /// truncated to 95 characters.  Descriptions are sampled when a
+    /// thread's count reaches a power of two.
+    std::vector<std::string> samples;
+};
+
+/**
+ * @brief Counts for every code seen so far.  Take two snapshots to
+ * find rates, e.g. errors per second.
+ */
+struct snapshot
+{
+    /// @brief When the snapshot was taken.
+    std::chrono::steady_clock::time_point taken;
+
+    /// @brief Counts per code, in ascending order of code.
+    std::vector<code_stats> codes;
+
+    /// @brief Errors that weren't counted as their thread's table was
+    /// full.
+    std::uint64_t dropped = 0;
+
+    /**
+     * @brief Find the counts for a code.
+     * 
+     * @param code code to look up
+     * @return the code's counts, or null if it hasn't been seen
+     */
+    const code_stats* find(int code) const
+    {
+        const auto it = std::lower_bound(codes.begin(), codes.end(), code,
+                [](const code_stats& stats, int c) { return stats.code < c; });
+        return it != codes.end() && it->code == code ? &*it : nullptr;
+    }
+};
+
+} // namespace metrics
+
+namespace detail
+{
+
+/**
+ * @brief Read the metrics clock.
+ * 
+ * @return nanoseconds on the std::chrono::steady_clock timeline
+ */
+inline std::int64_t metrics_now() noexcept
+{
+#if defined(__linux__) && defined(CLOCK_MONOTONIC_COARSE)
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * @brief Counters for one code in one thread's table.  Only the owning
+ * thread writes them, with plain (relaxed) stores, so a count costs no
+ * locked instruction; collect() reads them with relaxed loads.
+ */
+struct alignas(64) metrics_slot
+{
+    std::atomic<bool> used{false};
+    std::atomic<int> code{0};
+    std::atomic<std::uint64_t> created{0};
+    std::atomic<std::uint64_t> propagated{0};
+    std::atomic<std::int64_t> first_seen{0};
+    std::atomic<std::int64_t> last_seen{0};
+};
+
+/**
+ * @brief A sampled description, written by the owning thread & read
+ * by collect() under a sequence lock.
+ */
+struct metrics_sample
+{
+    static constexpr std::size_t words = 12;
+
+    void write(const char* str) noexcept
+    {
+        std::uint64_t buf[words] = {};
+        std::size_t size = 0;
+        while (size < sizeof(buf) - 1 && str[size])
+        {
+            ++size;
+        }
+        std::memcpy(buf, str, size);
+
+        const std::uint32_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < words; ++i)
+        {
+            data[i].store(buf[i], std::memory_order_relaxed);
+        }
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    std::string read() const
+    {
+        std::uint64_t buf[words];
+        for (;;)
+        {
+            const std::uint32_t before = seq.load(std::memory_order_acquire);
+            if (before == 0)
+            {
+                return {};
+            }
+            for (std::size_t i = 0; i < words; ++i)
+            {
+                buf[i] = data[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (!(before & 1) && seq.load(std::memory_order_relaxed) == before)
+            {
+                return std::string(reinterpret_cast<const char*>(buf));
+            }
+        }
+    }
+
+    std::atomic<std::uint32_t> seq{0};
+    std::atomic<std::uint64_t> data[words];
+};
+
+/**
+ * @brief One thread's table of per-code counters, open addressed by
+ * code.
+ */
+class alignas(64) metrics_shard
+{
+  public:
+
+    static constexpr std::size_t slots = JACK_ERROR_METRICS_SLOTS;
+
+    static_assert(slots && !(slots & (slots - 1)),
+            "JACK_ERROR_METRICS_SLOTS must be a power of two");
+
+    /**
+     * @brief Find or add the slot of a code.  Owning thread only.
+     * 
+     * @param code code to look up
+     * @return index of the code's slot, or slots if the table is full
+     */
+    std::size_t find(int code) noexcept
+    {
+        std::size_t i = (static_cast<std::uint32_t>(code) * 0x9e3779b1u) &
+                (slots - 1);
+        for (std::size_t probe = 0; probe < slots; ++probe, i = (i + 1) & (slots - 1))
+        {
+            metrics_slot& slot = slots_[i];
+            if (!slot.used.load(std::memory_order_relaxed))
+            {
+                const std::int64_t now = metrics_now();
+                slot.code.store(code, std::memory_order_relaxed);
+                slot.first_seen.store(now, std::memory_order_relaxed);
+                slot.last_seen.store(now, std::memory_order_relaxed);
+                slot.used.store(true, std::memory_order_release);
+                return i;
+            }
+            if (slot.code.load(std::memory_order_relaxed) == code)
+            {
+                return i;
+            }
+        }
+        return slots;
+    }
+
+    /**
+     * @brief Count an error built with a code.  Owning thread only.
+     * 
+     * @param code error code
+     * @param message callable returning the error's description; only
+     * called when a description is sampled
+     */
+    template <typename message_t>
+    void created(int code, message_t&& message) noexcept
+    {
+        const std::size_t i = find(code);
+        if (JACK_DETAIL_UNLIKELY(i == slots))
+        {
+            bump(dropped_);
+            return;
+        }
+        metrics_slot& slot = slots_[i];
+        const std::uint64_t n = bump(slot.created);
+        slot.last_seen.store(metrics_now(), std::memory_order_relaxed);
+        if (JACK_DETAIL_UNLIKELY(!(n & (n - 1))))
+        {
+            try
+            {
+                samples_[i].write(message());
+            }
+            catch (...)
+            {
+                // a deferred description couldn't be formatted
+            }
+        }
+    }
+
+    /**
+     * @brief Count a wrap or extend of an error.  Owning thread only.
+     * 
+     * @param code error code
+     */
+    void propagated(int code) noexcept
+    {
+        const std::size_t i = find(code);
+        bump(i == slots ? dropped_ : slots_[i].propagated);
+    }
+
+    /**
+     * @brief Add this table's counts to a list of per-code counts.
+     * 
+     * @param out counts to add to, in any order
+     * @return number of errors dropped by this table
+     */
+    std::uint64_t collect(std::vector<metrics::code_stats>& out) const
+    {
+        for (std::size_t i = 0; i < slots; ++i)
+        {
+            const metrics_slot& slot = slots_[i];
+            if (!slot.used.load(std::memory_order_acquire))
+            {
+                continue;
+            }
+            metrics::code_stats stats;
+            stats.code = slot.code.load(std::memory_order_relaxed);
+            stats.created = slot.created.load(std::memory_order_relaxed);
+            stats.propagated = slot.propagated.load(std::memory_order_relaxed);
+            stats.first_seen = std::chrono::steady_clock::time_point(
+                    std::chrono::nanoseconds(slot.first_seen.load(
+                    std::memory_order_relaxed)));
+            stats.last_seen = std::chrono::steady_clock::time_point(
+                    std::chrono::nanoseconds(slot.last_seen.load(
+                    std::memory_order_relaxed)));
+            std::string sample = samples_[i].read();
+            if (!sample.empty())
+            {
+                stats.samples.push_back(std::move(sample));
+            }
+            out.push_back(std::move(stats));
+        }
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Whether a live thread owns this table.
+    bool in_use = false;
+
+  private:
+
+    static std::uint64_t bump(std::atomic<std::uint64_t>& counter) noexcept
+    {
+        const std::uint64_t n = counter.load(std::memory_order_relaxed) + 1;
+        counter.store(n, std::memory_order_relaxed);
+        return n;
+    }
+
+    metrics_slot slots_[slots];
+    metrics_sample samples_[slots];
+    std::atomic<std::uint64_t> dropped_{0};
+};
+
+/**
+ * @brief Every thread's table.  Tables outlive their threads so their
+ * counts aren't lost; a new thread reuses the table of one that exited.
+ */
+class metrics_registry
+{
+  public:
+
+    static metrics_registry& instance()
+    {
+        static metrics_registry registry;
+        return registry;
+    }
+
+    metrics_shard* acquire()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& shard : shards_)
+        {
+            if (!shard->in_use)
+            {
+                shard->in_use = true;
+                return shard.get();
+            }
+        }
+        shards_.emplace_back(new metrics_shard());
+        shards_.back()->in_use = true;
+        return shards_.back().get();
+    }
+
+    void release(metrics_shard* shard)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shard->in_use = false;
+    }
+
+    metrics::snapshot collect()
+    {
+        metrics::snapshot snap;
+        snap.taken = std::chrono::steady_clock::now();
+        std::vector<metrics::code_stats> all;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& shard : shards_)
+            {
+                snap.dropped += shard->collect(all);
+            }
+        }
+
+        std::sort(all.begin(), all.end(), [](const metrics::code_stats& a,
+                const metrics::code_stats& b) { return a.code < b.code; });
+        for (auto& stats : all)
+        {
+            if (snap.codes.empty() || snap.codes.back().code != stats.code)
+            {
+                snap.codes.push_back(std::move(stats));
+                continue;
+            }
+            metrics::code_stats& merged = snap.codes.back();
+            merged.created += stats.created;
+            merged.propagated += stats.propagated;
+            merged.first_seen = std::min(merged.first_seen, stats.first_seen);
+            merged.last_seen = std::max(merged.last_seen, stats.last_seen);
+            for (auto& sample : stats.samples)
+            {
+                if (merged.samples.size() < max_samples && std::find(
+                        merged.samples.begin(), merged.samples.end(),
+                        sample) == merged.samples.end())
+                {
+                    merged.samples.push_back(std::move(sample));
+                }
+            }
+        }
+        return snap;
+    }
+
+  private:
+
+    static constexpr std::size_t max_samples = 4;
+
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<metrics_shard>> shards_;
+};
+
+/**
+ * @brief Owns the calling thread's table for the thread's lifetime.
+ */
+class metrics_thread
+{
+  public:
+
+    metrics_thread() : shard_(metrics_registry::instance().acquire())
+    {
+    }
+
+    ~metrics_thread()
+    {
+        metrics_registry::instance().release(shard_);
+    }
+
+    metrics_thread(const metrics_thread&) = delete;
+    metrics_thread& operator=(const metrics_thread&) = delete;
+
+    metrics_shard& shard() noexcept
+    {
+        return *shard_;
+    }
+
+  private:
+
+    metrics_shard* shard_;
+};
+
+inline metrics_shard& metrics_local()
+{
+    thread_local metrics_thread thread;
+    return thread.shard();
+}
+
+/**
+ * @brief Count an error built with a code.  Called by error's
+ * constructors.
+ */
+template <typename alloc_t>
+inline void metrics_created(int code, const basic_reason<alloc_t>& desc) noexcept
+{
+    try
+    {
+        metrics_local().created(code, [&desc] { return desc.c_str(); });
+    }
+    catch (...)
+    {
+        // the first use on a thread couldn't allocate its table
+    }
+}
+
+/**
+ * @brief Count a wrap or extend of an error.  Called by error's wrap &
+ * extend.
+ */
+inline void metrics_propagated(int code) noexcept
+{
+    try
+    {
+        metrics_local().propagated(code);
+    }
+    catch (...)
+    {
+        // the first use on a thread couldn't allocate its table
+    }
+}
+
+} // namespace detail
+
+namespace metrics
+{
+
+/**
+ * @brief Merge every thread's counts.  Takes a lock shared only with
+ * threads counting their first error, never with counting itself.
+ * 
+ * @return counts per code
+ */
+inline snapshot collect()
+{
+    return detail::metrics_registry::instance().collect();
+}
+
+} // namespace metrics
+#endif // #ifdef JACK_ERROR_METRICS
+
+/**
+ * @brief A human-readable error description with a
+ * paired code for programmatic error handling. 
+ * 
+ * @tparam alloc_t allocator for the description (see basic_reason)
+ */
+template <typename alloc_t = std::allocator<char>>
+class basic_error
+{
+  public:
+
+    /// @brief Allocator used for the description's storage.
+    using allocator_type = alloc_t;
+
+    /// @brief Description type.
+    using reason_type = basic_reason<alloc_t>;
+
+    /// @brief String type that shares this error's allocator.
+    using string_type = typename reason_type::string_type;
+
+    /**
+     * @brief Prevent default error construction.
+     */
+    basic_error() = delete;
+
+    /**
+     * @brief Construct a new error object by moving from
+     * another error object.
+     * 
+     * @param other error to move from
+     */
+    basic_error(basic_error&& other) = default;
+    
+    /**
+     * @brief Construct a new error object by copying from
+     * another error object.
+     * 
+     * @param other error to copy from
+     */
+    basic_error(const basic_error& other) = default;
+
+    /**
+     * @brief Construct a new error object by moving from
+     * another error object, using the given allocator.
+     * 
+     * @param other error to move from
+     * @param alloc allocator for the new error
+     */
+    basic_error(basic_error&& other, const alloc_t& alloc) :
+            code(other.code), root_code_(other.root_code_),
+            desc(std::move(other.desc), alloc)
+    {
+    }
+
+    /**
+     * @brief Construct a new error object by copying from
+     * another error object, using the given allocator.
+     * 
+     * @param other error to copy from
+     * @param alloc allocator for the new error
+     */
+    basic_error(const basic_error& other, const alloc_t& alloc) :
+            code(other.code), root_code_(other.root_code_),
+            desc(other.desc, alloc)
+    {
+    }
+    
+    /**
+     * @brief Construct a new error object by accepting a 
+     * code and a reason object to copy from.
+     * 
+     * @param code error code
+     * @param reason reason to copy from
+     */
+    basic_error(int code, const reason_type& reason) :
+            code(code), desc(reason)
+    {
+        JACK_DETAIL_ERROR_CREATED(*this);
+    }
+
+    /**
+     * @brief Construct a new error object by accepting a 
+     * code and a reason object to move from.
+     * 
+     * @param code error code
+     * @param reason reason to move from
+     */
+    basic_error(int code, reason_type&& reason) :
+            code(code), desc(std::move(reason))
+    {
+        JACK_DETAIL_ERROR_CREATED(*this);
+    }
+    
+    /**
+     * @brief Construct a new error object by accepting a 
+     * code and a c string to copy from.
+     * 
+     * @param code error code
+     * @param reason c string to copy from
+     */
+    basic_error(int code, const char* reason) :
+            code(code), desc(reason)
+    {
+        JACK_DETAIL_ERROR_CREATED(*this);
+    }
+
+    /**
+     * @brief Construct a new error object by accepting a 
+     * code and a static string to refer to.  Nothing is allocated.
+     * 
+     * @param code error code
+     * @param reason static string to refer to
+     */
+    basic_error(int code, literal reason) noexcept(
+            std::is_nothrow_constructible<reason_type, literal>::value) :
+            code(code), desc(reason)
+    {
+        JACK_DETAIL_ERROR_CREATED(*this);
+    }
+
+#ifdef JACK_DETAIL_CPP17
+    /**
+     * @brief Construct a new error object from a catalog code (see
+     * code_catalog).  The description refers to the code's default
+     * message, so nothing is allocated.
+     * 
+     * @param code catalog code
+     * @param alloc allocator for any later wraps & extends
+     */
+    template <typename enum_t, typename = std::enable_if_t<
+            is_cataloged_v<enum_t>>>
+    basic_error(enum_t code, const alloc_t& alloc = alloc_t()) noexcept(
+            std::is_nothrow_copy_constructible<alloc_t>::value) :
+            code(static_cast<int>(code)), desc(code_message(code), alloc)
+    {
+        JACK_DETAIL_ERROR_CREATED(*this);
+    }
+
+    /**
+     * @brief Construct a new error object from a catalog code (see
+     * code_catalog) and the arguments of any reason constructor, in
+     * place of the code's default message.
+     * 
+     * @param code catalog code
+     * @param reason values to construct a reason from
+     */
+    template <typename enum_t, typename... str_args, typename =
+            std::enable_if_t<is_cataloged_v<enum_t> && (sizeof...(str_args) > 0) &&
+            !detail::any_of<std::is_same<std::decay_t<str_args>, alloc_t>...>::value>>
+    basic_error(enum_t code, str_args&&... reason) :
+            code(static_cast<int>(code)), desc(std::forward<str_args>(reason)...)
+    {
+        JACK_DETAIL_ERROR_CREATED(*this);
+    }
+
+    /**
+     * @brief Construct a new error object from a std::error_code.  The
+     * message of a catalog category (see code_catalog) is referred to
+     * without allocating; any other category's message is copied.
+     * 
+     * @param ec code & category to copy from
+     * @param alloc allocator for the new error
+     */
+    explicit basic_error(const std::error_code& ec,
+            const alloc_t& alloc = alloc_t()) :
+            code(ec.value()), desc(describe(ec, alloc))
+    {
+        JACK_DETAIL_ERROR_CREATED(*this);
+    }
+#endif
+
+    /**
+     * @brief Construct a new error object by accepting a 
+     * code and a string to copy from.
+     * 
+     * @param code error code
+     * @param reason string to copy from
+     */
+    basic_error(int code, const string_type& reason) :
+            code(code), desc(reason)
+    {
+        JACK_DETAIL_ERROR_CREATED(*this);
+    }
+    
+    /**
+     * @brief Construct a new error object by accepting a 
+     * code and a string to move from.
+     * 
+     * @param code error code
+     * @param reason string to move from
+     */
+    basic_error(int code, string_type&& reason) : 
+            code(code), desc(std::move(reason))
+    {
+        JACK_DETAIL_ERROR_CREATED(*this);
+    }
+    
+    /**
+     * @brief Construct a new error object from an arbitrary series
+     * of parameters (see detail::make_str).
+     * 
+     * @tparam str_args types of arguments used to construct the reason
+     * @param code error code
+     * @param reason values to construct a reason from
+     */
+    template <typename... str_args>
+    basic_error(int code, str_args&&... reason) :
+            code(code), desc(std::forward<str_args>(reason)...)
+    {
+        JACK_DETAIL_ERROR_CREATED(*this);
+    }
+
+    /**
+     * @brief Construct a new error object from a code and the
+     * arguments of any reason constructor, using the given allocator.
+     * 
+     * @tparam str_args types of arguments used to construct the reason
+     * @param alloc allocator for the new error
+     * @param code error code
+     * @param reason values to construct a reason from
+     */
+    template <typename... str_args>
+    basic_error(std::allocator_arg_t, const alloc_t& alloc, int code,
+            str_args&&... reason) : code(code),
+            desc(std::allocator_arg, alloc, std::forward<str_args>(reason)...)
+    {
+        JACK_DETAIL_ERROR_CREATED(*this);
+    }
+
+    /**
+     * @brief Construct a new error object whose reason is wrapped with a
+     * source location from the start.  Only the location is stored until
+     * the description is read.
+     * 
+     * @code
+     * return jack::error(jack::location::current(), 1001, "short read");
+     * @endcode
+     * 
+     * @tparam str_args types of arguments used to construct the reason
+     * @param where location to refer to
+     * @param code error code
+     * @param reason values to construct a reason from
+     */
+    template <typename... str_args>
+    basic_error(location where, int code, str_args&&... reason) :
+            code(code), desc(std::forward<str_args>(reason)...)
+    {
+        desc.wrap(where);
+        JACK_DETAIL_ERROR_CREATED(*this);
+    }
+
+    /**
+     * @brief Construct a new error object by copying from
+     * another error object, using the given allocator.
+     * 
+     * @param alloc allocator for the new error
+     * @param other error to copy from
+     */
+    basic_error(std::allocator_arg_t, const alloc_t& alloc,
+            const basic_error& other) : basic_error(other, alloc)
+    {
+    }
+
+    /**
+     * @brief Construct a new error object by moving from
+     * another error object, using the given allocator.
+     * 
+     * @param alloc allocator for the new error
+     * @param other error to move from
+     */
+    basic_error(std::allocator_arg_t, const alloc_t& alloc,
+            basic_error&& other) : basic_error(std::move(other), alloc)
+    {
+    }
+    
+    /**
+     * @brief Copy assignment operator.
+     * 
+     * @param other error to copy from
+     * @return reference to this error
+     */
+    basic_error& operator=(const basic_error& other) = default;
+
+    /**
+     * @brief Move assignment operator.
+     * 
+     * @param from error to move from
+     * @return reference to this error
+     */
+    basic_error& operator=(basic_error&& from) = default;
+
+    /**
+     * @brief Get the allocator used for the description's storage.
+     * 
+     * @return copy of the allocator
+     */
+    allocator_type get_allocator() const
+    {
+        return desc.get_allocator();
+    }
+
+    /**
+     * @brief Wrap this error's reason with additional context (prepend).
+     * 
+     * @param context values to construct a string from
+     */
+    template <typename... str_args>
+    basic_error& wrap(str_args&&... context)
+    {
+        desc.wrap(std::forward<str_args>(context)...);
+        JACK_DETAIL_ERROR_PROPAGATED(*this);
+        return *this;
+    }
+
+    /**
+     * @brief Extend this error's reason with additional information (append).
+     * 
+     * @param info values to construct a string from
+     */
+    template <typename... str_args>
+    basic_error& extend(str_args&&... info)
+    {
+        desc.extend(std::forward<str_args>(info)...);
+        JACK_DETAIL_ERROR_PROPAGATED(*this);
+        return *this;
+    }
+
+    /**
+     * @brief Wrap this error's reason with the location of the call
+     * (prepend).  Only the location is stored until the description is
+     * read.
+     * 
+     * @param where location to refer to; defaults to the caller's
+     */
+    basic_error& trace(location where = location::current())
+    {
+        desc.wrap(where);
+        JACK_DETAIL_ERROR_PROPAGATED(*this);
+        return *this;
+    }
+
+    /**
+     * @brief Bound how far this error's reason grows (see
+     * basic_reason::limit).
+     * 
+     * @param max_frames most contexts kept; 0 for no limit
+     * @param max_size most characters in the description; 0 for no limit
+     */
+    basic_error& limit(std::size_t max_frames, std::size_t max_size = 0)
+    {
+        desc.limit(max_frames, max_size);
+        return *this;
+    }
+
+    /**
+     * @brief Wrap this error's reason with additional context (prepend)
+     * and replace its code.  The context keeps the new code, and the
+     * code the error was created with stays available as root_code.
+     * 
+     * @param new_code code of the wrapping layer
+     * @param context values to construct a string from
+     */
+    template <typename... str_args>
+    basic_error& wrap_as(int new_code, str_args&&... context)
+    {
+        if (!desc.coded())
+        {
+            root_code_ = code;
+        }
+        desc.wrap_as(new_code, std::forward<str_args>(context)...);
+        code = new_code;
+        JACK_DETAIL_ERROR_PROPAGATED(*this);
+        return *this;
+    }
+
+    /**
+     * @brief Get the code of the root cause: the code before the first
+     * wrap_as, or the current code if there was none.
+     * 
+     * @return root cause code
+     */
+    int root_code() const noexcept
+    {
+        return desc.coded() ? root_code_ : code;
+    }
+
+    /// @brief Signed integer error code; the outermost one once the
+    /// error has been wrapped with wrap_as.
+    int code;
+
+  private:
+
+    /// @brief Code before the first wrap_as; kept beside code, where it
+    /// fits without making the error bigger.
+    int root_code_ = 0;
+
+  public:
+
+    /// @brief Human-readable error description.
+    reason_type desc;
+
+#ifdef JACK_DETAIL_CPP17
+  private:
+
+    static reason_type describe(const std::error_code& ec, const alloc_t& alloc)
+    {
+        if (const auto* category = dynamic_cast<
+                const detail::catalog_category_base*>(&ec.category()))
+        {
+            return reason_type(category->literal_message(ec.value()), alloc);
+        }
+        return reason_type(ec.message().c_str(), alloc);
+    }
+#endif
+};
+
+/**
+ * @brief A human-readable error description with a paired code,
+ * using std::allocator.
+ */
+using error = basic_error<>;
+
+#ifdef JACK_DETAIL_HAS_PMR
+namespace pmr
+{
+
+/**
+ * @brief A reason whose storage comes from a std::pmr::memory_resource,
+ * e.g. a std::pmr::monotonic_buffer_resource per request.
+ */
+using reason = basic_reason<std::pmr::polymorphic_allocator<char>>;
+
+/**
+ * @brief An error whose storage comes from a std::pmr::memory_resource.
+ */
+using error = basic_error<std::pmr::polymorphic_allocator<char>>;
+
+} // namespace pmr
+#endif
+
+/**
+ * @brief A defaultable error the size of a single pointer.  While I
+ * recommend using the error classes with std::optional (C++17) & 
+ * std::expected (C++23) or non-std implementations like those of
+ * Sy Brand (https://github.com/TartanLlama; C++11/14/17), a
+ * std::optional<error> is several words wide and is returned through
+ * memory.  A default constructed derror represents success and is just a
+ * null pointer; the code & reason of a failure live in a separately
+ * allocated error that is only created (out of line) when something
+ * goes wrong.  It evaluates to true in an explicit boolean conversion
+ * when it holds an error.
+ * 
+ * @code
+ * jack::derror foo_may_fail()
+ * {
+ *     if (std::rand() % 2) return {1001, "rand was odd"};
+ *     return {};
+ * }
+ * @endcode
+ */
+class JACK_DETAIL_TRIVIAL_ABI derror
+{
+  public:
+
+    /**
+     * @brief Construct a derror representing success.
+     */
+    derror() noexcept = default;
+
+    /**
+     * @brief Construct a new derror object by moving from
+     * another derror object.
+     * 
+     * @param other derror to move from
+     */
+    derror(derror&& other) noexcept : err_(other.err_)
+    {
+        other.err_ = nullptr;
+    }
+
+    /**
+     * @brief Construct a new derror object by copying from
+     * another derror object.
+     * 
+     * @param other derror to copy from
+     */
+    derror(const derror& other) :
+            err_(other.err_ ? make(*other.err_) : nullptr)
+    {
+    }
+
+    /**
+     * @brief Construct a new derror object by copying from
+     * an error object.
+     * 
+     * @param err error to copy from
+     */
+    derror(const error& err) : err_(make(err))
+    {
+    }
+
+    /**
+     * @brief Construct a new derror object by moving from
+     * an error object.
+     * 
+     * @param err error to move from
+     */
+    derror(error&& err) : err_(make(std::move(err)))
+    {
+    }
+
+    /**
+     * @brief Construct a new derror object holding an error built
+     * from a code and the arguments of any error constructor.
+     * 
+     * @param code error code
+     * @param reason values to construct a reason from
+     */
+    template <typename... str_args>
+    derror(int code, str_args&&... reason) :
+            err_(make(code, std::forward<str_args>(reason)...))
+    {
+    }
+
+    ~derror()
+    {
+        if (JACK_DETAIL_UNLIKELY(err_))
+        {
+            destroy(err_);
+        }
+    }
+
+    /**
+     * @brief Copy assignment operator.
+     * 
+     * @param other derror to copy from
+     * @return reference to this derror
+     */
+    derror& operator=(const derror& other)
+    {
+        if (this != &other)
+        {
+            *this = derror(other);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Move assignment operator.
+     * 
+     * @param from derror to move from
+     * @return reference to this derror
+     */
+    derror& operator=(derror&& from) noexcept
+    {
+        std::swap(err_, from.err_);
+        return *this;
+    }
+
+    /**
+     * @brief Check for failure.
+     * 
+     * @return true if this derror holds an error
+     */
+    explicit operator bool() const noexcept
+    {
+        return err_ != nullptr;
+    }
+
+    /**
+     * @brief Access the held error.  Must only be called on failure.
+     * 
+     * @return reference to the held error
+     */
+    error& operator*() noexcept
+    {
+        return *err_;
+    }
+
+    /**
+     * @brief Access the held error.  Must only be called on failure.
+     * 
+     * @return reference to the held error
+     */
+    const error& operator*() const noexcept
+    {
+        return *err_;
+    }
+
+    /**
+     * @brief Access the held error.  Must only be called on failure.
+     * 
+     * @return pointer to the held error
+     */
+    error* operator->() noexcept
+    {
+        return err_;
+    }
+
+    /**
+     * @brief Access the held error.  Must only be called on failure.
+     * 
+     * @return pointer to the held error
+     */
+    const error* operator->() const noexcept
+    {
+        return err_;
+    }
+
+    /**
+     * @brief Wrap the held error's reason with additional context
+     * (prepend).  Must only be called on failure.
+     * 
+     * @param context values to construct a string from
+     * @return reference to this derror
+     */
+    template <typename... str_args>
+    derror& wrap(str_args&&... context)
+    {
+        err_->wrap(std::forward<str_args>(context)...);
+        return *this;
+    }
+
+    /**
+     * @brief Extend the held error's reason with additional information
+     * (append).  Must only be called on failure.
+     * 
+     * @param info values to construct a string from
+     * @return reference to this derror
+     */
+    template <typename... str_args>
+    derror& extend(str_args&&... info)
+    {
+        err_->extend(std::forward<str_args>(info)...);
+        return *this;
+    }
+
+    /**
+     * @brief Wrap the held error's reason with the location of the call
+     * (prepend).  Must only be called on failure.
+     * 
+     * @param where location to refer to; defaults to the caller's
+     * @return reference to this derror
+     */
+    derror& trace(location where = location::current())
+    {
+        err_->trace(where);
+        return *this;
+    }
+
+    /**
+     * @brief Wrap the held error's reason with context that carries a
+     * new code, & replace the error's code (see basic_error::wrap_as).
+     * Must only be called on failure.
+     * 
+     * @param new_code code of the wrapping layer
+     * @param context values to construct a string from
+     * @return reference to this derror
+     */
+    template <typename... str_args>
+    derror& wrap_as(int new_code, str_args&&... context)
+    {
+        err_->wrap_as(new_code, std::forward<str_args>(context)...);
+        return *this;
+    }
+
+  private:
+
+    template <typename... args_t>
+    JACK_DETAIL_COLD static error* make(args_t&&... args)
+    {
+        return new error(std::forward<args_t>(args)...);
+    }
+
+    JACK_DETAIL_COLD static void destroy(error* err) noexcept
+    {
+        delete err;
+    }
+
+    /// @brief Held error; null on success.
+    error* err_ = nullptr;
+};
+
+namespace detail
+{
+
+/// @brief Whether u is one of the failures a result is constructed from.
+template <typename u>
+struct is_failure : std::integral_constant<bool,
+        std::is_same<u, error>::value || std::is_same<u, derror>::value>
+{
+};
+
+} // namespace detail
+
+/**
+ * @brief A value or an error, for functions that return something when
+ * they succeed.  std::variant<t, error> & std::expected<t, error> are as
+ * wide as an error, which is copied through every return; a result
+ * holds its value next to a derror & a tag.  A failure's code & reason
+ * are allocated out of line (& cold) when it is created, and passing it
+ * up a call chain, through and_then or failure(), moves a pointer.
+ *
+ * The combinators & wrap/extend forward to the held error without
+ * copying it, so a layer adds its context on the way up:
+ *
+ * @code
+ * jack::result<config> load(const std::string& path)
+ * {
+ *     return read_file(path)
+ *         .and_then(parse_config)
+ *         .wrap("loading ", path);
+ * }
+ * @endcode
+ *
+ * @tparam t type of the value; result<void> holds no value
+ */
+template <typename t>
+class result
+{
+  public:
+
+    /// @brief Type of the held value.
+    using value_type = t;
+
+    /**
+     * @brief Construct a result holding a value.
+     *
+     * @param value value to hold, or to construct it from
+     */
+    template <typename u = t, typename = typename std::enable_if<
+            std::is_convertible<u&&, t>::value &&
+            !std::is_same<typename std::decay<u>::type, result>::value &&
+            !detail::is_failure<typename std::decay<u>::type>::value>::type>
+    result(u&& value) : value_(std::forward<u>(value)), ok_(true)
+    {
+    }
+
+    /**
+     * @brief Construct a failed result by copying an error.
+     *
+     * @param err error to copy from
+     */
+    result(const jack::error& err) : err_(err), ok_(false)
+    {
+    }
+
+    /**
+     * @brief Construct a failed result by moving from an error.
+     *
+     * @param err error to move from
+     */
+    result(jack::error&& err) : err_(std::move(err)), ok_(false)
+    {
+    }
+
+    /**
+     * @brief Construct a failed result by taking the error of a derror,
+     * e.g. the failure() of a result of another type.  The derror must
+     * hold an error.
+     *
+     * @param err derror to move from
+     */
+    result(derror&& err) noexcept : err_(std::move(err)), ok_(false)
+    {
+    }
+
+    /**
+     * @brief Construct a new result object by copying from another
+     * result object.
+     *
+     * @param other result to copy from
+     */
+    result(const result& other) : ok_(other.ok_)
+    {
+        if (ok_)
+        {
+            ::new (static_cast<void*>(&value_)) t(other.value_);
+        }
+        else
+        {
+            ::new (static_cast<void*>(&err_)) derror(other.err_);
+        }
+    }
+
+    /**
+     * @brief Construct a new result object by moving from another
+     * result object.
+     *
+     * @param other result to move from
+     */
+    result(result&& other) noexcept(
+            std::is_nothrow_move_constructible<t>::value) : ok_(other.ok_)
+    {
+        if (ok_)
+        {
+            ::new (static_cast<void*>(&value_)) t(std::move(other.value_));
+        }
+        else
+        {
+            ::new (static_cast<void*>(&err_)) derror(std::move(other.err_));
+        }
+    }
+
+    ~result()
+    {
+        destroy();
+    }
+
+    /**
+     * @brief Copy assignment operator.
+     *
+     * @param other result to copy from
+     * @return reference to this result
+     */
+    result& operator=(const result& other)
+    {
+        if (this != &other)
+        {
+            *this = result(other);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Move assignment operator.  Replacing an error with a value
+     * needs t's move constructor not to throw.
+     *
+     * @param other result to move from
+     * @return reference to this result
+     */
+    result& operator=(result&& other) noexcept(
+            std::is_nothrow_move_constructible<t>::value &&
+            std::is_nothrow_move_assignable<t>::value)
+    {
+        static_assert(std::is_nothrow_move_constructible<t>::value,
+                "jack::result<t> assignment needs a noexcept move constructor");
+        if (ok_ && other.ok_)
+        {
+            value_ = std::move(other.value_);
+        }
+        else if (!ok_ && !other.ok_)
+        {
+            err_ = std::move(other.err_);
+        }
+        else if (this != &other)
+        {
+            destroy();
+            ok_ = other.ok_;
+            if (ok_)
+            {
+                ::new (static_cast<void*>(&value_)) t(std::move(other.value_));
+            }
+            else
+            {
+                ::new (static_cast<void*>(&err_)) derror(std::move(other.err_));
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Check for success.
+     *
+     * @return true if this result holds a value
+     */
+    bool has_value() const noexcept
+    {
+        return ok_;
+    }
+
+    /**
+     * @brief Check for success.  Note that a derror is the opposite:
+     * it converts to true when it holds an error.
+     *
+     * @return true if this result holds a value
+     */
+    explicit operator bool() const noexcept
+    {
+        return ok_;
+    }
+
+    /**
+     * @brief Access the held value.  Must only be called on success.
+     *
+     * @return reference to the held value
+     */
+    t& value() & noexcept
+    {
+        return value_;
+    }
+
+    /**
+     * @brief Access the held value.  Must only be called on success.
+     *
+     * @return reference to the held value
+     */
+    const t& value() const& noexcept
+    {
+        return value_;
+    }
+
+    /**
+     * @brief Access the held value.  Must only be called on success.
+     *
+     * @return rvalue reference to the held value
+     */
+    t&& value() && noexcept
+    {
+        return std::move(value_);
+    }
+
+    /**
+     * @brief Access the held value.  Must only be called on success.
+     *
+     * @return reference to the held value
+     */
+    t& operator*() & noexcept
+    {
+        return value_;
+    }
+
+    /**
+     * @brief Access the held value.  Must only be called on success.
+     *
+     * @return reference to the held value
+     */
+    const t& operator*() const& noexcept
+    {
+        return value_;
+    }
+
+    /**
+     * @brief Access the held value.  Must only be called on success.
+     *
+     * @return rvalue reference to the held value
+     */
+    t&& operator*() && noexcept
+    {
+        return std::move(value_);
+    }
+
+    /**
+     * @brief Access the held value.  Must only be called on success.
+     *
+     * @return pointer to the held value
+     */
+    t* operator->() noexcept
+    {
+        return &value_;
+    }
+
+    /**
+     * @brief Access the held value.  Must only be called on success.
+     *
+     * @return pointer to the held value
+     */
+    const t* operator->() const noexcept
+    {
+        return &value_;
+    }
+
+    /**
+     * @brief Get the held value, or another on failure.
+     *
+     * @param other value to return on failure
+     * @return copy of the held value or other
+     */
+    template <typename u>
+    t value_or(u&& other) const&
+    {
+        return ok_ ? value_ : static_cast<t>(std::forward<u>(other));
+    }
+
+    /**
+     * @brief Get the held value, or another on failure.
+     *
+     * @param other value to return on failure
+     * @return the held value, moved, or other
+     */
+    template <typename u>
+    t value_or(u&& other) &&
+    {
+        return ok_ ? std::move(value_) : static_cast<t>(std::forward<u>(other));
+    }
+
+    /**
+     * @brief Access the held error.  Must only be called on failure.
+     *
+     * @return reference to the held error
+     */
+    jack::error& error() noexcept
+    {
+        return *err_;
+    }
+
+    /**
+     * @brief Access the held error.  Must only be called on failure.
+     *
+     * @return reference to the held error
+     */
+    const jack::error& error() const noexcept
+    {
+        return *err_;
+    }
+
+    /**
+     * @brief Access the derror that holds the error, to pass it to a
+     * result of another type: return std::move(r).failure();
+     * Must only be called on failure.
+     *
+     * @return reference to the held derror
+     */
+    derror& failure() & noexcept
+    {
+        return err_;
+    }
+
+    /**
+     * @brief Access the derror that holds the error, to pass it to a
+     * result of another type: return std::move(r).failure();
+     * Must only be called on failure.
+     *
+     * @return rvalue reference to the held derror
+     */
+    derror&& failure() && noexcept
+    {
+        return std::move(err_);
+    }
+
+    /**
+     * @brief Call fn with the held value, or pass the error along.
+     *
+     * @param fn callable taking t&& & returning a jack::result
+     * @return fn's result, or one holding this result's error
+     */
+    template <typename fn_t>
+    auto and_then(fn_t&& fn) &&
+            -> decltype(std::forward<fn_t>(fn)(std::declval<t&&>()))
+    {
+        using next_t = decltype(std::forward<fn_t>(fn)(std::declval<t&&>()));
+        if (JACK_DETAIL_UNLIKELY(!ok_))
+        {
+            return next_t(std::move(err_));
+        }
+        return std::forward<fn_t>(fn)(std::move(value_));
+    }
+
+    /**
+     * @brief Call fn with the held value, or pass a copy of the error
+     * along.
+     *
+     * @param fn callable taking const t& & returning a jack::result
+     * @return fn's result, or one holding this result's error
+     */
+    template <typename fn_t>
+    auto and_then(fn_t&& fn) const&
+            -> decltype(std::forward<fn_t>(fn)(std::declval<const t&>()))
+    {
+        using next_t = decltype(std::forward<fn_t>(fn)(std::declval<const t&>()));
+        if (JACK_DETAIL_UNLIKELY(!ok_))
+        {
+            return next_t(derror(err_));
+        }
+        return std::forward<fn_t>(fn)(value_);
+    }
+
+    /**
+     * @brief Call fn with the held error to recover from it, or pass
+     * the value along.  To add context instead, use map_error or wrap.
+     *
+     * @param fn callable taking jack::error& & returning a result<t>
+     * @return fn's result, or this result
+     */
+    template <typename fn_t>
+    result or_else(fn_t&& fn) &&
+    {
+        if (JACK_DETAIL_UNLIKELY(!ok_))
+        {
+            return std::forward<fn_t>(fn)(*err_);
+        }
+        return std::move(*this);
+    }
+
+    /**
+     * @brief Call fn with the held error to recover from it, or pass
+     * a copy of the value along.
+     *
+     * @param fn callable taking const jack::error& & returning a result<t>
+     * @return fn's result, or a copy of this result
+     */
+    template <typename fn_t>
+    result or_else(fn_t&& fn) const&
+    {
+        if (JACK_DETAIL_UNLIKELY(!ok_))
+        {
+            return std::forward<fn_t>(fn)(static_cast<const jack::error&>(*err_));
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Call fn on the held error, where it is, if there is one.
+     *
+     * @param fn callable taking jack::error&
+     * @return reference to this result
+     */
+    template <typename fn_t>
+    result& map_error(fn_t&& fn) &
+    {
+        if (JACK_DETAIL_UNLIKELY(!ok_))
+        {
+            std::forward<fn_t>(fn)(*err_);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Call fn on the held error, where it is, if there is one.
+     *
+     * @param fn callable taking jack::error&
+     * @return rvalue reference to this result
+     */
+    template <typename fn_t>
+    result&& map_error(fn_t&& fn) &&
+    {
+        return std::move(map_error(std::forward<fn_t>(fn)));
+    }
+
+    /**
+     * @brief Wrap the held error's reason with additional context
+     * (prepend), if there is one.
+     *
+     * @param context values to construct a string from
+     * @return reference to this result
+     */
+    template <typename... str_args>
+    result& wrap(str_args&&... context) &
+    {
+        if (JACK_DETAIL_UNLIKELY(!ok_))
+        {
+            err_.wrap(std::forward<str_args>(context)...);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Wrap the held error's reason with additional context
+     * (prepend), if there is one.
+     *
+     * @param context values to construct a string from
+     * @return rvalue reference to this result
+     */
+    template <typename... str_args>
+    result&& wrap(str_args&&... context) &&
+    {
+        return std::move(wrap(std::forward<str_args>(context)...));
+    }
+
+    /**
+     * @brief Extend the held error's reason with additional information
+     * (append), if there is one.
+     *
+     * @param info values to construct a string from
+     * @return reference to this result
+     */
+    template <typename... str_args>
+    result& extend(str_args&&... info) &
+    {
+        if (JACK_DETAIL_UNLIKELY(!ok_))
+        {
+            err_.extend(std::forward<str_args>(info)...);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Extend the held error's reason with additional information
+     * (append), if there is one.
+     *
+     * @param info values to construct a string from
+     * @return rvalue reference to this result
+     */
+    template <typename... str_args>
+    result&& extend(str_args&&... info) &&
+    {
+        return std::move(extend(std::forward<str_args>(info)...));
+    }
+
+    /**
+     * @brief Wrap the held error's reason with the location of the call
+     * (prepend), if there is one.
+     *
+     * @param where location to refer to; defaults to the caller's
+     * @return reference to this result
+     */
+    result& trace(location where = location::current()) &
+    {
+        if (JACK_DETAIL_UNLIKELY(!ok_))
+        {
+            err_.trace(where);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Wrap the held error's reason with the location of the call
+     * (prepend), if there is one.
+     *
+     * @param where location to refer to; defaults to the caller's
+     * @return rvalue reference to this result
+     */
+    result&& trace(location where = location::current()) &&
+    {
+        return std::move(trace(where));
+    }
+
+    /**
+     * @brief Wrap the held error's reason with context that carries a
+     * new code, & replace the error's code (see basic_error::wrap_as),
+     * if there is one.
+     *
+     * @param new_code code of the wrapping layer
+     * @param context values to construct a string from
+     * @return reference to this result
+     */
+    template <typename... str_args>
+    result& wrap_as(int new_code, str_args&&... context) &
+    {
+        if (JACK_DETAIL_UNLIKELY(!ok_))
+        {
+            err_.wrap_as(new_code, std::forward<str_args>(context)...);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Wrap the held error's reason with context that carries a
+     * new code, & replace the error's code (see basic_error::wrap_as),
+     * if there is one.
+     *
+     * @param new_code code of the wrapping layer
+     * @param context values to construct a string from
+     * @return rvalue reference to this result
+     */
+    template <typename... str_args>
+    result&& wrap_as(int new_code, str_args&&... context) &&
+    {
+        return std::move(wrap_as(new_code, std::forward<str_args>(context)...));
+    }
+
+  private:
+
+    void destroy() noexcept
+    {
+        if (ok_)
+        {
+            value_.~t();
+        }
+        else
+        {
+            err_.~derror();
+        }
+    }
+
+    union
+    {
+        /// @brief Held value, on success.
+        t value_;
+
+        /// @brief Held error, on failure.
+        derror err_;
+    };
+
+    /// @brief Whether value_ is the member in use.
+    bool ok_;
+};
+
+/**
+ * @brief A success or an error, for functions that return nothing when
+ * they succeed.  It is a derror with the combinators of result<t>, &
+ * the opposite boolean conversion: true on success.
+ */
+template <>
+class result<void>
+{
+  public:
+
+    /// @brief Type of the held value.
+    using value_type = void;
+
+    /**
+     * @brief Construct a result representing success.
+     */
+    result() noexcept = default;
+
+    /**
+     * @brief Construct a failed result by copying an error.
+     *
+     * @param err error to copy from
+     */
+    result(const jack::error& err) : err_(err)
+    {
+    }
+
+    /**
+     * @brief Construct a failed result by moving from an error.
+     *
+     * @param err error to move from
+     */
+    result(jack::error&& err) : err_(std::move(err))
+    {
+    }
+
+    /**
+     * @brief Construct a result by taking the error of a derror; an
+     * empty derror is success.
+     *
+     * @param err derror to move from
+     */
+    result(derror&& err) noexcept : err_(std::move(err))
+    {
+    }
+
+    /**
+     * @brief Check for success.
+     *
+     * @return true if this result holds no error
+     */
+    bool has_value() const noexcept
+    {
+        return !err_;
+    }
+
+    /**
+     * @brief Check for success.  Note that a derror is the opposite:
+     * it converts to true when it holds an error.
+     *
+     * @return true if this result holds no error
+     */
+    explicit operator bool() const noexcept
+    {
+        return !err_;
+    }
+
+    /**
+     * @brief Access the held error.  Must only be called on failure.
+     *
+     * @return reference to the held error
+     */
+    jack::error& error() noexcept
+    {
+        return *err_;
+    }
+
+    /**
+     * @brief Access the held error.  Must only be called on failure.
+     *
+     * @return reference to the held error
+     */
+    const jack::error& error() const noexcept
+    {
+        return *err_;
+    }
+
+    /**
+     * @brief Access the derror that holds the error, if any.
+     *
+     * @return reference to the held derror
+     */
+    derror& failure() & noexcept
+    {
+        return err_;
+    }
+
+    /**
+     * @brief Access the derror that holds the error, if any, to pass
+     * it to a result of another type: return std::move(r).failure();
+     *
+     * @return rvalue reference to the held derror
+     */
+    derror&& failure() && noexcept
+    {
+        return std::move(err_);
+    }
+
+    /**
+     * @brief Call fn on success, or pass the error along.
+     *
+     * @param fn callable taking no arguments & returning a jack::result
+     * @return fn's result, or one holding this result's error
+     */
+    template <typename fn_t>
+    auto and_then(fn_t&& fn) && -> decltype(std::forward<fn_t>(fn)())
+    {
+        using next_t = decltype(std::forward<fn_t>(fn)());
+        if (JACK_DETAIL_UNLIKELY(static_cast<bool>(err_)))
+        {
+            return next_t(std::move(err_));
+        }
+        return std::forward<fn_t>(fn)();
+    }
+
+    /**
+     * @brief Call fn on success, or pass a copy of the error along.
+     *
+     * @param fn callable taking no arguments & returning a jack::result
+     * @return fn's result, or one holding this result's error
+     */
+    template <typename fn_t>
+    auto and_then(fn_t&& fn) const& -> decltype(std::forward<fn_t>(fn)())
+    {
+        using next_t = decltype(std::forward<fn_t>(fn)());
+        if (JACK_DETAIL_UNLIKELY(static_cast<bool>(err_)))
+        {
+            return next_t(derror(err_));
+        }
+        return std::forward<fn_t>(fn)();
+    }
+
+    /**
+     * @brief Call fn with the held error to recover from it.  To add
+     * context instead, use map_error or wrap.
+     *
+     * @param fn callable taking jack::error& & returning a result<void>
+     * @return fn's result, or this result
+     */
+    template <typename fn_t>
+    result or_else(fn_t&& fn) &&
+    {
+        if (JACK_DETAIL_UNLIKELY(static_cast<bool>(err_)))
+        {
+            return std::forward<fn_t>(fn)(*err_);
+        }
+        return std::move(*this);
+    }
+
+    /**
+     * @brief Call fn with the held error to recover from it.
+     *
+     * @param fn callable taking const jack::error& & returning a
+     * result<void>
+     * @return fn's result, or a copy of this result
+     */
+    template <typename fn_t>
+    result or_else(fn_t&& fn) const&
+    {
+        if (JACK_DETAIL_UNLIKELY(static_cast<bool>(err_)))
+        {
+            return std::forward<fn_t>(fn)(static_cast<const jack::error&>(*err_));
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Call fn on the held error, where it is, if there is one.
+     *
+     * @param fn callable taking jack::error&
+     * @return reference to this result
+     */
+    template <typename fn_t>
+    result& map_error(fn_t&& fn) &
+    {
+        if (JACK_DETAIL_UNLIKELY(static_cast<bool>(err_)))
+        {
+            std::forward<fn_t>(fn)(*err_);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Call fn on the held error, where it is, if there is one.
+     *
+     * @param fn callable taking jack::error&
+     * @return rvalue reference to this result
+     */
+    template <typename fn_t>
+    result&& map_error(fn_t&& fn) &&
+    {
+        return std::move(map_error(std::forward<fn_t>(fn)));
+    }
+
+    /**
+     * @brief Wrap the held error's reason with additional context
+     * (prepend), if there is one.
+     *
+     * @param context values to construct a string from
+     * @return reference to this result
+     */
+    template <typename... str_args>
+    result& wrap(str_args&&... context) &
+    {
+        if (JACK_DETAIL_UNLIKELY(static_cast<bool>(err_)))
+        {
+            err_.wrap(std::forward<str_args>(context)...);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Wrap the held error's reason with additional context
+     * (prepend), if there is one.
+     *
+     * @param context values to construct a string from
+     * @return rvalue reference to this result
+     */
+    template <typename... str_args>
+    result&& wrap(str_args&&... context) &&
+    {
+        return std::move(wrap(std::forward<str_args>(context)...));
+    }
+
+    /**
+     * @brief Extend the held error's reason with additional information
+     * (append), if there is one.
+     *
+     * @param info values to construct a string from
+     * @return reference to this result
+     */
+    template <typename... str_args>
+    result& extend(str_args&&... info) &
+    {
+        if (JACK_DETAIL_UNLIKELY(static_cast<bool>(err_)))
+        {
+            err_.extend(std::forward<str_args>(info)...);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Extend the held error's reason with additional information
+     * (append), if there is one.
+     *
+     * @param info values to construct a string from
+     * @return rvalue reference to this result
+     */
+    template <typename... str_args>
+    result&& extend(str_args&&... info) &&
+    {
+        return std::move(extend(std::forward<str_args>(info)...));
+    }
+
+    /**
+     * @brief Wrap the held error's reason with the location of the call
+     * (prepend), if there is one.
+     *
+     * @param where location to refer to; defaults to the caller's
+     * @return reference to this result
+     */
+    result& trace(location where = location::current()) &
+    {
+        if (JACK_DETAIL_UNLIKELY(static_cast<bool>(err_)))
+        {
+            err_.trace(where);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Wrap the held error's reason with the location of the call
+     * (prepend), if there is one.
+     *
+     * @param where location to refer to; defaults to the caller's
+     * @return rvalue reference to this result
+     */
+    result&& trace(location where = location::current()) &&
+    {
+        return std::move(trace(where));
+    }
+
+    /**
+     * @brief Wrap the held error's reason with context that carries a
+     * new code, & replace the error's code (see basic_error::wrap_as),
+     * if there is one.
+     *
+     * @param new_code code of the wrapping layer
+     * @param context values to construct a string from
+     * @return reference to this result
+     */
+    template <typename... str_args>
+    result& wrap_as(int new_code, str_args&&... context) &
+    {
+        if (JACK_DETAIL_UNLIKELY(static_cast<bool>(err_)))
+        {
+            err_.wrap_as(new_code, std::forward<str_args>(context)...);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Wrap the held error's reason with context that carries a
+     * new code, & replace the error's code (see basic_error::wrap_as),
+     * if there is one.
+     *
+     * @param new_code code of the wrapping layer
+     * @param context values to construct a string from
+     * @return rvalue reference to this result
+     */
+    template <typename... str_args>
+    result&& wrap_as(int new_code, str_args&&... context) &&
+    {
+        return std::move(wrap_as(new_code, std::forward<str_args>(context)...));
+    }
+
+  private:
+
+    /// @brief Held error; empty on success.
+    derror err_;
+};
+
+namespace detail
+{
+
+/**
+ * @brief Access to a reason's frames for code that walks them without
+ * rendering the description, such as the wire encoding.
+ */
+struct reason_access
+{
+    /**
+     * @brief Copy the full description, from the rendered cache when
+     * there is one.
+     */
+    template <typename alloc_t, std::size_t n>
+    static char* write(const basic_reason<alloc_t, n>& reason, char* out)
+    {
+        if (const char* flat = reason.rendered())
+        {
+            const std::size_t size = reason.size();
+            std::memcpy(out, flat, size);
+            return out + size;
+        }
+        reason.for_each_piece([&out](const char* data, std::size_t size) {
+            std::memcpy(out, data, size);
+            out += size;
+        });
+        return out;
+    }
+
+    /**
+     * @brief Visit (data, size) of each piece of the full description in
+     * order, or just the rendered cache when there is one.
+     */
+    template <typename alloc_t, std::size_t n, typename visitor_t>
+    static void for_each_piece(const basic_reason<alloc_t, n>& reason,
+            visitor_t&& visit)
+    {
+        // the pieces of located frames are temporary, so those reasons
+        // are rendered first
+        bool located = reason.elided() != 0;
+        for (const auto& f : reason.frames_)
+        {
+            located = located || f.located;
+        }
+        if (located || reason.rendered())
+        {
+            visit(reason.c_str(), reason.size());
+            return;
+        }
+        reason.for_each_piece(visit);
+    }
+
+    /**
+     * @brief Visit the pieces of the description without rendering it,
+     * unless it already is.  The pieces of located frames & elided
+     * markers that are only valid during the visit are line numbers &
+     * counts, of at most line_digits characters.
+     */
+    template <typename alloc_t, std::size_t n, typename visitor_t>
+    static void for_each_raw_piece(const basic_reason<alloc_t, n>& reason,
+            visitor_t&& visit)
+    {
+        if (reason.rendered())
+        {
+            visit(reason.c_str(), reason.size());
+            return;
+        }
+        reason.for_each_piece(visit);
+    }
+
+    /**
+     * @brief Get the root message, formatting deferred arguments if
+     * needed.  The result is only null-terminated when the reason has no
+     * frames or its root is a literal.
+     */
+    template <typename alloc_t, std::size_t n>
+    static literal root(const basic_reason<alloc_t, n>& reason)
+    {
+        const literal r = reason.root();
+        if (r.data)
+        {
+            return r;
+        }
+        return literal(reason.text_.data(), reason.root_size());
+    }
+
+    /**
+     * @brief Visit (data, size, is wrap) of each frame in arrival order.
+     */
+    template <typename alloc_t, std::size_t n, typename visitor_t>
+    static void for_each_context(const basic_reason<alloc_t, n>& reason,
+            visitor_t&& visit)
+    {
+        using frame = typename basic_reason<alloc_t, n>::frame;
+
+        const char* base = reason.text_.data();
+        typename basic_reason<alloc_t, n>::string_type text(reason.get_allocator());
+        auto append = [&text](const char* data, std::size_t size) {
+            text.append(data, size);
+        };
+        reason.for_each_kept([&](const frame& f) {
+            const bool wrap = f.role == frame::wrap;
+            if (!f.located)
+            {
+                visit(base + f.offset, f.size, wrap);
+                return;
+            }
+            text.clear();
+            reason.visit_frame(f, append);
+            visit(text.data(), text.size(), wrap);
+        }, [&](typename frame::kind role) {
+            text.clear();
+            reason.visit_marker(role, append);
+            visit(text.data(), text.size(), role == frame::wrap);
+        });
+    }
+
+    /**
+     * @brief Visit (size, is wrap) of each frame in arrival order.
+     */
+    template <typename alloc_t, std::size_t n, typename visitor_t>
+    static void for_each_frame(const basic_reason<alloc_t, n>& reason,
+            visitor_t&& visit)
+    {
+        using frame = typename basic_reason<alloc_t, n>::frame;
+
+        reason.for_each_kept([&](const frame& f) {
+            visit(reason.frame_size(f), f.role == frame::wrap);
+        }, [&](typename frame::kind role) {
+            visit(reason.marker_size(role) - 2, role == frame::wrap);
+        });
+    }
+
+    template <typename alloc_t, std::size_t n>
+    static std::size_t frame_count(const basic_reason<alloc_t, n>& reason)
+    {
+        return reason.frames_.size() -
+                (reason.limits_.first_kept - reason.limits_.head) +
+                (reason.limits_.elided[0] != 0) + (reason.limits_.elided[1] != 0);
+    }
+
+    template <typename alloc_t, std::size_t n>
+    static void reserve_frames(basic_reason<alloc_t, n>& reason,
+            std::size_t frames)
+    {
+        reason.frames_.reserve(frames);
+    }
+
+    template <typename alloc_t, std::size_t n>
+    static void push_frame(basic_reason<alloc_t, n>& reason, bool wrap,
+            const char* data, std::size_t size)
+    {
+        using frame = typename basic_reason<alloc_t, n>::frame;
+        reason.push_frame(wrap ? frame::wrap : frame::extend, data, size);
+    }
+};
+
+// integers on the wire are little-endian; copy them directly when the
+// host is too
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+inline void store_u32(unsigned char* out, std::uint32_t value) noexcept
+{
+    std::memcpy(out, &value, sizeof(value));
+}
+
+inline std::uint32_t load_u32(const unsigned char* in) noexcept
+{
+    std::uint32_t value;
+    std::memcpy(&value, in, sizeof(value));
+    return value;
+}
+#else
+inline void store_u32(unsigned char* out, std::uint32_t value) noexcept
+{
+    out[0] = static_cast<unsigned char>(value);
+    out[1] = static_cast<unsigned char>(value >> 8);
+    out[2] = static_cast<unsigned char>(value >> 16);
+    out[3] = static_cast<unsigned char>(value >> 24);
+}
+
+inline std::uint32_t load_u32(const unsigned char* in) noexcept
+{
+    return static_cast<std::uint32_t>(in[0]) |
+            static_cast<std::uint32_t>(in[1]) << 8 |
+            static_cast<std::uint32_t>(in[2]) << 16 |
+            static_cast<std::uint32_t>(in[3]) << 24;
+}
+#endif
+
+} // namespace detail
+
+/**
+ * @brief A run of characters in the output of a reason or error; see
+ * jack::segments.
+ */
+struct segment
+{
+    /// @brief First character; not null-terminated.
+    const char* data;
+
+    /// @brief Number of characters.
+    std::size_t size;
+};
+
+/**
+ * @brief The output of a reason or error as a list of segments, for
+ * scatter-gather I/O (e.g. writev) or for copying into a caller's
+ * buffer, without building the flat description.  Contexts & the root
+ * message are referred to where they are stored, so the reason must
+ * outlive this object & not change.  That includes calling c_str on a
+ * reason that hasn't been read yet, which may move its storage to make
+ * room for the description.  Short pieces, such as the ": "
+ * separators, line numbers & the code, are copied into storage inside
+ * this object and merged with their neighbours, so a wrapped reason is
+ * about one segment per context.  A reason with too many pieces to fit
+ * is rendered (as c_str would) and used whole.
+ * 
+ * @code
+ * jack::segments out(err);
+ * iovec iov[jack::segments::max_segments];
+ * writev(fd, iov, static_cast<int>(out.to_iovec(iov)));
+ * @endcode
+ */
+class segments
+{
+  public:
+
+    /// @brief Most segments an output is split into.
+    static constexpr std::size_t max_segments = 32;
+
+    /**
+     * @brief Split the description of a reason.
+     * 
+     * @param reason reason to refer to
+     */
+    template <typename alloc_t, std::size_t n>
+    explicit segments(const basic_reason<alloc_t, n>& reason)
+    {
+        gather(reason);
+    }
+
+    /**
+     * @brief Split the output of an error, laid out like debug::str:
+     * error { code: <code>, desc: "<description>" }
+     * 
+     * @param error error to refer to
+     */
+    template <typename alloc_t>
+    explicit segments(const basic_error<alloc_t>& error)
+    {
+        static constexpr const char head[] = "error { code: ";
+        static constexpr const char desc[] = ", desc: \"";
+        static constexpr const char tail[] = "\" }";
+
+        // the head & code are one segment of their own
+        const detail::piece<int> code(error.code);
+        char digits[short_piece];
+        merge(head, sizeof(head) - 1);
+        merge(digits, static_cast<std::size_t>(code.write(digits) - digits));
+        merge(desc, sizeof(desc) - 1);
+        gather(error.desc);
+        if (!merge(tail, sizeof(tail) - 1))
+        {
+            add(tail, sizeof(tail) - 1);
+        }
+    }
+
+    segments(const segments&) = delete;
+    segments& operator=(const segments&) = delete;
+
+    const segment* begin() const noexcept { return segs_; }
+    const segment* end() const noexcept { return segs_ + count_; }
+    const segment& operator[](std::size_t i) const noexcept { return segs_[i]; }
+
+    /// @brief Number of segments.
+    std::size_t size() const noexcept { return count_; }
+
+    /// @brief Number of characters in all segments together.
+    std::size_t bytes() const noexcept { return bytes_; }
+
+    /// @brief Characters copied into this object to merge short pieces.
+    std::size_t copied() const noexcept { return used_; }
+
+    /**
+     * @brief Fill an array of struct iovec, or of any type with iov_base
+     * & iov_len members.
+     * 
+     * @param out array of at least size() entries
+     * @return number of entries filled
+     */
+    template <typename iovec_t>
+    std::size_t to_iovec(iovec_t* out) const noexcept
+    {
+        for (std::size_t i = 0; i < count_; ++i)
+        {
+            out[i].iov_base = const_cast<char*>(segs_[i].data);
+            out[i].iov_len = segs_[i].size;
+        }
+        return count_;
+    }
+
+    /**
+     * @brief Copy every segment into one buffer, in order.
+     * 
+     * @param out buffer of at least bytes() characters
+     * @return one past the last character written
+     */
+    char* copy(char* out) const noexcept
+    {
+        for (std::size_t i = 0; i < count_; ++i)
+        {
+            std::memcpy(out, segs_[i].data, segs_[i].size);
+            out += segs_[i].size;
+        }
+        return out;
+    }
+
+  private:
+
+    /// @brief Pieces up to this long are copied & merged.
+    static constexpr std::size_t short_piece = 16;
+
+    /// @brief Characters of short pieces held inside the object.
+    static constexpr std::size_t scratch_size = 256;
+
+    static_assert(detail::line_digits <= short_piece,
+            "temporary pieces must be copied");
+
+    template <typename alloc_t, std::size_t n>
+    void gather(const basic_reason<alloc_t, n>& reason)
+    {
+        const std::size_t count = count_;
+        const std::size_t bytes = bytes_;
+        const std::size_t used = used_;
+        bool fits = true;
+        detail::reason_access::for_each_raw_piece(reason,
+                [&](const char* data, std::size_t size) {
+                    if (fits && size != 0)
+                    {
+                        fits = size <= short_piece ? merge(data, size) :
+                                add(data, size);
+                    }
+                });
+        if (!fits)
+        {
+            count_ = count;
+            bytes_ = bytes;
+            used_ = used;
+            add(reason.c_str(), reason.size());
+        }
+    }
+
+    /**
+     * @brief Append a segment that refers to data where it is.
+     */
+    bool add(const char* data, std::size_t size) noexcept
+    {
+        if (count_ == max_segments)
+        {
+            return false;
+        }
+        segs_[count_++] = {data, size};
+        bytes_ += size;
+        return true;
+    }
+
+    /**
+     * @brief Copy a short piece into the scratch storage, extending the
+     * last segment when it ends where the piece goes.
+     */
+    bool merge(const char* data, std::size_t size) noexcept
+    {
+        if (used_ + size > scratch_size)
+        {
+            return false;
+        }
+        char* const to = scratch_ + used_;
+        if (count_ != 0 && segs_[count_ - 1].data + segs_[count_ - 1].size == to)
+        {
+            std::memcpy(to, data, size);
+            segs_[count_ - 1].size += size;
+            bytes_ += size;
+        }
+        else if (!add(to, size))
+        {
+            return false;
+        }
+        else
+        {
+            std::memcpy(to, data, size);
+        }
+        used_ += size;
+        return true;
+    }
+
+    segment segs_[max_segments];
+    std::size_t count_ = 0;
+    std::size_t bytes_ = 0;
+    std::size_t used_ = 0;
+    char scratch_[scratch_size];
+};
+
+/**
+ * @brief A compact binary encoding of an error for sending it between
+ * processes, e.g. over a socket or through shared memory.  Read it in
+ * place with jack::error_view.
+ * 
+ * Every integer is little-endian and nothing is aligned.  Version 1:
+ * 
+ * | offset   | size  | field                                         |
+ * |----------|-------|-----------------------------------------------|
+ * | 0        | 2     | magic, "je"                                   |
+ * | 2        | 1     | version, 1                                    |
+ * | 3        | 1     | flags, 0                                      |
+ * | 4        | 4     | code (two's complement)                       |
+ * | 8        | 4     | description size, t                           |
+ * | 12       | 4     | frame count, n                                |
+ * | 16       | 4     | root message offset within the description    |
+ * | 20       | 4     | root message size                             |
+ * | 24       | 8 * n | frames in arrival order: offset within the    |
+ * |          |       | description, then size with the top bit set   |
+ * |          |       | for a wrap & clear for an extend              |
+ * | 24 + 8n  | t + 1 | full description, null-terminated             |
+ */
+namespace wire
+{
+
+/// @brief Version written by encode & accepted by error_view.
+constexpr unsigned char version = 1;
+
+/// @brief Bytes before the frame table.
+constexpr std::size_t header_size = 24;
+
+/// @brief Bytes per frame table entry.
+constexpr std::size_t frame_size = 8;
+
+/// @brief Largest encoding; sizes & offsets must fit in 31 bits.
+constexpr std::size_t max_size = 0x7fffffff;
+
+/**
+ * @brief Get the number of bytes encode needs for an error.
+ * 
+ * @param err error to measure
+ * @return encoded size in bytes
+ */
+template <typename alloc_t>
+inline std::size_t encoded_size(const basic_error<alloc_t>& err)
+{
+    return header_size + frame_size *
+            detail::reason_access::frame_count(err.desc) + err.desc.size() + 1;
+}
+
+/**
+ * @brief Encode an error into a caller-provided buffer.  The
+ * description is written straight from the error's frames; nothing is
+ * allocated.
+ * 
+ * @param err error to encode
+ * @param buf buffer to write to
+ * @param size number of bytes available in buf
+ * @return number of bytes written, or 0 (nothing written) if buf is too
+ * small or the error is larger than wire::max_size
+ */
+template <typename alloc_t>
+inline std::size_t encode(const basic_error<alloc_t>& err, void* buf,
+        std::size_t size)
+{
+    using access = detail::reason_access;
+
+    const std::size_t text = err.desc.size();
+    const std::size_t total = encoded_size(err);
+    if (total > size || total > max_size)
+    {
+        return 0;
+    }
+
+    // wraps come before the root in the description & extends after it
+    std::size_t wraps = 0;
+    std::size_t extends = 0;
+    access::for_each_frame(err.desc, [&](std::size_t n, bool wrap) {
+        (wrap ? wraps : extends) += n + 2;
+    });
+    const std::size_t root_size = text - wraps - extends;
+
+    auto* const out = static_cast<unsigned char*>(buf);
+    out[0] = 'j';
+    out[1] = 'e';
+    out[2] = version;
+    out[3] = 0;
+    detail::store_u32(out + 4, static_cast<std::uint32_t>(err.code));
+    detail::store_u32(out + 8, static_cast<std::uint32_t>(text));
+    detail::store_u32(out + 12, static_cast<std::uint32_t>(
+            access::frame_count(err.desc)));
+    detail::store_u32(out + 16, static_cast<std::uint32_t>(wraps));
+    detail::store_u32(out + 20, static_cast<std::uint32_t>(root_size));
+
+    unsigned char* entry = out + header_size;
+    std::size_t wrap_pos = wraps;
+    std::size_t extend_pos = wraps + root_size;
+    access::for_each_frame(err.desc, [&](std::size_t n, bool wrap) {
+        std::size_t offset;
+        if (wrap)
+        {
+            wrap_pos -= n + 2;
+            offset = wrap_pos;
+        }
+        else
+        {
+            offset = extend_pos + 2;
+            extend_pos += n + 2;
+        }
+        detail::store_u32(entry, static_cast<std::uint32_t>(offset));
+        detail::store_u32(entry + 4, static_cast<std::uint32_t>(n) |
+                (wrap ? 0x80000000u : 0u));
+        entry += frame_size;
+    });
+
+    *access::write(err.desc, reinterpret_cast<char*>(entry)) = '\0';
+    return total;
+}
+
+} // namespace wire
+
+/**
+ * @brief A non-owning view of an error encoded by wire::encode.  The
+ * code, full description & each frame are read in place from the
+ * received bytes, which must outlive the view.  Constructing a view
+ * checks the bytes; nothing is allocated unless the view is converted
+ * back into an error.
+ * 
+ * @code
+ * jack::error_view view(buf, received);
+ * if (view) log(view.code(), view.c_str());
+ * @endcode
+ */
+class error_view
+{
+  public:
+
+    /**
+     * @brief Characters of the root message or of one frame.
+     */
+    struct frame
+    {
+        /// @brief First character; not null-terminated.
+        const char* data;
+
+        /// @brief Number of characters.
+        std::size_t size;
+
+        /// @brief Whether the frame was a wrap (prepended) rather than an
+        /// extend (appended).  Always false for the root message.
+        bool wrap;
+    };
+
+    /**
+     * @brief Construct an invalid view.
+     */
+    error_view() noexcept = default;
+
+    /**
+     * @brief View an encoded error.  The view is invalid if the bytes
+     * are truncated, malformed, or of an unknown version.  Any bytes
+     * after the encoded error are ignored (see encoded_size).
+     * 
+     * @param data first byte of the encoded error
+     * @param size number of bytes available
+     */
+    error_view(const void* data, std::size_t size) noexcept
+    {
+        const auto* const in = static_cast<const unsigned char*>(data);
+        if (size < wire::header_size || in[0] != 'j' || in[1] != 'e' ||
+                in[2] != wire::version)
+        {
+            return;
+        }
+
+        const std::uint64_t text = detail::load_u32(in + 8);
+        const std::uint64_t frames = detail::load_u32(in + 12);
+        const std::uint64_t total = wire::header_size +
+                wire::frame_size * frames + text + 1;
+        if (total > size || in[total - 1] != '\0' ||
+                std::uint64_t(detail::load_u32(in + 16)) +
+                detail::load_u32(in + 20) > text)
+        {
+            return;
+        }
+        for (std::uint64_t i = 0; i < frames; ++i)
+        {
+            const unsigned char* const entry = in + wire::header_size +
+                    wire::frame_size * i;
+            if (std::uint64_t(detail::load_u32(entry)) +
+                    (detail::load_u32(entry + 4) & 0x7fffffffu) > text)
+            {
+                return;
+            }
+        }
+        data_ = in;
+        size_ = static_cast<std::size_t>(total);
+    }
+
+    /**
+     * @brief Check that the bytes held a valid encoded error.
+     * 
+     * @return true if the view is valid
+     */
+    explicit operator bool() const noexcept
+    {
+        return data_ != nullptr;
+    }
+
+    /**
+     * @brief Get the number of bytes the encoded error occupies.
+     * 
+     * @return encoded size in bytes; 0 if invalid
+     */
+    std::size_t encoded_size() const noexcept
+    {
+        return size_;
+    }
+
+    /**
+     * @brief Get the error code.  Must only be called on a valid view.
+     * 
+     * @return error code
+     */
+    int code() const noexcept
+    {
+        const std::uint32_t bits = detail::load_u32(data_ + 4);
+        std::int32_t value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    /**
+     * @brief Get the full description.  Must only be called on a valid
+     * view.
+     * 
+     * @return null-terminated description within the viewed bytes
+     */
+    const char* c_str() const noexcept
+    {
+        return reinterpret_cast<const char*>(data_ + wire::header_size +
+                wire::frame_size * frame_count());
+    }
+
+    /**
+     * @brief Get the length of the full description.  Must only be
+     * called on a valid view.
+     * 
+     * @return number of characters in the description
+     */
+    std::size_t size() const noexcept
+    {
+        return detail::load_u32(data_ + 8);
+    }
+
+    /**
+     * @brief Get the root message.  Must only be called on a valid view.
+     * 
+     * @return root message within the viewed bytes
+     */
+    frame root() const noexcept
+    {
+        return {c_str() + detail::load_u32(data_ + 16),
+                detail::load_u32(data_ + 20), false};
+    }
+
+    /**
+     * @brief Get the number of wraps & extends.  Must only be called on
+     * a valid view.
+     * 
+     * @return number of frames
+     */
+    std::size_t frame_count() const noexcept
+    {
+        return detail::load_u32(data_ + 12);
+    }
+
+    /**
+     * @brief Get a wrap or extend, in the order they were added.  Must
+     * only be called on a valid view.
+     * 
+     * @param i index of the frame, less than frame_count()
+     * @return the frame's characters within the viewed bytes
+     */
+    frame frame_at(std::size_t i) const noexcept
+    {
+        const unsigned char* const entry = data_ + wire::header_size +
+                wire::frame_size * i;
+        const std::uint32_t size = detail::load_u32(entry + 4);
+        return {c_str() + detail::load_u32(entry), size & 0x7fffffffu,
+                (size & 0x80000000u) != 0};
+    }
+
+    /**
+     * @brief Copy the viewed error into an error with the same code &
+     * frames.  Must only be called on a valid view.
+     * 
+     * @param alloc allocator for the new error
+     * @return new error
+     */
+    template <typename alloc_t = std::allocator<char>>
+    basic_error<alloc_t> to_error(const alloc_t& alloc = alloc_t()) const
+    {
+        const std::size_t frames = frame_count();
+        const frame r = root();
+        typename basic_error<alloc_t>::string_type text(alloc);
+        text.reserve(size() - frames * 2);
+        text.append(r.data, r.size);
+        basic_error<alloc_t> err(code(), std::move(text));
+        detail::reason_access::reserve_frames(err.desc, frames);
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            const frame f = frame_at(i);
+            detail::reason_access::push_frame(err.desc, f.wrap, f.data, f.size);
+        }
+        return err;
+    }
+
+  private:
+
+    /// @brief First byte of the encoded error; null if invalid.
+    const unsigned char* data_ = nullptr;
+
+    /// @brief Number of bytes in the encoded error.
+    std::size_t size_ = 0;
+};
+
+/**
+ * @brief Implement stream operator for error_view class.
+ * 
+ * @param os std::ostream reference to write to
+ * @param view valid view to write the description of
+ * @return reference to param os
+ */
+inline std::ostream& operator<<(std::ostream& os, const error_view& view)
+{
+    return os << view.c_str();
+}
+
+/**
+ * @brief A compact list of errors, e.g. the failures of one batch
+ * operation.  Instead of a full reason per error, the list keeps each
+ * distinct message & context string once and gives every error a code,
+ * a root message & a chain of contexts that errors can share.  wrap &
+ * extend add one context to every error already in the list in O(1),
+ * and lists built by separate threads can be merged.  The first few
+ * errors & a short run of characters are stored inside the object.
+ * 
+ * @code
+ * jack::error_list failures;
+ * for (const auto& record : batch)
+ *     if (auto err = validate(record))
+ *         failures.push_back(*err);
+ * failures.wrap("importing ", path);
+ * log(failures.summary()); // "1234 errors, 3 distinct codes"
+ * @endcode
+ * 
+ * @tparam alloc_t allocator used for storage that doesn't fit inline
+ */
+template <typename alloc_t = std::allocator<char>>
+class basic_error_list
+{
+  public:
+
+    /// @brief Allocator used for storage.
+    using allocator_type = alloc_t;
+
+    /// @brief Error type pushed & produced by the list.
+    using error_type = basic_error<alloc_t>;
+
+    /// @brief String type that shares this list's allocator.
+    using string_type = typename error_type::string_type;
+
+    /**
+     * @brief Construct an empty list.
+     * 
+     * @param alloc allocator for storage that doesn't fit inline
+     */
+    explicit basic_error_list(const alloc_t& alloc = alloc_t()) :
+            alloc_(alloc), entries_(alloc), nodes_(alloc), strings_(alloc),
+            chars_(alloc), index_(index_alloc_t(alloc))
+    {
+        nodes_.push_back({none, none, false});
+    }
+
+    /**
+     * @brief Construct a list by copying from another list.
+     * 
+     * @param other list to copy from
+     */
+    basic_error_list(const basic_error_list& other) :
+            basic_error_list(other, other.alloc_)
+    {
+    }
+
+    /**
+     * @brief Construct a list by copying from another list, using the
+     * given allocator.
+     * 
+     * @param other list to copy from
+     * @param alloc allocator for the new list
+     */
+    basic_error_list(const basic_error_list& other, const alloc_t& alloc) :
+            alloc_(alloc), entries_(other.entries_, alloc),
+            nodes_(other.nodes_, alloc), strings_(other.strings_, alloc),
+            chars_(other.chars_, alloc),
+            index_(other.index_, index_alloc_t(alloc)), open_(other.open_)
+    {
+    }
+
+    /**
+     * @brief Construct a list by moving from another list, which is left
+     * empty.
+     * 
+     * @param other list to move from
+     */
+    basic_error_list(basic_error_list&& other) noexcept :
+            alloc_(other.alloc_), entries_(std::move(other.entries_)),
+            nodes_(std::move(other.nodes_)), strings_(std::move(other.strings_)),
+            chars_(std::move(other.chars_)), index_(std::move(other.index_)),
+            open_(other.open_)
+    {
+        other.clear();
+    }
+
+    /**
+     * @brief Copy from another list, keeping this list's allocator.
+     * 
+     * @param other list to copy from
+     * @return reference to this list
+     */
+    basic_error_list& operator=(const basic_error_list& other)
+    {
+        if (this != &other)
+        {
+            entries_ = other.entries_;
+            nodes_ = other.nodes_;
+            strings_ = other.strings_;
+            chars_ = other.chars_;
+            index_ = other.index_;
+            open_ = other.open_;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Move from another list, which is left empty, keeping this
+     * list's allocator.
+     * 
+     * @param other list to move from
+     * @return reference to this list
+     */
+    basic_error_list& operator=(basic_error_list&& other)
+    {
+        if (this != &other)
+        {
+            entries_ = std::move(other.entries_);
+            nodes_ = std::move(other.nodes_);
+            strings_ = std::move(other.strings_);
+            chars_ = std::move(other.chars_);
+            index_ = std::move(other.index_);
+            open_ = other.open_;
+            other.clear();
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Add a copy of an error.  Its message & contexts are only
+     * stored if no error in the list has used the same strings.
+     * 
+     * @param err error to copy from
+     */
+    void push_back(const error_type& err)
+    {
+        using access = detail::reason_access;
+
+        const literal root = access::root(err.desc);
+        const std::uint32_t root_id = intern(root.data, root.size);
+
+        // contexts become a chain from the innermost to the list's open
+        // node, so later wraps of the list reach this error too
+        const std::uint32_t base = static_cast<std::uint32_t>(nodes_.size());
+        std::uint32_t next = base;
+        access::for_each_context(err.desc,
+                [&](const char* data, std::size_t size, bool wrap) {
+                    const std::uint32_t str = intern(data, size);
+                    nodes_.push_back({str, ++next, wrap});
+                });
+        const bool chained = next != base;
+        if (chained)
+        {
+            nodes_[next - 1].parent = open_;
+        }
+        entries_.push_back({err.code, root_id, chained ? base : open_});
+    }
+
+    /**
+     * @brief Add an error without constructing one first.
+     * 
+     * @param code error code
+     * @param args values to build the root message from (see
+     * detail::make_str)
+     */
+    template <typename... str_args, typename = typename std::enable_if<
+            sizeof...(str_args) != 0>::type>
+    void emplace_back(int code, const str_args&... args)
+    {
+        const std::uint32_t root_id = format(args...);
+        entries_.push_back({code, root_id, open_});
+    }
+
+    /**
+     * @brief Wrap every error in the list with additional context
+     * (prepend).  The context is stored once, however many errors there
+     * are, and isn't applied to errors added later.
+     * 
+     * @param context values to construct a string from
+     * @return reference to this list
+     */
+    template <typename... str_args>
+    basic_error_list& wrap(const str_args&... context)
+    {
+        return add_context(true, context...);
+    }
+
+    /**
+     * @brief Extend every error in the list with additional information
+     * (append).  The information is stored once, however many errors
+     * there are, and isn't applied to errors added later.
+     * 
+     * @param info values to construct a string from
+     * @return reference to this list
+     */
+    template <typename... str_args>
+    basic_error_list& extend(const str_args&... info)
+    {
+        return add_context(false, info...);
+    }
+
+    /**
+     * @brief Append the errors of another list, e.g. one filled by a
+     * worker thread.  Strings are shared with those already in this
+     * list, and later wraps & extends of this list apply to the merged
+     * errors too.
+     * 
+     * @param other list to copy from
+     * @return reference to this list
+     */
+    basic_error_list& merge(const basic_error_list& other)
+    {
+        if (other.empty())
+        {
+            return *this;
+        }
+        if (&other == this)
+        {
+            const basic_error_list copy(*this);
+            return merge(copy);
+        }
+
+        std::vector<std::uint32_t, index_alloc_t> ids{index_alloc_t(alloc_)};
+        ids.reserve(other.strings_.size());
+        for (const auto& s : other.strings_)
+        {
+            ids.push_back(intern(other.chars_.begin() + s.offset, s.size));
+        }
+
+        const std::uint32_t offset = static_cast<std::uint32_t>(nodes_.size());
+        nodes_.reserve(nodes_.size() + other.nodes_.size());
+        for (const auto& n : other.nodes_)
+        {
+            nodes_.push_back({n.str == none ? none : ids[n.str],
+                    n.parent == none ? none : n.parent + offset, n.wrap});
+        }
+        nodes_[other.open_ + offset].parent = open_;
+
+        entries_.reserve(entries_.size() + other.entries_.size());
+        for (const auto& e : other.entries_)
+        {
+            entries_.push_back({e.code, ids[e.root], e.chain + offset});
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Get the number of errors.
+     */
+    std::size_t size() const noexcept
+    {
+        return entries_.size();
+    }
+
+    /**
+     * @brief Check if the list has no errors.
+     */
+    bool empty() const noexcept
+    {
+        return entries_.size() == 0;
+    }
+
+    /**
+     * @brief Get the code of an error.
+     * 
+     * @param i position of the error, less than size()
+     */
+    int code(std::size_t i) const noexcept
+    {
+        return entries_[i].code;
+    }
+
+    /**
+     * @brief Build an error equal to one that was added, with every
+     * context the list has applied to it since.
+     * 
+     * @param i position of the error, less than size()
+     * @return new error using the list's allocator
+     */
+    error_type at(std::size_t i) const
+    {
+        return at(i, alloc_);
+    }
+
+    /**
+     * @brief Build an error equal to one that was added, with every
+     * context the list has applied to it since.
+     * 
+     * @param i position of the error, less than size()
+     * @param alloc allocator for the new error
+     * @return new error
+     */
+    error_type at(std::size_t i, const alloc_t& alloc) const
+    {
+        const entry& e = entries_[i];
+        const span& root = strings_[e.root];
+        string_type text(chars_.begin() + root.offset, root.size, alloc);
+        error_type err(e.code, std::move(text));
+
+        // walking outwards visits contexts in arrival order
+        for (std::uint32_t n = e.chain; n != none; n = nodes_[n].parent)
+        {
+            const node& c = nodes_[n];
+            if (c.str != none)
+            {
+                const span& s = strings_[c.str];
+                detail::reason_access::push_frame(err.desc, c.wrap,
+                        chars_.begin() + s.offset, s.size);
+            }
+        }
+        return err;
+    }
+
+    /**
+     * @brief Count the different codes in the list.
+     */
+    std::size_t distinct_codes() const
+    {
+        std::vector<int, typename std::allocator_traits<alloc_t>::template
+                rebind_alloc<int>> codes(alloc_);
+        codes.reserve(entries_.size());
+        for (const auto& e : entries_)
+        {
+            codes.push_back(e.code);
+        }
+        std::sort(codes.begin(), codes.end());
+        return static_cast<std::size_t>(
+                std::unique(codes.begin(), codes.end()) - codes.begin());
+    }
+
+    /**
+     * @brief Describe the list in one line, e.g. "1234 errors, 3 distinct
+     * codes".
+     * 
+     * @return summary using the list's allocator
+     */
+    string_type summary() const
+    {
+        const std::size_t codes = distinct_codes();
+        string_type out(alloc_);
+        detail::append_str(out, size(), size() == 1 ? " error, " : " errors, ",
+                codes, codes == 1 ? " distinct code" : " distinct codes");
+        return out;
+    }
+
+    /**
+     * @brief Remove every error.  Storage is kept for reuse.
+     */
+    void clear() noexcept
+    {
+        entries_.clear();
+        nodes_.clear();
+        strings_.clear();
+        chars_.clear();
+        index_.clear();
+        nodes_.push_back({none, none, false});
+        open_ = 0;
+    }
+
+    /**
+     * @brief Get the number of bytes the list has allocated.
+     */
+    std::size_t heap_bytes() const noexcept
+    {
+        return entries_.heap_bytes() + nodes_.heap_bytes() +
+                strings_.heap_bytes() + chars_.heap_bytes() +
+                index_.capacity() * sizeof(std::uint32_t);
+    }
+
+    /**
+     * @brief Get the allocator used for storage.
+     */
+    alloc_t get_allocator() const
+    {
+        return alloc_;
+    }
+
+  private:
+
+    using index_alloc_t = typename std::allocator_traits<alloc_t>::template
+            rebind_alloc<std::uint32_t>;
+
+    static constexpr std::uint32_t none = 0xffffffff;
+
+    /// @brief Strings are found by a linear search until there are more.
+    static constexpr std::size_t linear_strings = 8;
+
+    /// @brief One error.  chain is its innermost context node, or the
+    /// open node it was added under.
+    struct entry
+    {
+        int code;
+        std::uint32_t root;
+        std::uint32_t chain;
+    };
+
+    /// @brief A context, & the next context outwards.  A node without a
+    /// string (the open node) is where the list's next context will go.
+    struct node
+    {
+        std::uint32_t str;
+        std::uint32_t parent;
+        bool wrap;
+    };
+
+    /// @brief Characters of one distinct string in chars_.
+    struct span
+    {
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    template <typename... str_args>
+    basic_error_list& add_context(bool wrap, const str_args&... context)
+    {
+        // every error reaches the open node, so there is nothing to wrap
+        // until there is an error
+        if (empty())
+        {
+            return *this;
+        }
+        const std::uint32_t str = format(context...);
+        const std::uint32_t open = static_cast<std::uint32_t>(nodes_.size());
+        nodes_.push_back({none, none, false});
+        nodes_[open_] = {str, open, wrap};
+        open_ = open;
+        return *this;
+    }
+
+    std::uint32_t format(const char* str)
+    {
+        return intern(str, std::char_traits<char>::length(str));
+    }
+
+    std::uint32_t format(const literal& str)
+    {
+        return intern(str.data, str.size);
+    }
+
+    template <typename... str_args>
+    std::uint32_t format(const str_args&... args)
+    {
+        string_type str(alloc_);
+        detail::append_str(str, args...);
+        return intern(str.data(), str.size());
+    }
+
+    static std::uint32_t hash(const char* data, std::size_t size) noexcept
+    {
+        std::uint32_t h = 2166136261u;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            h = (h ^ static_cast<unsigned char>(data[i])) * 16777619u;
+        }
+        return h;
+    }
 
-namespace jack
-{
+    bool equal(std::uint32_t id, const char* data, std::size_t size) const
+    {
+        const span& s = strings_[id];
+        return s.size == size &&
+                std::memcmp(chars_.begin() + s.offset, data, size) == 0;
+    }
 
-namespace detail 
-{
+    /**
+     * @brief Find or add a string.
+     * 
+     * @return id of the string
+     */
+    std::uint32_t intern(const char* data, std::size_t size)
+    {
+        const std::uint32_t count = static_cast<std::uint32_t>(strings_.size());
+        std::size_t slot = 0;
+        if (index_.empty())
+        {
+            for (std::uint32_t id = 0; id < count; ++id)
+            {
+                if (equal(id, data, size))
+                {
+                    return id;
+                }
+            }
+        }
+        else
+        {
+            const std::size_t mask = index_.size() - 1;
+            for (slot = hash(data, size) & mask; index_[slot] != none;
+                    slot = (slot + 1) & mask)
+            {
+                if (equal(index_[slot], data, size))
+                {
+                    return index_[slot];
+                }
+            }
+        }
 
-// prevent collisions with other jack defs
-#ifndef JACK_DETAIL_VARIADIC_MAKE_STR
-#define JACK_DETAIL_VARIADIC_MAKE_STR
+        strings_.push_back({static_cast<std::uint32_t>(chars_.size()),
+                static_cast<std::uint32_t>(size)});
+        chars_.append(data, size);
+        if (!index_.empty() && (count + 1) * 2 <= index_.size())
+        {
+            index_[slot] = count;
+        }
+        else if (count + 1 > linear_strings)
+        {
+            rehash();
+        }
+        return count;
+    }
 
-template <typename t>
-using cref_or_val = typename std::conditional<
-        std::is_fundamental<t>::value, t, const t&>::type;
+    void rehash()
+    {
+        std::size_t size = 32;
+        while (size < strings_.size() * 4)
+        {
+            size *= 2;
+        }
+        index_.assign(size, none);
+        const std::size_t mask = size - 1;
+        for (std::uint32_t id = 0; id < strings_.size(); ++id)
+        {
+            const span& s = strings_[id];
+            std::size_t slot = hash(chars_.begin() + s.offset, s.size) & mask;
+            while (index_[slot] != none)
+            {
+                slot = (slot + 1) & mask;
+            }
+            index_[slot] = id;
+        }
+    }
 
-template <typename last_t>
-inline void variadic_strcat(std::stringstream& stream,
-        cref_or_val<last_t> last)
-{
-    stream << last;
-}
+    alloc_t alloc_;
+    detail::inline_vector<entry, 4, alloc_t> entries_;
+    detail::inline_vector<node, 8, alloc_t> nodes_;
+    detail::inline_vector<span, 8, alloc_t> strings_;
+    detail::inline_vector<char, 96, alloc_t> chars_;
 
-template <typename current_t, typename... remainder_ts>
-inline void variadic_strcat(std::stringstream& stream,
-        cref_or_val<current_t> current, 
-        remainder_ts&&... remainder)
-{
-    stream << current;
-    variadic_strcat<remainder_ts...>(stream, 
-            std::forward<remainder_ts>(remainder)...);
-}
+    /// @brief Open-addressed string ids; empty while strings are few.
+    std::vector<std::uint32_t, index_alloc_t> index_;
+
+    /// @brief Node the next wrap or extend of the list goes into; every
+    /// error's chain ends there.
+    std::uint32_t open_ = 0;
+};
+
+template <typename alloc_t>
+constexpr std::uint32_t basic_error_list<alloc_t>::none;
+
+template <typename alloc_t>
+constexpr std::size_t basic_error_list<alloc_t>::linear_strings;
 
 /**
- * @brief Construct a string from an arbitrary series of parameters
- * using a std::stringstream and operator<<.
- * 
- * @return std::string constructed from given args
+ * @brief List of errors using std::allocator.
  */
-template <typename... str_ts>
-inline std::string make_str(str_ts&&... args)
+using error_list = basic_error_list<>;
+
+#ifdef JACK_DETAIL_HAS_PMR
+namespace pmr
 {
-    std::stringstream ss;
-    variadic_strcat<str_ts...>(ss, 
-            std::forward<str_ts>(args)...);
-    return ss.str();
-}
 
 /**
- * @brief No-argument overload of detail::make_str that avoids
- * useless calls when returning an empty std::string.
+ * @brief A list of errors whose storage comes from a
+ * std::pmr::memory_resource.
+ */
+using error_list = basic_error_list<std::pmr::polymorphic_allocator<char>>;
+
+} // namespace pmr
+#endif
+
+/**
+ * @brief Implement stream operator for error_list class.
  * 
- * @return empty std::string
+ * @param os std::ostream reference to write to
+ * @param list list to write the summary of
+ * @return reference to param os
  */
-inline std::string make_str()
+template <typename alloc_t>
+inline std::ostream& operator<<(std::ostream& os,
+        const basic_error_list<alloc_t>& list)
 {
-    return {};
+    return os << list.summary();
 }
 
-#endif // #ifndef
-
-} // namespace detail
-
 /**
- * @brief A human-readable error description.
+ * @brief A human-readable error description held in a fixed array of n
+ * characters, for threads that must not allocate.  It has reason's
+ * interface, but nothing it does allocates and every member is
+ * noexcept.  Each context is written into the array when it is added,
+ * so the description is always flat.
+ * 
+ * A description that would be longer than n characters is cut at n,
+ * and its last three characters become "..." to show that something is
+ * missing.  A wrap pushes the end of the description out; an extend of
+ * a truncated description is dropped.
+ * 
+ * Arguments are written in place: strings, characters, numbers,
+ * literals, locations and other inplace reasons.  Types that can only
+ * be written with operator<<, and heap-backed reasons, would allocate,
+ * so they are rejected while compiling.  Use to_reason to continue
+ * with a jack::reason on a thread that may allocate.
+ * 
+ * @code
+ * jack::inplace_reason<128> r("buffer underrun by ", frames, " frames");
+ * r.wrap("mixing bus ", bus);
+ * @endcode
+ * 
+ * @tparam n most characters in the description
  */
-class reason : private std::string
+template <std::size_t n>
+class inplace_reason
 {
   public:
 
-    // Expose std::string member functions 
-    using std::string::c_str;
+    static_assert(n >= 3, "jack::inplace_reason must have room for \"...\"");
 
-    /**
-     * @brief Prevent default reason construction.
-     */
-    reason() = delete;
+    /// @brief Most characters in the description.
+    static constexpr std::size_t capacity = n;
 
     /**
-     * @brief Construct a new reason object by moving from
-     * another reason object.
-     * 
-     * @param reason reason to move from
+     * @brief Prevent default reason construction.
      */
-    reason(reason&& reason) = default;
+    inplace_reason() = delete;
 
     /**
      * @brief Construct a new reason object by copying from
@@ -122,381 +7302,434 @@ class reason : private std::string
      * 
      * @param reason reason to copy from
      */
-    reason(const reason& reason) = default;
+    inplace_reason(const inplace_reason& reason) noexcept :
+            size_(reason.size_), truncated_(reason.truncated_)
+    {
+        std::memcpy(buf_, reason.buf_, size_ + 1);
+    }
 
     /**
-     * @brief Construct a new reason object by copying from
-     * a c string.
+     * @brief Copy assignment operator.
      * 
-     * @param c_str c string to copy from
+     * @param other reason to copy from
+     * @return reference to this reason
      */
-    reason(const char* c_str) : std::string(c_str)
+    inplace_reason& operator=(const inplace_reason& other) noexcept
     {
+        size_ = other.size_;
+        truncated_ = other.truncated_;
+        std::memmove(buf_, other.buf_, size_ + 1);
+        return *this;
     }
 
     /**
-     * @brief Construct a new reason object by copying from
-     * a std::string.
+     * @brief Construct a new reason object from an arbitrary series of
+     * parameters, truncated to n characters.
      * 
-     * @param str std::string to copy from
+     * @tparam str_args types of arguments used to construct the reason
+     * @param str values to construct a reason from
      */
-    reason(const std::string& str) : std::string(str)
+    template <typename... str_args, typename = typename std::enable_if<
+            !detail::is_deferred_arg<str_args...>::value>::type>
+    explicit inplace_reason(const str_args&... str) noexcept
     {
+        append(detail::piece<typename std::decay<str_args>::type>(str)...);
     }
 
     /**
-     * @brief Construct a new reason object by moving from
-     * a std::string.
+     * @brief Get the full description as a c string.
      * 
-     * @param str std::string to move from
+     * @return null-terminated description owned by this reason
      */
-    reason(std::string&& str) : std::string(std::move(str))
+    const char* c_str() const noexcept
     {
+        return buf_;
     }
 
     /**
-     * @brief Construct a new reason object from an arbitrary series
-     * of parameters using a std::stringstream and operator<<.
+     * @brief Get the length of the description.
      * 
-     * @tparam str_args types of arguments used to construct the reason
-     * @param str values to construct a reason from
+     * @return number of characters in the description, at most n
      */
-    template <typename... str_args>
-    explicit reason(str_args&&... str) : std::string(detail::make_str(
-            std::forward<str_args>(str)...))
+    std::size_t size() const noexcept
     {
+        return size_;
     }
 
     /**
-     * @brief Copy assignment operator.
-     * 
-     * @param other reason to copy from
-     * @return reference to this reason
-     */
-    reason& operator=(const reason& other) = default;
-    
-    /**
-     * @brief Move assignment operator.
+     * @brief Whether anything was cut off the description.
      * 
-     * @param from reason to move from
-     * @return reference to this reason
+     * @return true if the description ends in a "..." that stands for
+     * missing characters
      */
-    reason& operator=(reason&& from) = default;
+    bool truncated() const noexcept
+    {
+        return truncated_;
+    }
 
     /**
      * @brief Wrap this reason with additional context (prepend).
      * 
-     * @param context values to contruct a string from
+     * @param context values to construct the context from
      * @return reference to this reason
      */
     template <typename... str_args>
-    reason& wrap(str_args&&... context)
+    inplace_reason& wrap(const str_args&... context) noexcept
     {
-        const auto ctx_str = detail::make_str(
-                std::forward<str_args>(context)...);
-        reserve(ctx_str.size() + 2);
-        insert(0, ": ").insert(0, ctx_str);
+        prepend(detail::piece<typename std::decay<str_args>::type>(context)...,
+                detail::view_piece(": ", 2));
         return *this;
     }
-    
+
     /**
-     * @brief Wrap this reason with additional context (prepend).
+     * @brief Wrap this reason with the location of the call (prepend).
      * 
-     * @param context c string to copy from
+     * @param where location to refer to; defaults to the caller's
      * @return reference to this reason
      */
-    reason& wrap(const char* context)
+    inplace_reason& trace(location where = location::current()) noexcept
     {
-        reserve(std::string::traits_type::length(context) + 2);
-        insert(0, ": ").insert(0, context);
-        return *this;
+        return wrap(where);
     }
 
     /**
-     * @brief Wrap this reason with additional context (prepend).
+     * @brief Extend this reason with additional information (append).
      * 
-     * @param context std::string to copy from
+     * @param info values to construct the information from
      * @return reference to this reason
      */
-    reason& wrap(const std::string& context)
+    template <typename... str_args>
+    inplace_reason& extend(const str_args&... info) noexcept
     {
-        reserve(context.size() + 2);           // TODO benchmark preemptive reserves
-        insert(0, ": ").insert(0, context);
+        append(detail::view_piece(": ", 2),
+                detail::piece<typename std::decay<str_args>::type>(info)...);
         return *this;
     }
 
     /**
-     * @brief Wrap this reason with additional context (prepend).
+     * @brief Copy the description into a heap-backed reason.
      * 
-     * @param context reason to copy from
-     * @return reference to this reason
+     * @param alloc allocator for the new reason
+     * @return reason with the same description
      */
-    reason& wrap(const reason& context)
+    template <typename alloc_t = std::allocator<char>>
+    basic_reason<alloc_t> to_reason(const alloc_t& alloc = alloc_t()) const
     {
-        reserve(context.size() + 2);
-        insert(0, ": ").insert(0, context);
-        return *this;
+        return basic_reason<alloc_t>(buf_, alloc);
     }
 
+  private:
+
     /**
-     * @brief Extend this reason with additional information (append).
-     * 
-     * @param info values to construct a string from
-     * @return reference to this reason
+     * @brief Write pieces after the description, as much as fits.
      */
-    template <typename... str_args>
-    reason& extend(str_args&&... info)
+    template <typename... piece_ts>
+    void append(const piece_ts&... pieces) noexcept
     {
-        const auto info_str = detail::make_str(
-                std::forward<str_args>(info)...);
-        reserve(info_str.size() + 2);
-        append(": ").append(info_str);
-        return *this;
+        check<piece_ts...>();
+        if (truncated_)
+        {
+            return;
+        }
+        using expand = int[];
+        std::size_t size = 0;
+        (void)expand{0, (size += pieces.size(), 0)...};
+        char* pos = buf_ + size_;
+        (void)expand{0, (pos = pieces.write(pos,
+                static_cast<std::size_t>(buf_ + n - pos)), 0)...};
+        const bool cut = size > n - size_;
+        size_ = static_cast<std::size_t>(pos - buf_);
+        finish(cut);
     }
 
     /**
-     * @brief Extend this reason with additional information (append).
-     * 
-     * @param info c string to copy from
-     * @return reference to this reason
+     * @brief Write pieces before the description, moving as much of the
+     * description as still fits after them.
      */
-    reason& extend(const char* info)
+    template <typename... piece_ts>
+    void prepend(const piece_ts&... pieces) noexcept
     {
-        reserve(std::string::traits_type::length(info) + 2);
-        append(": ").append(info);
-        return *this;
+        check<piece_ts...>();
+        using expand = int[];
+        std::size_t size = 0;
+        (void)expand{0, (size += pieces.size(), 0)...};
+        const std::size_t shift = size < n ? size : n;
+        const std::size_t keep = size_ < n - shift ? size_ : n - shift;
+        std::memmove(buf_ + shift, buf_, keep);
+        char* pos = buf_;
+        (void)expand{0, (pos = pieces.write(pos,
+                static_cast<std::size_t>(buf_ + shift - pos)), 0)...};
+        const bool cut = truncated_ || size > n || keep < size_;
+        size_ = shift + keep;
+        finish(cut);
     }
 
     /**
-     * @brief Extend this reason with additional information (append).
-     * 
-     * @param info std::string to copy from
-     * @return reference to this reason
+     * @brief Terminate the description, marking it if it was cut.
      */
-    reason& extend(const std::string& info)
+    void finish(bool cut) noexcept
     {
-        reserve(info.size() + 2);            // TODO benchmark preemptive reserves
-        append(": ").append(info);
-        return *this;
+        if (cut)
+        {
+            size_ = n;
+            std::memcpy(buf_ + n - 3, "...", 3);
+            truncated_ = true;
+        }
+        buf_[size_] = '\0';
     }
 
-    /**
-     * @brief Extend this reason with additional information (append).
-     * 
-     * @param info reason to copy from
-     * @return reference to this reason
-     */
-    reason& extend(const reason& info)
+    template <typename... piece_ts>
+    static void check() noexcept
+    {
+        static_assert(!detail::any_of<detail::piece_allocates<piece_ts>...>::value,
+                "jack::inplace_reason arguments must be written without the heap "
+                "(strings, characters, numbers, literals, locations or inplace reasons)");
+    }
+
+    /// @brief Null-terminated description.
+    char buf_[n + 1];
+
+    /// @brief Characters in the description.
+    std::size_t size_ = 0;
+
+    /// @brief Whether the description ends in "..." for missing characters.
+    bool truncated_ = false;
+};
+
+
+namespace detail
+{
+
+/**
+ * @brief Inplace reasons are copied directly from their description.
+ */
+template <std::size_t n>
+class piece<inplace_reason<n>> : public view_piece
+{
+  public:
+
+    explicit piece(const inplace_reason<n>& value) :
+            view_piece(value.c_str(), value.size())
     {
-        reserve(info.size() + 2);            // TODO benchmark preemptive reserves
-        append(": ").append(info);
-        return *this;
     }
 };
 
+} // namespace detail
+
 /**
- * @brief Implement stream operator for reason class.
+ * @brief Implement stream operator for inplace_reason class.
  * 
  * @param os std::ostream reference to write to
  * @param reason reason to write from
  * @return reference to param os
  */
-inline std::ostream& operator<<(std::ostream& os, const reason& reason)
+template <std::size_t n>
+inline std::ostream& operator<<(std::ostream& os, const inplace_reason<n>& reason)
 {
     return os << reason.c_str();
 }
 
 /**
- * @brief A human-readable error description with a
- * paired code for programmatic error handling. 
+ * @brief A human-readable error description held in a fixed array of n
+ * characters, with a paired code, for threads that must not allocate.
+ * It has error's interface, but nothing it does allocates and every
+ * member is noexcept (see jack::inplace_reason for the truncation
+ * policy).  Use to_error to continue with a jack::error on a thread
+ * that may allocate.
+ * 
+ * @code
+ * jack::inplace_error<128> e(1001, "buffer underrun by ", frames, " frames");
+ * queue.push(e); // ...then, off the audio thread:
+ * jack::error err = e.to_error();
+ * @endcode
+ * 
+ * @tparam n most characters in the description
  */
-class error
+template <std::size_t n>
+class inplace_error
 {
   public:
 
+    /// @brief Description type.
+    using reason_type = inplace_reason<n>;
+
     /**
      * @brief Prevent default error construction.
      */
-    error() = delete;
+    inplace_error() = delete;
 
     /**
-     * @brief Construct a new error object by moving from
-     * another error object.
-     * 
-     * @param other error to move from
-     */
-    error(error&& other) = default;
-    
-    /**
-     * @brief Construct a new error object by copying from
-     * another error object.
-     * 
-     * @param other error to copy from
-     */
-    error(const error& other) = default;
-    
-    /**
-     * @brief Construct a new error object by accepting a 
-     * code and a reason object to copy from.
+     * @brief Construct a new error object by accepting a code and an
+     * arbitrary series of parameters to construct a reason from.
      * 
+     * @tparam str_args types of arguments used to construct the reason
      * @param code error code
-     * @param reason reason to copy from
+     * @param reason values to construct a reason from
      */
-    error(int code, const reason& reason) :
-            code(code), desc(reason)
+    template <typename... str_args>
+    inplace_error(int code, const str_args&... reason) noexcept :
+            code(code), desc(reason...)
     {
     }
 
     /**
-     * @brief Construct a new error object by accepting a 
-     * code and a reason object to move from.
-     * 
-     * @param code error code
-     * @param reason reason to move from
-     */
-    error(int code, reason&& reason) :
-            code(code), desc(std::move(reason))
-    {
-    }
-    
-    /**
-     * @brief Construct a new error object by accepting a 
-     * code and a c string to copy from.
+     * @brief Construct a new error object wrapped with a source location.
      * 
+     * @tparam str_args types of arguments used to construct the reason
+     * @param where location to wrap the reason with
      * @param code error code
-     * @param reason c string to copy from
+     * @param reason values to construct a reason from
      */
-    error(int code, const char* reason) :
-            code(code), desc(reason)
+    template <typename... str_args>
+    inplace_error(location where, int code, const str_args&... reason) noexcept :
+            code(code), desc(reason...)
     {
+        desc.wrap(where);
     }
 
     /**
-     * @brief Construct a new error object by accepting a 
-     * code and a std::string to copy from.
-     * 
-     * @param code error code
-     * @param reason std::string to copy from
-     */
-    error(int code, const std::string& reason) :
-            code(code), desc(reason)
-    {
-    }
-    
-    /**
-     * @brief Construct a new error object by accepting a 
-     * code and a std::string to move from.
+     * @brief Wrap this error's reason with additional context (prepend).
      * 
-     * @param code error code
-     * @param reason std::string to move from
+     * @param context values to construct the context from
+     * @return reference to this error
      */
-    error(int code, std::string&& reason) : 
-            code(code), desc(std::move(reason))
+    template <typename... str_args>
+    inplace_error& wrap(const str_args&... context) noexcept
     {
+        desc.wrap(context...);
+        return *this;
     }
-    
+
     /**
-     * @brief Construct a new error object from an arbitrary series
-     * of parameters using a std::stringstream and operator<<.
+     * @brief Extend this error's reason with additional information
+     * (append).
      * 
-     * @tparam str_args types of arguments used to construct the reason
-     * @param code error code
-     * @param reason values to construct a reason from
+     * @param info values to construct the information from
+     * @return reference to this error
      */
     template <typename... str_args>
-    error(int code, str_args&&... reason) :
-            code(code), desc(std::forward<str_args>(reason)...)
+    inplace_error& extend(const str_args&... info) noexcept
     {
+        desc.extend(info...);
+        return *this;
     }
-    
-    /**
-     * @brief Copy assignment operator.
-     * 
-     * @param other error to copy from
-     * @return reference to this error
-     */
-    error& operator=(const error& other) = default;
 
     /**
-     * @brief Move assignment operator.
+     * @brief Wrap this error's reason with the location of the call
+     * (prepend).
      * 
-     * @param from error to move from
+     * @param where location to refer to; defaults to the caller's
      * @return reference to this error
      */
-    error& operator=(error&& from) = default;
-
-    /**
-     * @brief Wrap this error's reason with additional context (prepend).
-     * 
-     * @param context values to construct a string from
-     */
-    template <typename... str_args>
-    error& wrap(str_args&&... context)
+    inplace_error& trace(location where = location::current()) noexcept
     {
-        desc.wrap(std::forward<str_args>(context)...);
+        desc.wrap(where);
         return *this;
     }
 
     /**
-     * @brief Extend this error's reason with additional information (append).
+     * @brief Copy the code & description into a heap-backed error.
      * 
-     * @param info values to construct a string from
+     * @param alloc allocator for the new error
+     * @return error with the same code & description
      */
-    template <typename... str_args>
-    error& extend(str_args&&... info)
+    template <typename alloc_t = std::allocator<char>>
+    basic_error<alloc_t> to_error(const alloc_t& alloc = alloc_t()) const
     {
-        desc.extend(std::forward<str_args>(info)...);
-        return *this;
+        return basic_error<alloc_t>(code, desc.to_reason(alloc));
     }
 
     /// @brief Signed integer error code.
     int code;
 
     /// @brief Human-readable error description.
-    reason desc;
-};
-
-// /**
-//  * @brief A human-readable error description with a
-//  * paired code for programmatic error handling.  While I
-//  * recommend using the error classes with std::optional (C++17) & 
-//  * std::expected (C++23) or non-std implementations like those of
-//  * Sy Brand (https://github.com/TartanLlama; C++11/14/17), this template
-//  * allows definition of a default state that will evaluate to false
-//  * in an explicit boolean conversion.  
-//  * 
-//  * @tparam dfault integer to represent the default (non-error) state
-//  */
-// template <int dfault = 0>
-// class derror : public error
-// {
-//     derror() : error(dfault, {})
-//     {
-//     }
-
-//     explicit operator bool() const
-//     {
-//         return code != dfault;
-//     }
-// };
+    reason_type desc;
+};
 
 namespace debug
 {
 
 /**
- * @brief Produce a friendly debug string.
+ * @brief Produce a friendly debug string.  The string uses the
+ * error's allocator.  The description is not escaped; see jack::render
+ * (jack/render.hpp) for JSON & logfmt.
+ * 
+ * @param error error to copy from
+ * @return debug string from given error
+ */
+template <typename alloc_t>
+JACK_DETAIL_OUT_OF_LINE typename basic_error<alloc_t>::string_type str(
+        const basic_error<alloc_t>& error)
+{
+    typename basic_error<alloc_t>::string_type out(error.get_allocator());
+    detail::append_str(out, "error { code: ", error.code,
+            ", desc: \"", error.desc, "\" }");
+    return out;
+}
+
+/**
+ * @brief Produce a friendly debug string without allocating.  The
+ * result has room for any code besides the whole description.
  * 
  * @param error error to copy from
  * @return debug string from given error
  */
-inline std::string str(const error& error)
+template <std::size_t n>
+inline inplace_reason<n + 40> str(const inplace_error<n>& error) noexcept
 {
-    return detail::make_str("error { code: ", error.code,
+    return inplace_reason<n + 40>("error { code: ", error.code,
             ", desc: \"", error.desc, "\" }");
 }
 
+#ifdef JACK_DETAIL_CPP17
+/**
+ * @brief Produce a string from a JACK_FMT format string.
+ * 
+ * @param fmt format string created with JACK_FMT
+ * @param args values to substitute for the placeholders
+ * @return formatted string
+ */
+template <typename fmt_t, typename... str_args, typename = typename
+        std::enable_if<detail::is_fmt<fmt_t>::value>::type>
+inline std::string str(const fmt_t& fmt, const str_args&... args)
+{
+    std::string out;
+    detail::append_str(out, fmt, args...);
+    return out;
+}
+#endif
+
 } // namespace debug
 
+/**
+ * @brief Explicit instantiations compiled into the jack-error library:
+ * reason & error with std::allocator, debug::str, and the formatting of
+ * the most common argument lists (after string literals decay to const
+ * char*).  Other translation units see them with an extern prefix.
+ */
+#define JACK_DETAIL_INSTANTIATE(prefix) \
+    prefix template class basic_reason<std::allocator<char>>; \
+    prefix template class basic_error<std::allocator<char>>; \
+    prefix template std::string debug::str(const error&); \
+    JACK_DETAIL_INSTANTIATE_ARGS(prefix, const char* const&) \
+    JACK_DETAIL_INSTANTIATE_ARGS(prefix, const std::string&) \
+    JACK_DETAIL_INSTANTIATE_ARGS(prefix, const char* const&, const int&) \
+    JACK_DETAIL_INSTANTIATE_ARGS(prefix, const char* const&, const std::size_t&) \
+    JACK_DETAIL_INSTANTIATE_ARGS(prefix, const char* const&, const char* const&) \
+    JACK_DETAIL_INSTANTIATE_ARGS(prefix, const char* const&, const std::string&) \
+    JACK_DETAIL_INSTANTIATE_ARGS(prefix, const char* const&, const int&, \
+            const char* const&) \
+    JACK_DETAIL_INSTANTIATE_ARGS(prefix, const char* const&, const std::string&, \
+            const char* const&)
+
+#define JACK_DETAIL_INSTANTIATE_ARGS(prefix, ...) \
+    prefix template reason& reason::format_frame(reason::frame::kind, __VA_ARGS__); \
+    prefix template void reason::format_root(__VA_ARGS__);
+
+#ifdef JACK_ERROR_COMPILED
+JACK_DETAIL_INSTANTIATE(extern)
+#endif
+
 } // namespace jack
 
 #endif // #ifndef
\ No newline at end of file
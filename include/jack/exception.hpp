@@ -0,0 +1,265 @@
+// MIT License
+//
+// Copyright (c) 2022 Jack Allen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INCLUDE_JACK_EXCEPTION_HPP
+#define INCLUDE_JACK_EXCEPTION_HPP
+
+#include "error.hpp"
+
+#include <exception>
+
+namespace jack
+{
+
+/// @brief Code given to exceptions that carry none of their own, when
+/// try_call turns them into errors.
+constexpr int foreign_exception_code = -1;
+
+/**
+ * @brief A jack::error thrown as a std::exception, for code on the far
+ * side of a boundary that expects exceptions.  The error is moved in &
+ * moved back out, so its description is never copied; what() is its
+ * description, rendered when the exception is constructed.
+ *
+ * @code
+ * void handler(request& req)
+ * {
+ *     if (auto err = route(req)) throw jack::exception(std::move(*err));
+ * }
+ *
+ * catch (jack::exception& e)
+ * {
+ *     jack::error err = std::move(e).error();
+ * }
+ * @endcode
+ */
+class exception : public std::exception
+{
+  public:
+
+    /**
+     * @brief Construct a new exception object by moving from an error.
+     *
+     * @param err error to move from
+     */
+    explicit exception(jack::error&& err) : err_(std::move(err))
+    {
+        err_.desc.c_str();
+    }
+
+    /**
+     * @brief Construct a new exception object by copying from an error.
+     *
+     * @param err error to copy from
+     */
+    explicit exception(const jack::error& err) : err_(err)
+    {
+        err_.desc.c_str();
+    }
+
+    /**
+     * @brief Construct a new exception object holding an error built
+     * from a code and the arguments of any error constructor.
+     *
+     * @param code error code
+     * @param reason values to construct a reason from
+     */
+    template <typename... str_args>
+    exception(int code, str_args&&... reason) :
+            err_(code, std::forward<str_args>(reason)...)
+    {
+        err_.desc.c_str();
+    }
+
+    /**
+     * @brief Get the held error's description.
+     *
+     * @return null-terminated description owned by this exception
+     */
+    const char* what() const noexcept override
+    {
+        // rendered by the constructor, so this only reads
+        return err_.desc.c_str();
+    }
+
+    /**
+     * @brief Get the held error's code.
+     *
+     * @return error code
+     */
+    int code() const noexcept
+    {
+        return err_.code;
+    }
+
+    /**
+     * @brief Access the held error.
+     *
+     * @return reference to the held error
+     */
+    jack::error& error() & noexcept
+    {
+        return err_;
+    }
+
+    /**
+     * @brief Access the held error.
+     *
+     * @return reference to the held error
+     */
+    const jack::error& error() const& noexcept
+    {
+        return err_;
+    }
+
+    /**
+     * @brief Access the held error to move it out, leaving what()
+     * empty: jack::error err = std::move(e).error();
+     *
+     * @return rvalue reference to the held error
+     */
+    jack::error&& error() && noexcept
+    {
+        return std::move(err_);
+    }
+
+  private:
+
+    /// @brief Thrown error.
+    jack::error err_;
+};
+
+namespace detail
+{
+
+template <typename fn_t, typename... args_t>
+using call_t = decltype(std::declval<fn_t>()(std::declval<args_t>()...));
+
+template <typename fn_t, typename... args_t>
+inline typename std::enable_if<!std::is_void<call_t<fn_t, args_t...>>::value,
+        result<call_t<fn_t, args_t...>>>::type
+call_as_result(fn_t&& fn, args_t&&... args)
+{
+    return std::forward<fn_t>(fn)(std::forward<args_t>(args)...);
+}
+
+template <typename fn_t, typename... args_t>
+inline typename std::enable_if<std::is_void<call_t<fn_t, args_t...>>::value,
+        result<void>>::type
+call_as_result(fn_t&& fn, args_t&&... args)
+{
+    std::forward<fn_t>(fn)(std::forward<args_t>(args)...);
+    return {};
+}
+
+} // namespace detail
+
+/**
+ * @brief Call fn(args...) & return its value, or the error of the
+ * exception it threw.  Exceptions are caught once, here, whatever the
+ * depth they were thrown from.  A jack::exception gives back its error
+ * by moving it; any other std::exception becomes an error with
+ * foreign_exception_code & a copy of what(), & anything else one with
+ * foreign_exception_code & "unknown exception".
+ *
+ * @code
+ * jack::result<config> cfg = jack::try_call(parse_config, text);
+ * @endcode
+ *
+ * @param fn callable to call
+ * @param args arguments to call fn with
+ * @return result<r> holding fn's value, of type r, or the error
+ */
+template <typename fn_t, typename... args_t>
+inline auto try_call(fn_t&& fn, args_t&&... args) -> decltype(
+        detail::call_as_result(std::forward<fn_t>(fn), std::forward<args_t>(args)...))
+{
+    try
+    {
+        return detail::call_as_result(std::forward<fn_t>(fn),
+                std::forward<args_t>(args)...);
+    }
+    catch (jack::exception& e)
+    {
+        return derror(std::move(e).error());
+    }
+    catch (const std::exception& e)
+    {
+        return derror(foreign_exception_code, e.what());
+    }
+    catch (...)
+    {
+        return derror(foreign_exception_code, literal("unknown exception"));
+    }
+}
+
+namespace detail
+{
+
+/**
+ * @brief A callable whose calls go through try_call (see nothrow).
+ */
+template <typename fn_t>
+class nothrow_fn
+{
+  public:
+
+    explicit nothrow_fn(fn_t fn) : fn_(std::move(fn))
+    {
+    }
+
+    template <typename... args_t>
+    auto operator()(args_t&&... args)
+            -> decltype(try_call(std::declval<fn_t&>(), std::forward<args_t>(args)...))
+    {
+        return try_call(fn_, std::forward<args_t>(args)...);
+    }
+
+  private:
+
+    fn_t fn_;
+};
+
+} // namespace detail
+
+/**
+ * @brief Wrap a callable so that it returns a jack::result instead of
+ * throwing; each call goes through try_call.
+ *
+ * @code
+ * auto load = jack::nothrow(load_config);   // may throw
+ * jack::result<config> cfg = load(path);    // does not
+ * @endcode
+ *
+ * @param fn callable to wrap
+ * @return callable taking fn's arguments & returning a result
+ */
+template <typename fn_t>
+inline detail::nothrow_fn<typename std::decay<fn_t>::type> nothrow(fn_t&& fn)
+{
+    return detail::nothrow_fn<typename std::decay<fn_t>::type>(
+            std::forward<fn_t>(fn));
+}
+
+} // namespace jack
+
+#endif // #ifndef INCLUDE_JACK_EXCEPTION_HPP
@@ -0,0 +1,499 @@
+// MIT License
+//
+// Copyright (c) 2022 Jack Allen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INCLUDE_JACK_RENDER_HPP
+#define INCLUDE_JACK_RENDER_HPP
+
+#include "error.hpp"
+
+#include <algorithm>
+
+// escapable bytes are found 32 or 16 at a time when the target has AVX2
+// or SSE2, and 8 at a time otherwise; define JACK_ERROR_NO_SIMD to use
+// the portable search only
+#ifndef JACK_ERROR_NO_SIMD
+#if defined(__AVX2__)
+#define JACK_DETAIL_ESCAPE_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JACK_DETAIL_ESCAPE_SSE2
+#endif
+#endif
+
+#if defined(JACK_DETAIL_ESCAPE_AVX2)
+#include <immintrin.h>
+#elif defined(JACK_DETAIL_ESCAPE_SSE2)
+#include <emmintrin.h>
+#endif
+#if defined(JACK_DETAIL_ESCAPE_SSE2) && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace jack
+{
+
+namespace detail
+{
+
+/**
+ * @brief Check whether a byte must be escaped inside a quoted JSON or
+ * logfmt string: quotes, backslashes & control characters.
+ */
+inline bool needs_escape(unsigned char c) noexcept
+{
+    return c < 0x20 || c == '"' || c == '\\';
+}
+
+/**
+ * @brief Find the first byte that needs escaping, one byte at a time.
+ * The reference the faster searches are tested against.
+ *
+ * @return pointer to the byte, or end if there is none
+ */
+inline const char* find_escape_scalar(const char* p, const char* end) noexcept
+{
+    while (p != end && !needs_escape(static_cast<unsigned char>(*p)))
+    {
+        ++p;
+    }
+    return p;
+}
+
+/**
+ * @brief Find the first byte that needs escaping, checking 8 at a time
+ * in a 64-bit integer.
+ *
+ * @return pointer to the byte, or end if there is none
+ */
+inline const char* find_escape_swar(const char* p, const char* end) noexcept
+{
+    constexpr std::uint64_t ones = 0x0101010101010101ull;
+    constexpr std::uint64_t highs = 0x8080808080808080ull;
+    for (; end - p >= 8; p += 8)
+    {
+        std::uint64_t v;
+        std::memcpy(&v, p, 8);
+        // a high bit is set in a byte below 0x20 & in a zero byte of the
+        // words xored with '"' & '\\'; bytes after a hit may be set too,
+        // so the word is searched again one byte at a time
+        const std::uint64_t quote = v ^ (ones * '"');
+        const std::uint64_t backslash = v ^ (ones * '\\');
+        const std::uint64_t hit = ((v - ones * 0x20) | (quote - ones) |
+                (backslash - ones)) & ~v & highs;
+        if (hit)
+        {
+            return find_escape_scalar(p, p + 8);
+        }
+    }
+    return find_escape_scalar(p, end);
+}
+
+#ifdef JACK_DETAIL_ESCAPE_SSE2
+/// @brief Index of the lowest set bit of a non-zero mask.
+inline unsigned lowest_bit(unsigned mask) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long i;
+    _BitScanForward(&i, mask);
+    return static_cast<unsigned>(i);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+/**
+ * @brief Find the first byte that needs escaping, 16 at a time.
+ *
+ * @return pointer to the byte, or end if there is none
+ */
+inline const char* find_escape_sse2(const char* p, const char* end) noexcept
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1f);
+    for (; end - p >= 16; p += 16)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        // unsigned v <= 0x1f exactly when min(v, 0x1f) == v
+        const __m128i hit = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+        if (mask)
+        {
+            return p + lowest_bit(mask);
+        }
+    }
+    return find_escape_swar(p, end);
+}
+#endif
+
+#ifdef JACK_DETAIL_ESCAPE_AVX2
+/**
+ * @brief Find the first byte that needs escaping, 32 at a time.
+ *
+ * @return pointer to the byte, or end if there is none
+ */
+inline const char* find_escape_avx2(const char* p, const char* end) noexcept
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control = _mm256_set1_epi8(0x1f);
+    for (; end - p >= 32; p += 32)
+    {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i hit = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, quote),
+                        _mm256_cmpeq_epi8(v, backslash)),
+                _mm256_cmpeq_epi8(_mm256_min_epu8(v, control), v));
+        const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hit));
+        if (mask)
+        {
+            return p + lowest_bit(mask);
+        }
+    }
+    return find_escape_sse2(p, end);
+}
+#endif
+
+/**
+ * @brief Find the first byte that needs escaping with the widest
+ * instructions the target was compiled for.
+ *
+ * @return pointer to the byte, or end if there is none
+ */
+inline const char* find_escape(const char* p, const char* end) noexcept
+{
+#if defined(JACK_DETAIL_ESCAPE_AVX2)
+    return find_escape_avx2(p, end);
+#elif defined(JACK_DETAIL_ESCAPE_SSE2)
+    return find_escape_sse2(p, end);
+#else
+    return find_escape_swar(p, end);
+#endif
+}
+
+/**
+ * @brief Get the two-character escape of a byte, e.g. 'n' for a
+ * newline, or 0 if it is written as \u00XX.
+ */
+inline char short_escape(unsigned char c) noexcept
+{
+    switch (c)
+    {
+        case '"': return '"';
+        case '\\': return '\\';
+        case '\b': return 'b';
+        case '\f': return 'f';
+        case '\n': return 'n';
+        case '\r': return 'r';
+        case '\t': return 't';
+        default: return 0;
+    }
+}
+
+/**
+ * @brief Get the number of characters a run of bytes takes once
+ * escaped.
+ */
+inline std::size_t escaped_size(const char* data, std::size_t size) noexcept
+{
+    const char* const end = data + size;
+    std::size_t n = size;
+    for (const char* p = find_escape(data, end); p != end;
+            p = find_escape(p + 1, end))
+    {
+        n += short_escape(static_cast<unsigned char>(*p)) ? 1 : 5;
+    }
+    return n;
+}
+
+/**
+ * @brief Write a run of bytes with quotes, backslashes & control
+ * characters escaped.  Other bytes, including those of multi-byte UTF-8
+ * sequences, are copied as they are.
+ *
+ * @return one past the last character written
+ */
+template <typename out_t>
+inline out_t write_escaped(const char* data, std::size_t size, out_t out)
+{
+    static const char hex[] = "0123456789abcdef";
+    const char* const end = data + size;
+    for (;;)
+    {
+        const char* const p = find_escape(data, end);
+        out = std::copy(data, p, out);
+        if (p == end)
+        {
+            return out;
+        }
+        const unsigned char c = static_cast<unsigned char>(*p);
+        *out++ = '\\';
+        if (const char e = short_escape(c))
+        {
+            *out++ = e;
+        }
+        else
+        {
+            *out++ = 'u';
+            *out++ = '0';
+            *out++ = '0';
+            *out++ = hex[c >> 4];
+            *out++ = hex[c & 0xf];
+        }
+        data = p + 1;
+    }
+}
+
+/**
+ * @brief The fixed text around the fields of a rendered error.
+ */
+struct record_layout
+{
+    literal open;
+    literal root_code;
+    literal desc;
+    literal close;
+};
+
+template <typename alloc_t, std::size_t n, typename visitor_t>
+inline void for_each_desc_piece(const basic_reason<alloc_t, n>& desc,
+        visitor_t&& visit)
+{
+    reason_access::for_each_raw_piece(desc, visit);
+}
+
+template <std::size_t n, typename visitor_t>
+inline void for_each_desc_piece(const inplace_reason<n>& desc, visitor_t&& visit)
+{
+    visit(desc.c_str(), desc.size());
+}
+
+/**
+ * @brief Get the root cause code of an error when it differs from its
+ * code, i.e. it was wrapped with wrap_as.
+ */
+template <typename alloc_t>
+inline bool distinct_root_code(const basic_error<alloc_t>& error, int& root) noexcept
+{
+    root = error.root_code();
+    return error.desc.coded();
+}
+
+template <std::size_t n>
+inline bool distinct_root_code(const inplace_error<n>&, int&) noexcept
+{
+    return false;
+}
+
+template <typename t>
+struct is_renderable : std::false_type {};
+
+template <typename alloc_t>
+struct is_renderable<basic_error<alloc_t>> : std::true_type {};
+
+template <std::size_t n>
+struct is_renderable<inplace_error<n>> : std::true_type {};
+
+template <typename error_t>
+inline std::size_t record_size(const record_layout& layout, const error_t& error)
+{
+    std::size_t n = layout.open.size + piece<int>(error.code).size() +
+            layout.desc.size + layout.close.size;
+    int root;
+    if (distinct_root_code(error, root))
+    {
+        n += layout.root_code.size + piece<int>(root).size();
+    }
+    for_each_desc_piece(error.desc, [&](const char* data, std::size_t size) {
+        n += escaped_size(data, size);
+    });
+    return n;
+}
+
+template <typename out_t>
+inline out_t write_int(int value, out_t out)
+{
+    char digits[std::numeric_limits<int>::digits10 + 2];
+    return std::copy(digits, piece<int>(value).write(digits), out);
+}
+
+template <typename out_t>
+inline out_t write_literal(const literal& text, out_t out)
+{
+    return std::copy(text.data, text.data + text.size, out);
+}
+
+template <typename error_t, typename out_t>
+inline out_t write_record(const record_layout& layout, const error_t& error,
+        out_t out)
+{
+    out = write_int(error.code, write_literal(layout.open, out));
+    int root;
+    if (distinct_root_code(error, root))
+    {
+        out = write_int(root, write_literal(layout.root_code, out));
+    }
+    out = write_literal(layout.desc, out);
+    for_each_desc_piece(error.desc, [&](const char* data, std::size_t size) {
+        out = write_escaped(data, size, out);
+    });
+    return write_literal(layout.close, out);
+}
+
+template <typename error_t>
+inline std::size_t write_record(const record_layout& layout, const error_t& error,
+        char* buf, std::size_t size)
+{
+    const std::size_t total = record_size(layout, error);
+    if (total > size)
+    {
+        return 0;
+    }
+    write_record(layout, error, buf);
+    return total;
+}
+
+inline record_layout json_layout() noexcept
+{
+    return {literal("{\"code\":"), literal(",\"root_code\":"),
+            literal(",\"desc\":\""), literal("\"}")};
+}
+
+inline record_layout logfmt_layout() noexcept
+{
+    return {literal("code="), literal(" root_code="), literal(" desc=\""),
+            literal("\"")};
+}
+
+} // namespace detail
+
+/**
+ * @brief Structured renderings of an error (jack::error or
+ * jack::inplace_error) for log pipelines, with the description escaped.
+ * Nothing is allocated: the description is read straight from the
+ * error's frames, and quotes, backslashes & control characters are found
+ * with SSE2 or AVX2 when the target has them.  Other bytes are copied as
+ * they are, so the output is valid UTF-8 when the description is.
+ *
+ * Records are not null-terminated & have no trailing newline.  The root
+ * cause code is only present when the error was wrapped with wrap_as.
+ */
+namespace render
+{
+
+/**
+ * @brief Get the exact size of an error rendered as a JSON object:
+ * {"code":<code>,"root_code":<root code>,"desc":"<description>"}
+ *
+ * @param error error to measure
+ * @return number of characters json writes
+ */
+template <typename error_t, typename = typename
+        std::enable_if<detail::is_renderable<error_t>::value>::type>
+inline std::size_t json_size(const error_t& error)
+{
+    return detail::record_size(detail::json_layout(), error);
+}
+
+/**
+ * @brief Render an error as a JSON object into a caller-provided buffer.
+ *
+ * @param error error to render
+ * @param buf buffer to write to
+ * @param size number of characters available in buf
+ * @return number of characters written, or 0 (nothing written) if buf is
+ * too small
+ */
+template <typename error_t, typename = typename
+        std::enable_if<detail::is_renderable<error_t>::value>::type>
+inline std::size_t json(const error_t& error, char* buf, std::size_t size)
+{
+    return detail::write_record(detail::json_layout(), error, buf, size);
+}
+
+/**
+ * @brief Render an error as a JSON object through an output iterator,
+ * e.g. std::back_inserter of a string.
+ *
+ * @param error error to render
+ * @param out iterator to write characters to
+ * @return iterator past the last character written
+ */
+template <typename error_t, typename out_t, typename = typename
+        std::enable_if<detail::is_renderable<error_t>::value>::type>
+inline out_t json(const error_t& error, out_t out)
+{
+    return detail::write_record(detail::json_layout(), error, out);
+}
+
+/**
+ * @brief Get the exact size of an error rendered as a logfmt line:
+ * code=<code> root_code=<root code> desc="<description>"
+ *
+ * @param error error to measure
+ * @return number of characters logfmt writes
+ */
+template <typename error_t, typename = typename
+        std::enable_if<detail::is_renderable<error_t>::value>::type>
+inline std::size_t logfmt_size(const error_t& error)
+{
+    return detail::record_size(detail::logfmt_layout(), error);
+}
+
+/**
+ * @brief Render an error as a logfmt line into a caller-provided buffer.
+ *
+ * @param error error to render
+ * @param buf buffer to write to
+ * @param size number of characters available in buf
+ * @return number of characters written, or 0 (nothing written) if buf is
+ * too small
+ */
+template <typename error_t, typename = typename
+        std::enable_if<detail::is_renderable<error_t>::value>::type>
+inline std::size_t logfmt(const error_t& error, char* buf, std::size_t size)
+{
+    return detail::write_record(detail::logfmt_layout(), error, buf, size);
+}
+
+/**
+ * @brief Render an error as a logfmt line through an output iterator.
+ *
+ * @param error error to render
+ * @param out iterator to write characters to
+ * @return iterator past the last character written
+ */
+template <typename error_t, typename out_t, typename = typename
+        std::enable_if<detail::is_renderable<error_t>::value>::type>
+inline out_t logfmt(const error_t& error, out_t out)
+{
+    return detail::write_record(detail::logfmt_layout(), error, out);
+}
+
+} // namespace render
+
+} // namespace jack
+
+#endif // #ifndef
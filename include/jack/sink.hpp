@@ -0,0 +1,511 @@
+// MIT License
+//
+// Copyright (c) 2022 Jack Allen
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INCLUDE_JACK_SINK_HPP
+#define INCLUDE_JACK_SINK_HPP
+
+#include "error.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <cerrno>
+#include <climits>
+
+#if defined(_WIN32)
+#error "jack/sink.hpp requires POSIX writev"
+#endif
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace jack
+{
+
+/**
+ * @brief What push does when a sink's buffer is full.
+ */
+enum class backpressure
+{
+    /// @brief Discard the error & return false right away.
+    drop,
+
+    /// @brief Wait for the flusher to make room.
+    block
+};
+
+/**
+ * @brief Settings for a sink.
+ */
+struct sink_options
+{
+    /// @brief Errors the buffer holds; rounded up to a power of two.
+    std::size_t capacity = 4096;
+
+    /// @brief Behaviour of push when the buffer is full.
+    backpressure when_full = backpressure::drop;
+
+    /// @brief Most errors taken from the buffer for one round of writes.
+    std::size_t batch = 256;
+
+    /// @brief Longest the flusher sleeps while the buffer is filling.
+    std::chrono::milliseconds flush_interval = std::chrono::milliseconds(10);
+};
+
+/**
+ * @brief Writes errors to a file descriptor from a background thread, so
+ * that formatting & I/O stay off the thread that failed.  push moves an
+ * error into a bounded, lock-free buffer that any number of threads may
+ * push to at once.  One flusher thread takes errors from the buffer in
+ * batches, formats each one as a debug::str line, and writes a batch
+ * with as few writev calls as it can, pointing straight at the
+ * description's pieces instead of copying them.  Deferred descriptions
+ * are formatted on the flusher thread.
+ *
+ * The flusher wakes every flush_interval, once a quarter of the buffer
+ * has filled, on flush(), and when a blocked push is waiting for room.
+ * The destructor writes everything already pushed before it returns.
+ *
+ * @code
+ * jack::sink log(STDERR_FILENO);
+ * ...
+ * if (auto err = handle(request))
+ *     log.push(std::move(*err));
+ * @endcode
+ *
+ * Requires POSIX.
+ *
+ * @tparam alloc_t allocator of the errors
+ */
+template <typename alloc_t = std::allocator<char>>
+class basic_sink
+{
+  public:
+
+    /// @brief Errors accepted by push.
+    using error_type = basic_error<alloc_t>;
+
+    /**
+     * @brief Start a flusher thread writing to a file descriptor.
+     *
+     * @param fd descriptor to write to; it is not closed by the sink &
+     * must stay open until the sink is destroyed
+     * @param options buffer size, backpressure & batching
+     */
+    explicit basic_sink(int fd, const sink_options& options = sink_options()) :
+            fd_(fd), options_(options), mask_(round_up(options.capacity) - 1),
+            wake_mask_(std::max<std::size_t>(1, (mask_ + 1) / 4) - 1),
+            slots_(new slot[mask_ + 1])
+    {
+        if (options_.batch == 0)
+        {
+            options_.batch = 1;
+        }
+        for (std::size_t i = 0; i <= mask_; ++i)
+        {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+        batch_.reserve(options_.batch);
+        heads_.reset(new char[options_.batch * head_size]);
+        iov_.reserve(iov_max);
+        flusher_ = std::thread([this] { run(); });
+    }
+
+    basic_sink(const basic_sink&) = delete;
+    basic_sink& operator=(const basic_sink&) = delete;
+
+    /**
+     * @brief Write every error already pushed, then stop the flusher.  No
+     * push may be in progress or start once destruction has begun.
+     */
+    ~basic_sink()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        ready_.notify_one();
+        flusher_.join();
+    }
+
+    /**
+     * @brief Hand an error to the flusher.  Safe to call from any number
+     * of threads at once.
+     *
+     * @param error error to move from
+     * @return false if the buffer was full & the error was dropped
+     */
+    bool push(error_type&& error)
+    {
+        bool overflowed = false;
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        slot* s;
+        for (;;)
+        {
+            s = &slots_[pos & mask_];
+            const std::size_t seq = s->seq.load(std::memory_order_acquire);
+            if (seq == pos)
+            {
+                if (tail_.compare_exchange_weak(pos, pos + 1,
+                        std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (static_cast<std::ptrdiff_t>(seq - pos) < 0)
+            {
+                // the slot still holds the error from one lap ago
+                if (!overflowed)
+                {
+                    overflowed = true;
+                    overflows_.fetch_add(1, std::memory_order_relaxed);
+                    if (options_.when_full == backpressure::drop)
+                    {
+                        dropped_.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                    wake();
+                }
+                std::this_thread::yield();
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+            else
+            {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+
+        ::new (static_cast<void*>(s->storage)) error_type(std::move(error));
+        s->seq.store(pos + 1, std::memory_order_release);
+        if ((pos & wake_mask_) == wake_mask_)
+        {
+            wake();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Wait until every error pushed before the call has been
+     * written (or has failed to be).
+     */
+    void flush()
+    {
+        const std::size_t target = tail_.load(std::memory_order_acquire);
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (flush_to_ < target)
+        {
+            flush_to_ = target;
+        }
+        ready_.notify_one();
+        flushed_.wait(lock, [this, target] { return done_ >= target; });
+    }
+
+    /// @brief Errors written so far.
+    std::uint64_t written() const noexcept
+    {
+        return written_.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Errors push discarded because the buffer was full.
+    std::uint64_t dropped() const noexcept
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Pushes that found the buffer full, whether they then
+    /// dropped the error or waited.
+    std::uint64_t overflows() const noexcept
+    {
+        return overflows_.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Errors lost because writing to the descriptor failed.
+    std::uint64_t failed() const noexcept
+    {
+        return failed_.load(std::memory_order_relaxed);
+    }
+
+  private:
+
+    /// @brief Room for "error { code: <int>, desc: \"".
+    static constexpr std::size_t head_size = 48;
+
+#ifdef IOV_MAX
+    static constexpr std::size_t iov_max = IOV_MAX;
+#else
+    static constexpr std::size_t iov_max = 16;
+#endif
+
+    /**
+     * @brief One buffer entry.  seq is the position the slot can next be
+     * claimed at; one past that once it holds an error.
+     */
+    struct slot
+    {
+        std::atomic<std::size_t> seq;
+        alignas(error_type) unsigned char storage[sizeof(error_type)];
+
+        error_type& get() noexcept
+        {
+            return *reinterpret_cast<error_type*>(storage);
+        }
+    };
+
+    static std::size_t round_up(std::size_t n) noexcept
+    {
+        std::size_t size = 2;
+        while (size < n)
+        {
+            size *= 2;
+        }
+        return size;
+    }
+
+    void wake()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            wake_ = true;
+        }
+        ready_.notify_one();
+    }
+
+    void run()
+    {
+        for (;;)
+        {
+            bool stopping;
+            bool flushing;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ready_.wait_for(lock, options_.flush_interval, [this] {
+                    return stop_ || wake_ || flush_to_ > done_;
+                });
+                wake_ = false;
+                stopping = stop_;
+                flushing = flush_to_ > done_;
+            }
+
+            std::size_t taken;
+            while ((taken = take()) != 0)
+            {
+                write_batch();
+                std::lock_guard<std::mutex> lock(mutex_);
+                done_ = head_;
+                flushed_.notify_all();
+                if (taken < options_.batch)
+                {
+                    break;
+                }
+            }
+
+            if (stopping && head_ == tail_.load(std::memory_order_acquire))
+            {
+                return;
+            }
+            if (stopping || flushing)
+            {
+                // a push has claimed a slot but not filled it yet
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /**
+     * @brief Move up to a batch of errors out of the buffer.
+     *
+     * @return number of errors taken
+     */
+    std::size_t take() noexcept
+    {
+        while (batch_.size() < options_.batch)
+        {
+            slot& s = slots_[head_ & mask_];
+            if (s.seq.load(std::memory_order_acquire) != head_ + 1)
+            {
+                break;
+            }
+            batch_.push_back(std::move(s.get()));
+            s.get().~error_type();
+            s.seq.store(head_ + mask_ + 1, std::memory_order_release);
+            ++head_;
+        }
+        return batch_.size();
+    }
+
+    /**
+     * @brief Write & release every taken error.  Each error is a head,
+     * the pieces of its description, and a tail; deeply wrapped errors
+     * are rendered first so one always fits in a single writev.
+     */
+    void write_batch()
+    {
+        static constexpr const char tail[] = "\" }\n";
+
+        std::size_t pending = 0;
+        for (std::size_t i = 0; i < batch_.size(); ++i)
+        {
+            error_type& err = batch_[i];
+            const std::size_t pieces =
+                    3 + 2 * detail::reason_access::frame_count(err.desc);
+            const bool render = pieces > iov_max;
+            if (iov_.size() + (render ? 3 : pieces) > iov_max)
+            {
+                write_out(pending);
+                pending = 0;
+            }
+
+            char* head = &heads_[i * head_size];
+            const int n = std::snprintf(head, head_size,
+                    "error { code: %d, desc: \"", err.code);
+            add(head, static_cast<std::size_t>(n));
+            if (render)
+            {
+                add(err.desc.c_str(), err.desc.size());
+            }
+            else
+            {
+                detail::reason_access::for_each_piece(err.desc,
+                        [this](const char* data, std::size_t size) {
+                            add(data, size);
+                        });
+            }
+            add(tail, sizeof(tail) - 1);
+            ++pending;
+        }
+        write_out(pending);
+        batch_.clear();
+    }
+
+    void add(const char* data, std::size_t size)
+    {
+        if (size != 0)
+        {
+            iov_.push_back({const_cast<char*>(data), size});
+        }
+    }
+
+    /**
+     * @brief writev everything gathered so far, resuming after short
+     * writes.
+     *
+     * @param errors number of errors the gathered pieces belong to
+     */
+    void write_out(std::size_t errors)
+    {
+        iovec* iov = iov_.data();
+        int count = static_cast<int>(iov_.size());
+        while (count > 0)
+        {
+            const ssize_t n = ::writev(fd_, iov, count);
+            if (n < 0)
+            {
+                if (errno == EINTR || errno == EAGAIN)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                failed_.store(failed_.load(std::memory_order_relaxed) + errors,
+                        std::memory_order_relaxed);
+                iov_.clear();
+                return;
+            }
+            std::size_t left = static_cast<std::size_t>(n);
+            while (count > 0 && left >= iov->iov_len)
+            {
+                left -= iov->iov_len;
+                ++iov;
+                --count;
+            }
+            if (count > 0)
+            {
+                iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+                iov->iov_len -= left;
+            }
+        }
+        written_.store(written_.load(std::memory_order_relaxed) + errors,
+                std::memory_order_relaxed);
+        iov_.clear();
+    }
+
+    const int fd_;
+    sink_options options_;
+    const std::size_t mask_;
+    const std::size_t wake_mask_;
+    std::unique_ptr<slot[]> slots_;
+
+    // claimed by producers; kept off the flusher's cache lines
+    char pad0_[64];
+    std::atomic<std::size_t> tail_{0};
+    char pad1_[64];
+
+    // flusher only
+    std::size_t head_ = 0;
+    std::vector<error_type> batch_;
+    std::unique_ptr<char[]> heads_;
+    std::vector<iovec> iov_;
+
+    std::atomic<std::uint64_t> written_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::uint64_t> overflows_{0};
+    std::atomic<std::uint64_t> failed_{0};
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::condition_variable flushed_;
+    bool stop_ = false;
+    bool wake_ = false;
+    std::size_t flush_to_ = 0;
+    std::size_t done_ = 0;
+
+    std::thread flusher_;
+};
+
+template <typename alloc_t>
+constexpr std::size_t basic_sink<alloc_t>::head_size;
+
+template <typename alloc_t>
+constexpr std::size_t basic_sink<alloc_t>::iov_max;
+
+/**
+ * @brief Sink of errors using std::allocator.
+ */
+using sink = basic_sink<>;
+
+#ifdef JACK_DETAIL_HAS_PMR
+namespace pmr
+{
+
+/**
+ * @brief Sink of errors whose storage comes from a
+ * std::pmr::memory_resource.
+ */
+using sink = basic_sink<std::pmr::polymorphic_allocator<char>>;
+
+} // namespace pmr
+#endif
+
+} // namespace jack
+
+#endif // #ifndef
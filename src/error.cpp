@@ -0,0 +1,30 @@
+// Compiled part of jack::error, built by the jack-error CMake target.
+// Every translation unit that uses the library sees JACK_ERROR_COMPILED
+// and leaves these definitions to this one.
+
+#ifndef JACK_ERROR_COMPILED
+#define JACK_ERROR_COMPILED
+#endif
+
+#include "jack/error.hpp"
+
+#include <sstream>
+
+namespace jack
+{
+
+namespace detail
+{
+
+std::string stream_str(void (*put)(std::ostream&, const void*), const void* value)
+{
+    std::ostringstream ss;
+    put(ss, value);
+    return ss.str();
+}
+
+} // namespace detail
+
+JACK_DETAIL_INSTANTIATE()
+
+} // namespace jack
@@ -0,0 +1,83 @@
+// jack.error, the C++20 module of jack/error.hpp: import jack.error;
+//
+// The header is included in the global module fragment & its public names
+// are exported from here.  Macros cannot be exported; code that uses
+// JACK_FMT or JACK_ERROR_* options includes jack/error.hpp as well, with
+// the same definitions the module was built with.  The add-on headers,
+// jack/sink.hpp & jack/render.hpp, are not part of the module.
+
+module;
+
+#include "jack/error.hpp"
+
+export module jack.error;
+
+export namespace jack
+{
+
+using jack::literal;
+using jack::deferred_t;
+using jack::deferred;
+using jack::location;
+using jack::context;
+using jack::formatter;
+using jack::basic_reason;
+using jack::reason;
+using jack::basic_error;
+using jack::error;
+using jack::derror;
+using jack::result;
+using jack::segment;
+using jack::segments;
+using jack::error_view;
+using jack::basic_error_list;
+using jack::error_list;
+using jack::inplace_reason;
+using jack::inplace_error;
+using jack::operator<<;
+
+using jack::severity;
+using jack::code_info;
+using jack::code_catalog;
+using jack::is_cataloged_v;
+using jack::find_code;
+using jack::code_name;
+using jack::code_message;
+using jack::code_severity;
+using jack::catalog_category;
+using jack::make_error_code;
+
+#ifdef JACK_DETAIL_HAS_PMR
+namespace pmr
+{
+using jack::pmr::reason;
+using jack::pmr::error;
+using jack::pmr::error_list;
+} // namespace pmr
+#endif
+
+#ifdef JACK_ERROR_METRICS
+namespace metrics
+{
+using jack::metrics::code_stats;
+using jack::metrics::snapshot;
+using jack::metrics::collect;
+} // namespace metrics
+#endif
+
+namespace wire
+{
+using jack::wire::version;
+using jack::wire::header_size;
+using jack::wire::frame_size;
+using jack::wire::max_size;
+using jack::wire::encoded_size;
+using jack::wire::encode;
+} // namespace wire
+
+namespace debug
+{
+using jack::debug::str;
+} // namespace debug
+
+} // namespace jack
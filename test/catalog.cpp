@@ -0,0 +1,104 @@
+#include <cstring>
+
+// let catch define main
+#define CATCH_CONFIG_MAIN
+
+#include "catch2/catch.hpp"
+#include "jack/error.hpp"
+
+#if __cplusplus >= 201703L
+#include <memory_resource>
+
+namespace jack
+{
+inline bool operator==(const jack::reason& lhs, const char* rhs)
+{
+    return !strcmp(lhs.c_str(), rhs);
+}
+}
+
+namespace db
+{
+
+enum class errc { timeout = 1001, refused, corrupt };
+
+using jack::make_error_code;
+
+} // namespace db
+
+template <>
+struct jack::code_catalog<db::errc>
+{
+    static constexpr jack::literal domain = "db";
+    static constexpr jack::code_info<db::errc> entries[] = {
+        {db::errc::timeout, "timeout", "operation timed out", jack::severity::warning},
+        {db::errc::refused, "refused", "connection refused", jack::severity::error},
+        {db::errc::corrupt, "corrupt", "page checksum mismatch", jack::severity::critical},
+    };
+};
+
+template <>
+struct std::is_error_code_enum<db::errc> : std::true_type
+{
+};
+
+// lookups happen while compiling
+static_assert(jack::code_severity(db::errc::corrupt) == jack::severity::critical);
+static_assert(jack::code_name(db::errc::refused).size == 7);
+static_assert(jack::find_code(static_cast<db::errc>(1000)) == nullptr);
+static_assert(jack::is_cataloged_v<db::errc> && !jack::is_cataloged_v<int>);
+
+TEST_CASE("catalog lookup", "[catalog.lookup]")
+{
+    REQUIRE(!std::strcmp(jack::code_name(db::errc::timeout).data, "timeout"));
+    REQUIRE(!std::strcmp(jack::code_message(db::errc::corrupt).data,
+            "page checksum mismatch"));
+    REQUIRE(jack::find_code(db::errc::refused)->code == db::errc::refused);
+
+    // codes outside the catalog
+    const auto unknown = static_cast<db::errc>(2000);
+    REQUIRE(!std::strcmp(jack::code_name(unknown).data, "unknown"));
+    REQUIRE(jack::code_severity(unknown) == jack::severity::error);
+}
+
+TEST_CASE("error from catalog code", "[catalog.error]")
+{
+    // refers to the catalog's message
+    jack::error e0(db::errc::refused);
+    REQUIRE(e0.code == 1002);
+    REQUIRE(e0.desc.c_str() == jack::code_message(db::errc::refused).data);
+
+    // or one of its own
+    jack::error e1(db::errc::timeout, "no reply after ", 30, "s");
+    REQUIRE(e1.code == 1001);
+    REQUIRE(e1.desc == "no reply after 30s");
+
+    // nothing is allocated
+    auto* const prev = std::pmr::set_default_resource(
+            std::pmr::null_memory_resource());
+    jack::pmr::error e2(db::errc::corrupt);
+    REQUIRE(e2.desc.c_str() == jack::code_message(db::errc::corrupt).data);
+    std::pmr::set_default_resource(prev);
+}
+
+TEST_CASE("catalog std::error_code interop", "[catalog.error_code]")
+{
+    // implicit conversion through make_error_code
+    const std::error_code ec = db::errc::timeout;
+    REQUIRE(ec.value() == 1001);
+    REQUIRE(!std::strcmp(ec.category().name(), "db"));
+    REQUIRE(ec.message() == "operation timed out");
+    REQUIRE(&ec.category() == &jack::catalog_category<db::errc>());
+
+    // errors take a catalog message without copying it
+    const jack::error e0(ec);
+    REQUIRE(e0.code == 1001);
+    REQUIRE(e0.desc.c_str() == jack::code_message(db::errc::timeout).data);
+
+    // & any other category's message is copied
+    const jack::error e1(std::make_error_code(std::errc::invalid_argument));
+    REQUIRE(e1.code == static_cast<int>(std::errc::invalid_argument));
+    REQUIRE(e1.desc == std::generic_category().message(e1.code).c_str());
+}
+
+#endif // __cplusplus >= 201703L
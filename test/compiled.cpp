@@ -0,0 +1,67 @@
+#include <cstring>
+#include <ostream>
+#include <string>
+
+// let catch define main
+#define CATCH_CONFIG_MAIN
+
+// built against the jack-error library, which defines JACK_ERROR_COMPILED
+#include "catch2/catch.hpp"
+#include "jack/error.hpp"
+
+namespace jack 
+{
+inline bool operator==(const jack::reason& lhs, const char* rhs)
+{
+    return !strcmp(lhs.c_str(), rhs);
+}
+}
+
+namespace
+{
+struct endpoint
+{
+    std::string host;
+    int port;
+};
+
+std::ostream& operator<<(std::ostream& os, const endpoint& e)
+{
+    return os << e.host << ':' << e.port;
+}
+}
+
+TEST_CASE("compiled members", "[compiled.members]")
+{
+#ifndef JACK_ERROR_COMPILED
+    FAIL("JACK_ERROR_COMPILED is not defined");
+#endif
+
+    // arguments of the instantiated kinds & of others
+    jack::error e0(7, "cannot open ", std::string("routes.json"));
+    e0.wrap("attempt ", 2, " of ", std::size_t{3});
+    e0.extend("after ", 1.5, 's');
+    e0.wrap_as(8, "loading ", "routes");
+    REQUIRE(e0.desc == "loading routes: attempt 2 of 3: cannot open "
+            "routes.json: after 1.5s");
+    REQUIRE(jack::debug::str(e0) == "error { code: 8, desc: \"loading routes: "
+            "attempt 2 of 3: cannot open routes.json: after 1.5s\" }");
+
+    // the operator<< fallback lives in the library
+    jack::error e1(1, "connection reset by ", endpoint{"10.0.0.1", 443});
+    REQUIRE(e1.desc == "connection reset by 10.0.0.1:443");
+
+    // limit, copies & moves
+    jack::reason r0("root");
+    r0.limit(2);
+    for (int i = 1; i <= 5; ++i)
+    {
+        r0.wrap("w", i);
+    }
+    REQUIRE(r0 == "w5: [... 3 frames elided ...]: w1: root");
+    jack::reason r1(r0);
+    jack::reason r2(std::move(r0));
+    r0 = "reused";
+    REQUIRE(r1 == r2.c_str());
+    REQUIRE(r0 == "reused");
+}
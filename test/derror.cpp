@@ -0,0 +1,95 @@
+#include <cstring>
+
+// let catch define main
+#define CATCH_CONFIG_MAIN
+
+#include "catch2/catch.hpp"
+#include "jack/error.hpp"
+
+namespace jack 
+{
+inline bool operator==(const jack::reason& lhs, const char* rhs)
+{
+    return !strcmp(lhs.c_str(), rhs);
+}
+}
+
+static jack::derror may_fail(bool fail)
+{
+    if (fail)
+    {
+        return {1001, "failed w/ val ", 7};
+    }
+    return {};
+}
+
+TEST_CASE("derror size", "[derror.size]")
+{
+    REQUIRE(sizeof(jack::derror) == sizeof(void*));
+}
+
+TEST_CASE("derror constructors", "[derror.constructors]")
+{
+    // success
+    jack::derror d0;
+    REQUIRE(!d0);
+
+    // code & variadic reason
+    jack::derror d1(101, "a fail reason w/ value ", 100);
+    REQUIRE(d1);
+    REQUIRE(d1->code == 101);
+    REQUIRE(d1->desc == "a fail reason w/ value 100");
+
+    // copy & move from error
+    jack::error e(202, "another fail reason");
+    jack::derror d2(e);
+    REQUIRE(d2->code == 202);
+    REQUIRE(d2->desc == "another fail reason");
+    jack::derror d3(std::move(e));
+    REQUIRE((*d3).code == 202);
+    REQUIRE((*d3).desc == "another fail reason");
+
+    // copy constructor; other derror
+    jack::derror d4(d1);
+    REQUIRE(d4->code == 101);
+    REQUIRE(&*d4 != &*d1);
+    jack::derror d5(d0);
+    REQUIRE(!d5);
+
+    // move constructor; other derror
+    const jack::error* held = &*d4;
+    jack::derror d6(std::move(d4));
+    REQUIRE(&*d6 == held);
+    REQUIRE(!d4);
+
+    // returned from a function
+    REQUIRE(!may_fail(false));
+    REQUIRE(may_fail(true)->desc == "failed w/ val 7");
+}
+
+TEST_CASE("derror operator=", "[derror.assignment]")
+{
+    // copy assignment
+    jack::derror ds0(101, "a fail reason");
+    jack::derror dd0;
+    dd0 = ds0;
+    REQUIRE(dd0->code == 101);
+    REQUIRE(dd0->desc == "a fail reason");
+    dd0 = jack::derror();
+    REQUIRE(!dd0);
+
+    // move assignment
+    jack::derror ds1(101, "a fail reason");
+    jack::derror dd1(202, "replaced");
+    dd1 = std::move(ds1);
+    REQUIRE(dd1->code == 101);
+    REQUIRE(dd1->desc == "a fail reason");
+}
+
+TEST_CASE("derror::wrap & ::extend member functions", "[derror.wrap]")
+{
+    auto d0 = may_fail(true);
+    d0.wrap("more context").extend("more info");
+    REQUIRE(d0->code == 1001);
+    REQUIRE(d0->desc == "more context: failed w/ val 7: more info");
+}
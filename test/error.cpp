@@ -1,5 +1,10 @@
 
 #include <cstring>
+#include <string>
+#include <vector>
+#if __cplusplus >= 201703L
+#include <memory_resource>
+#endif
 
 // let catch define main
 #define CATCH_CONFIG_MAIN
@@ -64,6 +69,31 @@ TEST_CASE("error constructors", "[error.constructors]")
     REQUIRE(e7.desc == "some fail reason w/ val 100 plus more info");
 }
 
+TEST_CASE("error from literal", "[error.literal]")
+{
+    static const char msg[] = "connection refused";
+    jack::error e0(111, jack::literal(msg));
+    REQUIRE(e0.code == 111);
+    REQUIRE(e0.desc.c_str() == msg);
+
+    e0.wrap("while connecting");
+    REQUIRE(e0.desc == "while connecting: connection refused");
+    REQUIRE(jack::debug::str(e0) ==
+            "error { code: 111, desc: \"while connecting: connection refused\" }");
+}
+
+TEST_CASE("deferred error", "[error.deferred]")
+{
+    std::string host("10.0.0.1");
+    jack::error e0(111, jack::deferred, "connect to ", host, ':', 8080);
+    host.clear();
+    REQUIRE(e0.code == 111);
+
+    e0.wrap("while starting");
+    REQUIRE(jack::debug::str(e0) == "error { code: 111, desc: "
+            "\"while starting: connect to 10.0.0.1:8080\" }");
+}
+
 TEST_CASE("error operator=", "[error.assignment]")
 {
     // copy assignment
@@ -89,10 +119,122 @@ TEST_CASE("error::wrap member function", "[error.wrap]")
     REQUIRE(e0.desc == "more context: some fail reason");
 }
 
+TEST_CASE("error::trace member function", "[error.trace]")
+{
+    jack::error e0(jack::location{"a.cpp", "open", 3}, 10, "no such file");
+    REQUIRE(e0.code == 10);
+    REQUIRE(e0.desc == "a.cpp:3 in open: no such file");
+
+    e0.trace(jack::location{"b.cpp", "load", 12}).extend("cfg");
+    REQUIRE(e0.desc == "b.cpp:12 in load: a.cpp:3 in open: no such file: cfg");
+
+    jack::error e1(jack::location::current(), 11, "here");
+    REQUIRE(std::strncmp(e1.desc.c_str(), __FILE__, std::strlen(__FILE__)) == 0);
+}
+
 TEST_CASE("error::extend member function", "[error.extend]")
 {
     jack::error e0(10, "some fail reason");
     e0.extend("more info");
     REQUIRE(e0.code == 10);
     REQUIRE(e0.desc == "some fail reason: more info");
-}
\ No newline at end of file
+}
+
+TEST_CASE("error::wrap_as member function", "[error.wrap_as]")
+{
+    // the code is replaced, & the first kept as the root cause
+    jack::error e0(5, "disk full");
+    REQUIRE(e0.root_code() == 5);
+    e0.wrap("writing block ", 7).wrap_as(20, "saving ", "index");
+    e0.trace(jack::location{"db.cpp", "commit", 9}).wrap_as(30, "request 4");
+    e0.extend("giving up");
+    REQUIRE(e0.code == 30);
+    REQUIRE(e0.root_code() == 5);
+    REQUIRE(e0.desc == "request 4: db.cpp:9 in commit: saving index: "
+            "writing block 7: disk full: giving up");
+
+    // each context keeps its own code, innermost first
+    std::vector<std::string> texts;
+    std::vector<int> codes;
+    e0.desc.for_each_context([&](const jack::context& c) {
+        texts.push_back(c.data ? std::string(c.data, c.size) : c.where.function);
+        codes.push_back(c.coded ? c.code : -1);
+        REQUIRE(c.wrap == (texts.back() != "giving up"));
+    });
+    REQUIRE(texts == std::vector<std::string>{"writing block 7", "saving index",
+            "commit", "request 4", "giving up"});
+    REQUIRE(codes == std::vector<int>{-1, 20, -1, 30, -1});
+
+    // copies & moves carry both codes
+    jack::error e1(e0);
+    jack::error e2(std::move(e1));
+    REQUIRE(e2.code == 30);
+    REQUIRE(e2.root_code() == 5);
+    e2.wrap_as(40, "retrying");
+    REQUIRE(e2.root_code() == 5);
+
+    // elided contexts lose their codes but not the root cause
+    jack::error e3(1, "timeout");
+    e3.limit(2);
+    for (int i = 0; i < 10; ++i)
+    {
+        e3.wrap_as(100 + i, "attempt ", i);
+    }
+    REQUIRE(e3.code == 109);
+    REQUIRE(e3.root_code() == 1);
+    codes.clear();
+    e3.desc.for_each_context([&](const jack::context& c) {
+        codes.push_back(c.coded ? c.code : -1);
+    });
+    REQUIRE(codes == std::vector<int>{100, -1, 109});
+
+    // a code set directly is the root cause until wrap_as
+    jack::error e4(1, "x");
+    e4.code = 2;
+    REQUIRE(e4.root_code() == 2);
+}
+#if __cplusplus >= 201703L
+TEST_CASE("error format strings", "[error.fmt]")
+{
+    jack::error e0(10, JACK_FMT("bad value {:d} for {:s}"), -1, "timeout");
+    e0.wrap(JACK_FMT("loading {}"), "config").extend(JACK_FMT("{:f}s"), 0.5);
+    REQUIRE(e0.code == 10);
+    REQUIRE(e0.desc == "loading config: bad value -1 for timeout: 0.500000s");
+
+    REQUIRE(jack::debug::str(e0) == jack::debug::str(
+            JACK_FMT("error {{ code: {}, desc: \"{}\" }}"), e0.code, e0.desc));
+}
+#endif
+
+#if __cplusplus >= 201703L
+TEST_CASE("error w/ memory resource", "[error.pmr]")
+{
+    char buf[4096];
+    std::pmr::monotonic_buffer_resource res(buf, sizeof(buf),
+            std::pmr::null_memory_resource());
+    std::pmr::polymorphic_allocator<char> alloc(&res);
+    auto* const prev = std::pmr::set_default_resource(
+            std::pmr::null_memory_resource());
+
+    // containers pass their allocator along
+    std::pmr::vector<jack::pmr::error> errors(alloc);
+    errors.emplace_back(101, "a fail reason long enough to need the heap");
+    errors.emplace_back(102, "some fail reason w/ val ", 100);
+    errors.back().wrap("more context");
+    errors.push_back(errors.front());
+    REQUIRE(errors.size() == 3);
+    for (const auto& e : errors)
+    {
+        REQUIRE(e.get_allocator().resource() == &res);
+    }
+    REQUIRE(!strcmp(errors[1].desc.c_str(),
+            "more context: some fail reason w/ val 100"));
+
+    // debug strings share the error's allocator
+    const auto str = jack::debug::str(errors[1]);
+    REQUIRE(str.get_allocator().resource() == &res);
+    REQUIRE(str == "error { code: 102, desc: \"more context: some fail reason w/ val 100\" }");
+
+    std::pmr::set_default_resource(prev);
+}
+#endif
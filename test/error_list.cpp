@@ -0,0 +1,181 @@
+#include <cstring>
+#include <sstream>
+#include <thread>
+#if __cplusplus >= 201703L
+#include <memory_resource>
+#endif
+
+// let catch define main
+#define CATCH_CONFIG_MAIN
+
+#include "catch2/catch.hpp"
+#include "jack/error.hpp"
+
+static std::string desc(const jack::error_list& list, std::size_t i)
+{
+    return list.at(i).desc.c_str();
+}
+
+TEST_CASE("error_list keeps errors", "[error_list.push]")
+{
+    jack::error e0(101, "plain");
+    jack::error e1(102, jack::literal("refused"));
+    e1.wrap("connecting").extend("attempt ", 3);
+    jack::error e2(103, jack::deferred, "read ", 10, " bytes");
+    e2.wrap("loading");
+
+    jack::error_list list;
+    REQUIRE(list.empty());
+    list.push_back(e0);
+    list.push_back(e1);
+    list.push_back(e2);
+    list.emplace_back(104, "field ", 7, " is empty");
+    list.emplace_back(105, jack::literal("bad checksum"));
+
+    REQUIRE(list.size() == 5);
+    REQUIRE(list.code(1) == 102);
+    REQUIRE(desc(list, 0) == "plain");
+    REQUIRE(desc(list, 1) == "connecting: refused: attempt 3");
+    REQUIRE(desc(list, 2) == "loading: read 10 bytes");
+    REQUIRE(desc(list, 3) == "field 7 is empty");
+    REQUIRE(desc(list, 4) == "bad checksum");
+
+    // rebuilt errors keep their frames
+    jack::error rebuilt = list.at(1);
+    rebuilt.wrap("outer");
+    REQUIRE(std::string(rebuilt.desc.c_str()) ==
+            "outer: connecting: refused: attempt 3");
+}
+
+TEST_CASE("error_list wraps every error", "[error_list.wrap]")
+{
+    jack::error_list list;
+
+    // nothing to wrap yet
+    list.wrap("ignored");
+
+    jack::error e(101, "a");
+    e.wrap("inner");
+    list.push_back(e);
+    list.emplace_back(102, "b");
+    list.wrap("batch ", 1).extend("retrying");
+    REQUIRE(desc(list, 0) == "batch 1: inner: a: retrying");
+    REQUIRE(desc(list, 1) == "batch 1: b: retrying");
+
+    // later errors only get later contexts
+    list.emplace_back(103, "c");
+    list.wrap(jack::literal("import"));
+    REQUIRE(desc(list, 0) == "import: batch 1: inner: a: retrying");
+    REQUIRE(desc(list, 2) == "import: c");
+
+    // copies & moves are independent
+    jack::error_list copy(list);
+    copy.wrap("copy");
+    REQUIRE(desc(copy, 2) == "copy: import: c");
+    REQUIRE(desc(list, 2) == "import: c");
+    jack::error_list moved(std::move(copy));
+    REQUIRE(copy.empty());
+    REQUIRE(desc(moved, 0) == "copy: import: batch 1: inner: a: retrying");
+    copy = moved;
+    REQUIRE(desc(copy, 1) == "copy: import: batch 1: b: retrying");
+
+    list.clear();
+    REQUIRE(list.empty());
+    list.emplace_back(104, "d");
+    REQUIRE(desc(list, 0) == "d");
+}
+
+TEST_CASE("error_list shares strings", "[error_list.dedup]")
+{
+    static const char* const messages[] = {"missing field", "bad type",
+            "out of range", "duplicate key"};
+
+    jack::error_list list;
+    for (int i = 0; i < 10000; ++i)
+    {
+        jack::error e(1000 + i % 3, messages[i % 4]);
+        e.wrap("validating column ", i % 16);
+        list.push_back(e);
+    }
+    list.wrap("importing users.csv");
+
+    // 4 messages & 16 contexts are stored once each
+    REQUIRE(list.size() == 10000);
+    REQUIRE(list.heap_bytes() < 10000 * 48);
+    REQUIRE(desc(list, 9999) ==
+            "importing users.csv: validating column 15: duplicate key");
+    REQUIRE(list.summary() == "10000 errors, 3 distinct codes");
+}
+
+TEST_CASE("error_list merges lists", "[error_list.merge]")
+{
+    jack::error_list parts[4];
+    std::thread workers[4];
+    for (int t = 0; t < 4; ++t)
+    {
+        workers[t] = std::thread([&parts, t] {
+            for (int i = 0; i < 100; ++i)
+            {
+                parts[t].emplace_back(t, "record ", i);
+            }
+            parts[t].wrap("shard ", t);
+        });
+    }
+    for (auto& w : workers)
+    {
+        w.join();
+    }
+
+    jack::error_list all;
+    all.emplace_back(9, "before");
+    for (const auto& part : parts)
+    {
+        all.merge(part);
+    }
+    all.extend("job 7");
+    REQUIRE(all.size() == 401);
+    REQUIRE(desc(all, 0) == "before: job 7");
+    REQUIRE(desc(all, 1) == "shard 0: record 0: job 7");
+    REQUIRE(desc(all, 400) == "shard 3: record 99: job 7");
+
+    all.merge(all);
+    REQUIRE(all.size() == 802);
+    REQUIRE(desc(all, 802 - 1) == "shard 3: record 99: job 7");
+}
+
+TEST_CASE("error_list summary", "[error_list.summary]")
+{
+    jack::error_list list;
+    REQUIRE(list.summary() == "0 errors, 0 distinct codes");
+    list.emplace_back(101, "a");
+    REQUIRE(list.summary() == "1 error, 1 distinct code");
+    list.emplace_back(102, "b");
+    list.emplace_back(101, "c");
+
+    std::ostringstream ss;
+    ss << list;
+    REQUIRE(ss.str() == "3 errors, 2 distinct codes");
+    REQUIRE(list.distinct_codes() == 2);
+}
+
+#if __cplusplus >= 201703L
+TEST_CASE("error_list stores few errors inline", "[error_list.inline]")
+{
+    auto* const prev = std::pmr::set_default_resource(
+            std::pmr::null_memory_resource());
+
+    // anything that needs the heap would throw
+    jack::pmr::error_list list;
+    list.emplace_back(101, jack::literal("timeout"));
+    list.emplace_back(102, "refused");
+    list.emplace_back(101, jack::literal("timeout"));
+    list.wrap("db").extend("retry");
+    REQUIRE(list.heap_bytes() == 0);
+    REQUIRE(list.size() == 3);
+    REQUIRE(list.code(1) == 102);
+
+    std::pmr::set_default_resource(prev);
+    REQUIRE(!std::strcmp(list.at(2, std::pmr::new_delete_resource()).desc.c_str(),
+            "db: timeout: retry"));
+}
+#endif
@@ -0,0 +1,111 @@
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+// let catch define main
+#define CATCH_CONFIG_MAIN
+
+#include "catch2/catch.hpp"
+#include "jack/exception.hpp"
+
+namespace jack
+{
+inline bool operator==(const jack::reason& lhs, const char* rhs)
+{
+    return !strcmp(lhs.c_str(), rhs);
+}
+}
+
+static int parse(const std::string& text)
+{
+    if (text.empty())
+    {
+        throw std::invalid_argument("empty input");
+    }
+    if (text == "?")
+    {
+        throw 42;
+    }
+    if (text[0] < '0' || text[0] > '9')
+    {
+        jack::error e(22, "not a number: ", text);
+        e.wrap("parsing");
+        throw jack::exception(std::move(e));
+    }
+    return std::stoi(text);
+}
+
+TEST_CASE("exception holds an error", "[exception.error]")
+{
+    // moved in & out, without copying the description
+    jack::error e0(1001, "connection refused by ", std::string(80, 'x'));
+    e0.wrap("dialing");
+    const std::string desc = e0.desc.c_str();
+    const char* text = e0.desc.c_str();
+    jack::exception x0(std::move(e0));
+    REQUIRE(x0.code() == 1001);
+    REQUIRE(x0.what() == desc);
+    REQUIRE(x0.what() == text);
+    const std::exception& base = x0;
+    REQUIRE(base.what() == desc);
+
+    jack::error e1 = std::move(x0).error();
+    REQUIRE(e1.code == 1001);
+    REQUIRE(e1.desc.c_str() == text);
+
+    // built in place & copied
+    const jack::exception x1(7, "disk ", 3, " is full");
+    REQUIRE(std::string(x1.what()) == "disk 3 is full");
+    REQUIRE(x1.error().desc == "disk 3 is full");
+    jack::exception x2(x1.error());
+    x2.error().wrap("writing");
+    REQUIRE(std::string(x2.what()) == "writing: disk 3 is full");
+    REQUIRE(std::string(x1.what()) == "disk 3 is full");
+
+    // thrown & caught as a std::exception
+    try
+    {
+        throw jack::exception(8, "thrown");
+    }
+    catch (const std::exception& e)
+    {
+        REQUIRE(std::string(e.what()) == "thrown");
+    }
+}
+
+TEST_CASE("try_call turns exceptions into errors", "[exception.try_call]")
+{
+    jack::result<int> r0 = jack::try_call(parse, "12");
+    REQUIRE(*r0 == 12);
+
+    jack::result<int> r1 = jack::try_call(parse, "abc");
+    REQUIRE(r1.error().code == 22);
+    REQUIRE(r1.error().desc == "parsing: not a number: abc");
+
+    jack::result<int> r2 = jack::try_call(parse, "");
+    REQUIRE(r2.error().code == jack::foreign_exception_code);
+    REQUIRE(r2.error().desc == "empty input");
+
+    jack::result<int> r3 = jack::try_call(parse, "?");
+    REQUIRE(r3.error().code == jack::foreign_exception_code);
+    REQUIRE(r3.error().desc == "unknown exception");
+
+    // void & lambdas with captures
+    int calls = 0;
+    jack::result<void> v0 = jack::try_call([&] { ++calls; });
+    REQUIRE(v0);
+    jack::result<void> v1 = jack::try_call([&](int code) {
+        ++calls;
+        throw jack::exception(code, "from a lambda");
+    }, 5);
+    REQUIRE(v1.error().code == 5);
+    REQUIRE(calls == 2);
+
+    // a wrapped callable
+    auto safe_parse = jack::nothrow(parse);
+    REQUIRE(*safe_parse("7") == 7);
+    REQUIRE(safe_parse("x").wrap("reading config").error().desc ==
+            "reading config: parsing: not a number: x");
+    auto counter = jack::nothrow([&calls]() { return ++calls; });
+    REQUIRE(*counter() == 3);
+}
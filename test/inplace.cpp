@@ -0,0 +1,177 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sstream>
+#include <string>
+
+// let catch define main
+#define CATCH_CONFIG_MAIN
+
+#include "catch2/catch.hpp"
+#include "jack/error.hpp"
+
+// every allocation in the program goes through here, so the real-time
+// sections below can check they made none
+static std::atomic<std::size_t> allocations(0);
+
+// kept out of line, or gcc pairs the inlined malloc & free with new &
+// delete and warns about a mismatch
+#if defined(__GNUC__) || defined(__clang__)
+#define TEST_NOINLINE __attribute__((noinline))
+#else
+#define TEST_NOINLINE
+#endif
+
+TEST_NOINLINE void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+TEST_NOINLINE void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+TEST_NOINLINE void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    ++allocations;
+    return std::malloc(size ? size : 1);
+}
+
+TEST_NOINLINE void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+TEST_NOINLINE void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+TEST_NOINLINE void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+TEST_NOINLINE void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+TEST_NOINLINE void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+static std::string str(const char* c_str)
+{
+    return c_str;
+}
+
+TEST_CASE("inplace_reason formats in place", "[inplace.reason]")
+{
+    static_assert(noexcept(jack::inplace_reason<64>("a ", 1, ' ', 2.5)),
+            "construction is noexcept");
+    static_assert(noexcept(std::declval<jack::inplace_reason<64>&>().wrap("x")),
+            "wrap is noexcept");
+    static_assert(noexcept(std::declval<jack::inplace_reason<64>&>().extend("x")),
+            "extend is noexcept");
+
+    const std::size_t before = allocations;
+
+    jack::inplace_reason<128> r0("buffer underrun by ", 128, " frames");
+    r0.wrap("mixing bus ", 3).extend(jack::literal("dropping"));
+    r0.wrap(jack::location{"mix.cpp", "render", 88});
+    jack::inplace_reason<128> r1(r0);
+    r1.extend('!');
+    jack::inplace_reason<16> r2("x = ", 1.5, ", ok = ", true);
+
+    const std::size_t after = allocations;
+    REQUIRE(after == before);
+
+    REQUIRE(str(r0.c_str()) == "mix.cpp:88 in render: mixing bus 3: "
+            "buffer underrun by 128 frames: dropping");
+    REQUIRE(r0.size() == std::strlen(r0.c_str()));
+    REQUIRE(!r0.truncated());
+    REQUIRE(str(r1.c_str()) == str(r0.c_str()) + ": !");
+    REQUIRE(str(r2.c_str()) == "x = 1.5, ok = 1");
+
+    std::ostringstream ss;
+    ss << r2;
+    REQUIRE(ss.str() == "x = 1.5, ok = 1");
+}
+
+TEST_CASE("inplace_reason truncates with an ellipsis", "[inplace.truncate]")
+{
+    const std::size_t before = allocations;
+
+    // the end is cut & marked
+    jack::inplace_reason<16> r0("connection refused by peer");
+    jack::inplace_reason<16> r1("connection");
+    r1.extend("refused by ", 10, ".0.0.1");
+    const jack::inplace_reason<16> r2(r1);
+
+    // further extends are dropped; wraps push the end out
+    jack::inplace_reason<16> r3("connection refused");
+    r3.extend("dropped");
+    r3.wrap("dial");
+    jack::inplace_reason<16> r4("refused");
+    r4.wrap("a context longer than the reason");
+
+    // fits exactly
+    jack::inplace_reason<16> r5("exactly 16 chars");
+
+    const std::size_t after = allocations;
+    REQUIRE(after == before);
+
+    REQUIRE(str(r0.c_str()) == "connection re...");
+    REQUIRE(r0.size() == 16);
+    REQUIRE(r0.truncated());
+    REQUIRE(str(r1.c_str()) == "connection: r...");
+    REQUIRE(str(r2.c_str()) == "connection: r...");
+    REQUIRE(r2.truncated());
+    REQUIRE(str(r3.c_str()) == "dial: connect...");
+    REQUIRE(str(r4.c_str()) == "a context lon...");
+    REQUIRE(str(r5.c_str()) == "exactly 16 chars");
+    REQUIRE(!r5.truncated());
+}
+
+TEST_CASE("inplace_error", "[inplace.error]")
+{
+    static_assert(noexcept(jack::inplace_error<64>(1, "a ", 1)),
+            "construction is noexcept");
+    static_assert(noexcept(jack::debug::str(jack::inplace_error<64>(1, "a"))),
+            "debug::str is noexcept");
+
+    const std::size_t before = allocations;
+
+    jack::inplace_error<64> e0(1001, "underrun by ", 128, " frames");
+    e0.wrap("bus ", 3).extend("dropping");
+    jack::inplace_error<64> e1(jack::location{"mix.cpp", "render", 88}, 1002, "late");
+    e1.trace(jack::location{"io.cpp", "tick", 7});
+    const auto s0 = jack::debug::str(e0);
+
+    const std::size_t after = allocations;
+    REQUIRE(after == before);
+
+    REQUIRE(e0.code == 1001);
+    REQUIRE(str(e0.desc.c_str()) == "bus 3: underrun by 128 frames: dropping");
+    REQUIRE(str(e1.desc.c_str()) == "io.cpp:7 in tick: mix.cpp:88 in render: late");
+    REQUIRE(str(s0.c_str()) ==
+            "error { code: 1001, desc: \"bus 3: underrun by 128 frames: dropping\" }");
+
+    // crosses over to the heap-backed types
+    jack::error e2 = e0.to_error();
+    e2.wrap("audio thread");
+    REQUIRE(e2.code == 1001);
+    REQUIRE(str(e2.desc.c_str()) ==
+            "audio thread: bus 3: underrun by 128 frames: dropping");
+    REQUIRE(str(e1.desc.to_reason().c_str()) ==
+            "io.cpp:7 in tick: mix.cpp:88 in render: late");
+}
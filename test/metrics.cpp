@@ -0,0 +1,113 @@
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// let catch define main
+#define CATCH_CONFIG_MAIN
+
+#include "catch2/catch.hpp"
+#include "jack/error.hpp"
+
+#ifdef JACK_ERROR_METRICS
+
+static std::uint64_t created(int code)
+{
+    const auto snap = jack::metrics::collect();
+    const auto* stats = snap.find(code);
+    return stats ? stats->created : 0;
+}
+
+TEST_CASE("metrics count errors by code", "[metrics.count]")
+{
+    const auto start = std::chrono::steady_clock::now();
+    REQUIRE(jack::metrics::collect().find(101) == nullptr);
+
+    // every constructor counts; copies & moves don't
+    jack::error e0(101, "c string");
+    jack::error e1(101, jack::literal("literal"));
+    jack::error e2(101, "variadic ", 1);
+    jack::error e3(102, jack::deferred, "deferred ", 2);
+    jack::error e4(e0);
+    jack::error e5(std::move(e1));
+    jack::derror d0(102, "derror");
+
+    // wraps & extends count as propagation
+    e0.wrap("ctx").extend("info");
+    d0.wrap("ctx");
+
+    const auto snap = jack::metrics::collect();
+    const auto* s101 = snap.find(101);
+    const auto* s102 = snap.find(102);
+    REQUIRE(s101);
+    REQUIRE(s102);
+    REQUIRE(s101->created == 3);
+    REQUIRE(s101->propagated == 2);
+    REQUIRE(s102->created == 2);
+    REQUIRE(s102->propagated == 1);
+    REQUIRE(s101->first_seen <= s101->last_seen);
+    REQUIRE(s101->last_seen <= snap.taken);
+    REQUIRE(s101->first_seen + std::chrono::milliseconds(100) >= start);
+
+    // descriptions are sampled at counts 1, 2, 4...; deferred ones are
+    // formatted to do so
+    REQUIRE(s101->samples.size() == 1);
+    REQUIRE(s101->samples[0] == "literal");
+    REQUIRE(s102->samples[0] == "derror");
+}
+
+TEST_CASE("metrics merge threads", "[metrics.threads]")
+{
+    constexpr int threads = 8;
+    constexpr int per_thread = 1000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([t] {
+            for (int i = 0; i < per_thread; ++i)
+            {
+                jack::error e(201 + i % 2, "worker ", t);
+            }
+        });
+    }
+    for (auto& w : workers)
+    {
+        w.join();
+    }
+
+    // counts of threads that have exited are kept
+    const auto snap = jack::metrics::collect();
+    REQUIRE(snap.find(201)->created == threads * per_thread / 2);
+    REQUIRE(snap.find(202)->created == threads * per_thread / 2);
+
+    // a few distinct samples are kept per code
+    const auto& samples = snap.find(201)->samples;
+    REQUIRE(!samples.empty());
+    REQUIRE(samples.size() <= 4);
+    REQUIRE(std::strncmp(samples[0].c_str(), "worker ", 7) == 0);
+
+    // & new threads pick up where exited ones left off
+    std::thread([] { jack::error e(201, "again"); }).join();
+    REQUIRE(created(201) == threads * per_thread / 2 + 1);
+}
+
+TEST_CASE("metrics drop codes beyond the table", "[metrics.dropped]")
+{
+    std::thread([] {
+        const auto before = jack::metrics::collect().dropped;
+        for (int code = 0; code < JACK_ERROR_METRICS_SLOTS + 3; ++code)
+        {
+            jack::error e(1000 + code, "code ", code);
+        }
+        REQUIRE(jack::metrics::collect().dropped >= before + 3);
+    }).join();
+}
+
+TEST_CASE("metrics truncate samples", "[metrics.samples]")
+{
+    const std::string long_desc(500, 'x');
+    jack::error e(301, long_desc);
+    const auto snap = jack::metrics::collect();
+    REQUIRE(snap.find(301)->samples[0] == std::string(95, 'x'));
+}
+
+#endif // JACK_ERROR_METRICS
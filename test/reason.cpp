@@ -1,5 +1,14 @@
 
+#include <atomic>
 #include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#if __cplusplus >= 201703L
+#include <memory_resource>
+#endif
 
 // let catch define main
 #define CATCH_CONFIG_MAIN
@@ -15,6 +24,119 @@ inline bool operator==(const jack::reason& lhs, const char* rhs)
 }
 }
 
+// formats like the stream-based implementation did
+template <typename... ts>
+static std::string streamed(const ts&... args)
+{
+    std::ostringstream ss;
+    using expand = int[];
+    (void)expand{0, (ss << args, 0)...};
+    return ss.str();
+}
+
+struct streamable
+{
+    int id;
+};
+
+static std::ostream& operator<<(std::ostream& os, const streamable& s)
+{
+    return os << "streamable#" << s.id;
+}
+
+// written by a jack::formatter, never streamed
+struct ipv4
+{
+    unsigned char octets[4];
+};
+
+enum class color
+{
+    red,
+    green
+};
+
+// has both; the formatter is used
+struct both
+{
+};
+
+inline std::ostream& operator<<(std::ostream& os, const both&)
+{
+    return os << "streamed";
+}
+
+namespace jack
+{
+template <>
+struct formatter<ipv4>
+{
+    static std::size_t size(const ipv4& ip)
+    {
+        std::size_t n = 3;
+        for (unsigned char o : ip.octets)
+        {
+            n += o >= 100 ? 3 : o >= 10 ? 2 : 1;
+        }
+        return n;
+    }
+
+    static char* write(const ipv4& ip, char* out)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            const unsigned o = ip.octets[i];
+            if (o >= 100)
+            {
+                *out++ = static_cast<char>('0' + o / 100);
+            }
+            if (o >= 10)
+            {
+                *out++ = static_cast<char>('0' + o / 10 % 10);
+            }
+            *out++ = static_cast<char>('0' + o % 10);
+            if (i != 3)
+            {
+                *out++ = '.';
+            }
+        }
+        return out;
+    }
+};
+
+template <>
+struct formatter<color>
+{
+    static std::size_t size(color c)
+    {
+        return c == color::red ? 3 : 5;
+    }
+
+    static char* write(color c, char* out)
+    {
+        const char* name = c == color::red ? "red" : "green";
+        const std::size_t n = size(c);
+        std::memcpy(out, name, n);
+        return out + n;
+    }
+};
+
+template <>
+struct formatter<both>
+{
+    static std::size_t size(const both&)
+    {
+        return 9;
+    }
+
+    static char* write(const both&, char* out)
+    {
+        std::memcpy(out, "formatted", 9);
+        return out + 9;
+    }
+};
+}
+
 TEST_CASE("reason constructors", "[reason.constructors]")
 {
     // variadic constructor
@@ -97,4 +219,529 @@ TEST_CASE("reason::extend member function", "[reason.extend]")
     jack::reason r3("a fail reason");
     r3.extend("ap0, ", std::string("ap1, "), jack::reason("ap2, "), 100);
     REQUIRE(r3 == "a fail reason: ap0, ap1, ap2, 100");
-}
\ No newline at end of file
+}
+TEST_CASE("reason wrap & extend ordering", "[reason.frames]")
+{
+    jack::reason r0("root");
+    r0.wrap("w0").extend("e0").wrap("w1").extend("e1");
+    REQUIRE(r0 == "w1: w0: root: e0: e1");
+    REQUIRE(r0.size() == std::strlen(r0.c_str()));
+
+    // rendered description is refreshed after further changes
+    r0.wrap("w2");
+    REQUIRE(r0 == "w2: w1: w0: root: e0: e1");
+
+    // copies carry their frames along
+    jack::reason r1(static_cast<const jack::reason&>(r0));
+    r1.extend("e2");
+    REQUIRE(r1 == "w2: w1: w0: root: e0: e1: e2");
+    REQUIRE(r0 == "w2: w1: w0: root: e0: e1");
+
+    // wrapping with itself uses the description from before the call
+    jack::reason r2("root");
+    r2.wrap("ctx");
+    r2.wrap(r2);
+    REQUIRE(r2 == "ctx: root: ctx: root");
+
+    // deep wraps
+    jack::reason r3("root");
+    std::string expected("root");
+    for (int i = 0; i < 100; ++i)
+    {
+        r3.wrap(i);
+        expected.insert(0, ": ").insert(0, std::to_string(i));
+    }
+    REQUIRE(r3 == expected.c_str());
+}
+
+TEST_CASE("reason variadic formatting", "[reason.format]")
+{
+    // integers
+    REQUIRE(jack::reason(0) == streamed(0).c_str());
+    REQUIRE(jack::reason(-42, " ", 42u) == streamed(-42, " ", 42u).c_str());
+    const auto ll_min = std::numeric_limits<long long>::min();
+    const auto ull_max = std::numeric_limits<unsigned long long>::max();
+    const auto s_min = std::numeric_limits<short>::min();
+    REQUIRE(jack::reason(ll_min, ull_max, s_min) ==
+            streamed(ll_min, ull_max, s_min).c_str());
+
+    // characters & booleans
+    REQUIRE(jack::reason('a', static_cast<signed char>('b'),
+            static_cast<unsigned char>('c'), true, false) == "abc10");
+
+    // floating point uses the default stream precision
+    REQUIRE(jack::reason(3.14159265, " ", 1e20, " ", 0.5f, " ", -0.0) ==
+            streamed(3.14159265, " ", 1e20, " ", 0.5f, " ", -0.0).c_str());
+    REQUIRE(jack::reason(123456789.0, " ", 1e-7L) ==
+            streamed(123456789.0, " ", 1e-7L).c_str());
+
+    // strings
+    const char* cs = "c string";
+    char buf[] = "buffer";
+    std::string str("string");
+    REQUIRE(jack::reason(cs, " ", buf, " ", str, " ", jack::reason("reason")) ==
+            "c string buffer string reason");
+#if __cplusplus >= 201703L
+    REQUIRE(jack::reason(std::string_view("view, "), 1) == "view, 1");
+#endif
+
+    // anything else falls back to operator<<
+    REQUIRE(jack::reason("id ", streamable{7}) == "id streamable#7");
+    const void* ptr = &str;
+    REQUIRE(jack::reason(ptr) == streamed(ptr).c_str());
+
+    // wrapping & extending with a reason built from this reason
+    jack::reason r0("root");
+    r0.wrap("ctx ", r0, " ", 1).extend(r0, "!");
+    REQUIRE(r0 == "ctx root 1: root: ctx root 1: root!");
+}
+
+TEST_CASE("reason w/ formatter", "[reason.formatter]")
+{
+    const ipv4 ip{{10, 0, 128, 255}};
+
+    jack::reason r0("connect to ", ip, " failed");
+    r0.wrap("link ", color::green).extend(both{});
+    REQUIRE(r0 == "link green: connect to 10.0.128.255 failed: formatted");
+    REQUIRE(r0.size() == std::strlen(r0.c_str()));
+
+    jack::error e0(1, ip);
+    REQUIRE(jack::debug::str(e0) == "error { code: 1, desc: \"10.0.128.255\" }");
+
+    // captured by value when deferred
+    jack::reason r1 = [&] {
+        const ipv4 local{{192, 168, 1, 1}};
+        return jack::reason(jack::deferred, local, " is ", color::red);
+    }();
+    REQUIRE(r1 == "192.168.1.1 is red");
+
+    // cut to fit a fixed buffer
+    jack::inplace_reason<12> r2("ip ", ip);
+    REQUIRE(std::string(r2.c_str()) == "ip 10.0.1...");
+
+#if __cplusplus >= 201703L
+    jack::reason r3(JACK_FMT("{} via {}"), ip, color::red);
+    REQUIRE(r3 == "10.0.128.255 via red");
+    REQUIRE(jack::debug::str(JACK_FMT("[{}]"), both{}) == "[formatted]");
+#endif
+}
+
+#if __cplusplus >= 201703L
+TEST_CASE("reason format strings", "[reason.fmt]")
+{
+    const std::string path("/etc/app.conf");
+
+    jack::reason r0(JACK_FMT("read {:d} of {} bytes from {:s}"), 10, 20u, path);
+    REQUIRE(r0 == "read 10 of 20 bytes from /etc/app.conf");
+
+    // escapes & presentation types
+    jack::reason r1(JACK_FMT("{{{:x}}} {:X} {:c} {:d} {:f} {:e} {:g} {}"),
+            255, -255, 65, 'a', 1.5, 12345.678, 0.1, true);
+    REQUIRE(r1 == "{ff} -FF A 97 1.500000 1.234568e+04 0.1 1");
+
+    // no placeholders
+    jack::reason r2(JACK_FMT("no args }} here"));
+    REQUIRE(r2 == "no args } here");
+
+    // wrap & extend, including a reason that is this reason
+    jack::reason r3("root");
+    r3.wrap(JACK_FMT("ctx {}"), 1).extend(JACK_FMT("[{:s}]"), r3);
+    REQUIRE(r3 == "ctx 1: root: [ctx 1: root]");
+}
+#endif
+
+#if __cplusplus >= 201703L
+// counts allocations & forwards them to the global heap
+class counting_resource : public std::pmr::memory_resource
+{
+  public:
+
+    std::size_t allocs = 0;
+
+  private:
+
+    void* do_allocate(std::size_t bytes, std::size_t align) override
+    {
+        ++allocs;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+TEST_CASE("reason w/ memory resource", "[reason.pmr]")
+{
+    counting_resource res;
+    std::pmr::polymorphic_allocator<char> alloc(&res);
+
+    // anything that falls back to the default resource would throw
+    auto* const prev = std::pmr::set_default_resource(
+            std::pmr::null_memory_resource());
+
+    jack::pmr::reason r0("a fail reason long enough to need the heap", alloc);
+    r0.wrap("ctx ", 1).extend(std::string("info"));
+    r0.wrap(JACK_FMT("fmt {}"), 2).extend(r0);
+    REQUIRE(r0.get_allocator().resource() == &res);
+    REQUIRE(!std::strcmp(r0.c_str(), "fmt 2: ctx 1: a fail reason long enough "
+            "to need the heap: info: fmt 2: ctx 1: a fail reason long enough "
+            "to need the heap: info"));
+
+    // variadic, copy & move w/ allocator
+    jack::pmr::reason r1(std::allocator_arg, alloc, "variadic reason w/ val ", 2);
+    REQUIRE(!std::strcmp(r1.c_str(), "variadic reason w/ val 2"));
+    jack::pmr::reason r2(r1, alloc);
+    REQUIRE(r2.get_allocator().resource() == &res);
+    jack::pmr::reason r3(std::allocator_arg, alloc, std::move(r2));
+    REQUIRE(!std::strcmp(r3.c_str(), "variadic reason w/ val 2"));
+
+    REQUIRE(res.allocs > 0);
+    std::pmr::set_default_resource(prev);
+}
+#endif
+
+TEST_CASE("reason from literal", "[reason.literal]")
+{
+    static const char msg[] = "connection refused";
+
+    // refers to the literal rather than copying it
+    jack::reason r0(jack::literal{msg});
+    REQUIRE(r0.c_str() == msg);
+    REQUIRE(r0.size() == sizeof(msg) - 1);
+
+    // copies share it too
+    jack::reason r1(static_cast<const jack::reason&>(r0));
+    REQUIRE(r1.c_str() == msg);
+
+    // wraps & extends are recorded around it
+    r1.wrap("ctx ", 1).extend(jack::literal("info"));
+    REQUIRE(r1 == "ctx 1: connection refused: info");
+    REQUIRE(r1.size() == std::strlen(r1.c_str()));
+    REQUIRE(r0.c_str() == msg);
+
+    // & it can be used as an argument
+    jack::reason r2("w/ ", jack::literal("literal"));
+    REQUIRE(r2 == "w/ literal");
+
+#if __cplusplus >= 201703L
+    // nothing is allocated until a wrap or extend
+    auto* const prev = std::pmr::set_default_resource(
+            std::pmr::null_memory_resource());
+    jack::pmr::reason r3(jack::literal("no allocation"));
+    jack::pmr::reason r4(r3);
+    REQUIRE(!std::strcmp(r4.c_str(), "no allocation"));
+    std::pmr::set_default_resource(prev);
+#endif
+}
+
+TEST_CASE("deferred reason", "[reason.deferred]")
+{
+    // arguments are copied, so they may go away before the reason is read
+    jack::reason r0 = [] {
+        std::string path("/etc/app.conf");
+        char buf[] = "bytes from ";
+        return jack::reason(jack::deferred, "read ", 4096, ' ', buf, path,
+                " (", 0.5, ")");
+    }();
+    REQUIRE(r0 == "read 4096 bytes from /etc/app.conf (0.5)");
+    REQUIRE(r0.size() == std::strlen(r0.c_str()));
+
+    // formatted once, then cached
+    const char* const first = r0.c_str();
+    REQUIRE(r0.c_str() == first);
+
+    // wraps & extends are recorded around the unformatted root
+    jack::reason r1(jack::deferred, "root ", 1);
+    r1.wrap("ctx ", 2).extend(jack::literal("info"));
+    REQUIRE(r1 == "ctx 2: root 1: info");
+
+    // copies & moves carry the arguments, formatted or not
+    jack::reason r2(jack::deferred, "copied ", 3);
+    jack::reason r3(r2);
+    jack::reason r4(std::move(r2));
+    REQUIRE(r3 == "copied 3");
+    REQUIRE(r4 == "copied 3");
+    jack::reason r5(r3);
+    REQUIRE(r5 == "copied 3");
+    r5 = r1;
+    REQUIRE(r5 == "ctx 2: root 1: info");
+    r5 = jack::reason(jack::deferred, "moved ", 4);
+    REQUIRE(r5 == "moved 4");
+
+    // a deferred reason can be an argument of another
+    jack::reason r6(jack::deferred, "outer ", r4);
+    REQUIRE(r6 == "outer copied 3");
+
+    // & the same output as eager formatting
+    std::stringstream ss;
+    ss << r0;
+    REQUIRE(ss.str() == jack::reason("read ", 4096, " bytes from ",
+            "/etc/app.conf (", 0.5, ")").c_str());
+
+#if __cplusplus >= 201703L
+    std::string_view view("view");
+    jack::reason r7(jack::deferred, JACK_FMT("{:s} {:d} {}"), view, 7,
+            std::string("str"));
+    REQUIRE(r7 == "view 7 str");
+
+    // all storage comes from the reason's allocator
+    counting_resource res;
+    auto* const prev = std::pmr::set_default_resource(
+            std::pmr::null_memory_resource());
+    jack::pmr::reason r8(std::allocator_arg,
+            std::pmr::polymorphic_allocator<char>(&res), jack::deferred,
+            "a pmr reason long enough to need the heap ", 8);
+    REQUIRE(res.allocs == 1);
+    jack::pmr::reason r9(r8, r8.get_allocator());
+    REQUIRE(!std::strcmp(r9.c_str(), "a pmr reason long enough to need the "
+            "heap 8"));
+    std::pmr::set_default_resource(prev);
+#endif
+}
+
+TEST_CASE("reason source locations", "[reason.location]")
+{
+    const jack::location here{"src/io.cpp", "read_block", 42};
+
+    // stored as is & written out when read
+    jack::reason r0("short read");
+    r0.wrap(here).extend(jack::location{"src/db.cpp", "load", 7});
+    REQUIRE(r0.size() == std::strlen("src/io.cpp:42 in read_block: short read: "
+            "src/db.cpp:7 in load"));
+    REQUIRE(r0 == "src/io.cpp:42 in read_block: short read: src/db.cpp:7 in load");
+
+    // mixes with text frames & survives copies
+    r0.wrap("retrying");
+    jack::reason r1(r0);
+    REQUIRE(r1 == "retrying: src/io.cpp:42 in read_block: short read: "
+            "src/db.cpp:7 in load");
+
+    // trace wraps with the caller's location
+    jack::reason r2("x");
+    const unsigned line = __LINE__ + 1;
+    r2.trace();
+    const std::string expected = std::string(__FILE__) + ":" +
+            std::to_string(line) + " in ";
+    REQUIRE(std::string(r2.c_str()).compare(0, expected.size(), expected) == 0);
+    REQUIRE(std::string(r2.c_str()).find("x", expected.size()) != std::string::npos);
+
+    // or formats as an argument
+    jack::reason r3("attempt ", 2, " at ", here);
+    REQUIRE(r3 == "attempt 2 at src/io.cpp:42 in read_block");
+}
+
+TEST_CASE("reason inline capacity", "[reason.inline]")
+{
+    // too small for anything past the root, so frames spill to the heap
+    jack::basic_reason<std::allocator<char>, 16> r0("connection refused");
+    r0.wrap("fetching shard ", 12).extend(jack::literal("attempt 3"));
+    r0.wrap(jack::location{"net.cpp", "dial", 9});
+    REQUIRE(std::string(r0.c_str()) ==
+            "net.cpp:9 in dial: fetching shard 12: connection refused: attempt 3");
+    REQUIRE(r0.size() == std::strlen(r0.c_str()));
+
+    // a later frame replaces the rendered description
+    r0.extend("retrying");
+    REQUIRE(std::string(r0.c_str()) == "net.cpp:9 in dial: fetching shard 12: "
+            "connection refused: attempt 3: retrying");
+
+    // copies & moves
+    auto r1 = r0;
+    auto r2 = std::move(r1);
+    r1 = r2;
+    r1.wrap("r1");
+    r2 = std::move(r0);
+    REQUIRE(std::string(r1.c_str()) == "r1: net.cpp:9 in dial: fetching shard 12: "
+            "connection refused: attempt 3: retrying");
+    REQUIRE(std::string(r2.c_str()) == "net.cpp:9 in dial: fetching shard 12: "
+            "connection refused: attempt 3: retrying");
+
+    // nothing inline but the terminator & one frame
+    jack::basic_reason<std::allocator<char>, 0> r3("a");
+    r3.wrap("b").wrap("c").extend("d");
+    REQUIRE(std::string(r3.c_str()) == "c: b: a: d");
+
+#if __cplusplus >= 201703L
+    counting_resource res;
+    std::pmr::polymorphic_allocator<char> alloc(&res);
+    auto* const prev = std::pmr::set_default_resource(
+            std::pmr::null_memory_resource());
+
+    // a typical wrapped message stays inside the object, read or not
+    jack::pmr::reason r4("connection refused", alloc);
+    r4.wrap("dialing ", 80);
+    jack::pmr::reason r5(std::move(r4));
+    REQUIRE(!std::strcmp(r5.c_str(), "dialing 80: connection refused"));
+    jack::pmr::reason r6(r5, alloc);
+    r6.extend("retrying");
+    REQUIRE(res.allocs == 0);
+
+    // outliers use the allocator
+    REQUIRE(!std::strcmp(r6.c_str(), "dialing 80: connection refused: retrying"));
+    REQUIRE(res.allocs == 1);
+    std::pmr::set_default_resource(prev);
+#endif
+}
+
+TEST_CASE("reason copies share storage", "[reason.share]")
+{
+    using small_reason = jack::basic_reason<std::allocator<char>, 16>;
+
+    small_reason r0("a fail reason long enough to need the heap");
+    r0.wrap("ctx ", 1).extend("info").trace(jack::location{"db.cpp", "load", 7});
+    const std::string expected = "db.cpp:7 in load: ctx 1: a fail reason long "
+            "enough to need the heap: info";
+
+    // copies read the same description
+    small_reason r1(r0);
+    small_reason r2(r1);
+    small_reason r3("x");
+    r3 = r2;
+    REQUIRE(r1.c_str() == r0.c_str());
+    REQUIRE(r2.c_str() == r0.c_str());
+    REQUIRE(r3.c_str() == r0.c_str());
+    REQUIRE(std::string(r0.c_str()) == expected);
+
+    // and move to their own storage when changed
+    r1.wrap("r1");
+    r2.extend(jack::location{"io.cpp", "read", 3});
+    REQUIRE(std::string(r1.c_str()) == "r1: " + expected);
+    REQUIRE(std::string(r2.c_str()) == expected + ": io.cpp:3 in read");
+    REQUIRE(std::string(r0.c_str()) == expected);
+    REQUIRE(std::string(r3.c_str()) == expected);
+    REQUIRE(r0.c_str() == r3.c_str());
+
+    // copies read, copied & dropped on other threads at once
+    std::atomic<int> mismatches(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&r3, &expected, &mismatches] {
+            for (int i = 0; i < 1000; ++i)
+            {
+                const small_reason copy(r3);
+                if (copy.size() != expected.size() ||
+                        std::strcmp(copy.c_str(), expected.c_str()) != 0)
+                {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    REQUIRE(mismatches == 0);
+
+    // deferred arguments are shared once formatted
+    small_reason r4(jack::deferred, "deferred reason w/ val ", 4);
+    small_reason r5(r4);
+    REQUIRE(std::string(r4.c_str()) == "deferred reason w/ val 4");
+    small_reason r6(r4);
+    r4.wrap("r4");
+    REQUIRE(std::string(r5.c_str()) == "deferred reason w/ val 4");
+    REQUIRE(std::string(r6.c_str()) == "deferred reason w/ val 4");
+    REQUIRE(std::string(r4.c_str()) == "r4: deferred reason w/ val 4");
+
+#if __cplusplus >= 201703L
+    counting_resource res;
+    std::pmr::polymorphic_allocator<char> alloc(&res);
+
+    jack::pmr::reason r7(std::allocator_arg, alloc, std::string(100, 'x'));
+    r7.wrap("ctx");
+    REQUIRE(r7.size() == 105);
+
+    // the first copy renders the description; later copies are free
+    std::vector<jack::pmr::reason> copies;
+    copies.reserve(8);
+    jack::pmr::reason r8(r7, alloc);
+    const std::size_t allocs = res.allocs;
+    for (int i = 0; i < 8; ++i)
+    {
+        copies.emplace_back(r7, alloc);
+    }
+    REQUIRE(res.allocs == allocs);
+    REQUIRE(copies.back().c_str() == r7.c_str());
+    REQUIRE(r8.c_str() == r7.c_str());
+#endif
+}
+
+TEST_CASE("reason limits", "[reason.limit]")
+{
+    // the innermost & newest contexts are kept, those between elided
+    jack::reason r0("root");
+    r0.limit(4);
+    for (int i = 1; i <= 10; ++i)
+    {
+        r0.wrap("w", i);
+    }
+    REQUIRE(r0 == "w10: w9: [... 6 frames elided ...]: w2: w1: root");
+    REQUIRE(r0.size() == std::strlen(r0.c_str()));
+    REQUIRE(r0.elided() == 6);
+
+    // copies carry on from where the original was
+    jack::reason r1(r0);
+    r1.wrap("w11");
+    r0.wrap("x");
+    REQUIRE(r1 == "w11: w10: [... 7 frames elided ...]: w2: w1: root");
+    REQUIRE(r0 == "x: w10: [... 7 frames elided ...]: w2: w1: root");
+
+    // & moves, leaving a reason that can be used again
+    jack::reason r7(std::move(r1));
+    REQUIRE(r7 == "w11: w10: [... 7 frames elided ...]: w2: w1: root");
+    r1 = "reused";
+    r1.wrap("a");
+    REQUIRE(r1 == "a: reused");
+    REQUIRE(r1.size() == std::strlen(r1.c_str()));
+
+    // wraps & extends are counted apart
+    jack::reason r2("root");
+    r2.limit(3).wrap("a").extend("b").wrap("c").extend("d");
+    REQUIRE(r2 == "c: a: root: [... 1 frame elided ...]: d");
+    REQUIRE(r2.size() == std::strlen(r2.c_str()));
+
+    // locations are elided like text
+    jack::reason r3("root");
+    r3.limit(2);
+    for (unsigned i = 1; i <= 100; ++i)
+    {
+        r3.trace(jack::location{"loop.cpp", "retry", i});
+    }
+    REQUIRE(r3 == "loop.cpp:100 in retry: [... 98 frames elided ...]: "
+            "loop.cpp:1 in retry: root");
+    REQUIRE(r3.size() == std::strlen(r3.c_str()));
+
+    // the newest context is cut to fit, never inside a character
+    jack::reason r4("root");
+    r4.limit(0, 20).wrap("\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9"
+            "\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9");
+    REQUIRE(r4 == "\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9...: root");
+    REQUIRE(r4.size() <= 20);
+    REQUIRE(r4.size() == std::strlen(r4.c_str()));
+
+    // & older ones make room for it
+    jack::reason r5("connection refused");
+    r5.limit(0, 96);
+    for (int i = 0; i < 1000; ++i)
+    {
+        r5.wrap("attempt ", i);
+        REQUIRE(r5.size() <= 96);
+    }
+    REQUIRE(r5 == "attempt 999: attempt 998: [... 996 frames elided ...]: "
+            "attempt 1: attempt 0: connection refused");
+    REQUIRE(r5.size() == std::strlen(r5.c_str()));
+
+    // setting a limit bounds what is already there
+    jack::reason r6("root");
+    r6.wrap("a").wrap("b").wrap("c").wrap("d").wrap("e");
+    r6.limit(2);
+    REQUIRE(r6 == "e: [... 3 frames elided ...]: a: root");
+}
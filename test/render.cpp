@@ -0,0 +1,134 @@
+#include <cstring>
+#include <iterator>
+#include <random>
+#include <string>
+
+// let catch define main
+#define CATCH_CONFIG_MAIN
+
+#include "catch2/catch.hpp"
+#include "jack/render.hpp"
+
+template <typename error_t>
+static std::string json(const error_t& err)
+{
+    std::string out;
+    jack::render::json(err, std::back_inserter(out));
+    REQUIRE(out.size() == jack::render::json_size(err));
+    return out;
+}
+
+template <typename error_t>
+static std::string logfmt(const error_t& err)
+{
+    std::string out;
+    jack::render::logfmt(err, std::back_inserter(out));
+    REQUIRE(out.size() == jack::render::logfmt_size(err));
+    return out;
+}
+
+TEST_CASE("render an error", "[render.error]")
+{
+    jack::error e0(1001, "connection refused");
+    e0.wrap("dialing ", "10.0.0.1:", 80);
+    REQUIRE(json(e0) == R"({"code":1001,"desc":"dialing 10.0.0.1:80: connection refused"})");
+    REQUIRE(logfmt(e0) == R"(code=1001 desc="dialing 10.0.0.1:80: connection refused")");
+
+    // the root cause code is kept once the code changes
+    e0.wrap_as(-7, "fetching config");
+    REQUIRE(json(e0) == R"({"code":-7,"root_code":1001,"desc":"fetching config: )"
+            R"(dialing 10.0.0.1:80: connection refused"})");
+    REQUIRE(logfmt(e0) == R"(code=-7 root_code=1001 desc="fetching config: )"
+            R"(dialing 10.0.0.1:80: connection refused")");
+
+    // located frames, before & after the description is read
+    jack::error e1(2, "late");
+    e1.trace(jack::location{"mix.cpp", "render", 88});
+    const std::string expected = R"({"code":2,"desc":"mix.cpp:88 in render: late"})";
+    REQUIRE(json(e1) == expected);
+    REQUIRE(std::string(e1.desc.c_str()) == "mix.cpp:88 in render: late");
+    REQUIRE(json(e1) == expected);
+
+    jack::inplace_error<64> e2(3, "underrun by ", 128, " frames");
+    e2.wrap("bus ", 3);
+    REQUIRE(json(e2) == R"({"code":3,"desc":"bus 3: underrun by 128 frames"})");
+    REQUIRE(logfmt(e2) == R"(code=3 desc="bus 3: underrun by 128 frames")");
+}
+
+TEST_CASE("render escapes the description", "[render.escape]")
+{
+    jack::error e0(1, "say \"hi\"\n\tC:\\temp ", std::string("\x01\x1f\x7f", 3),
+            " caf\xc3\xa9");
+    e0.extend('\r', '\b', '\f');
+    const std::string desc = R"(say \"hi\"\n\tC:\\temp \u0001\u001f)" "\x7f"
+            " caf\xc3\xa9: \\r\\b\\f";
+    REQUIRE(json(e0) == "{\"code\":1,\"desc\":\"" + desc + "\"}");
+    REQUIRE(logfmt(e0) == "code=1 desc=\"" + desc + "\"");
+
+    // a null in the middle of a piece
+    const jack::error e1(1, std::string("a\0b", 3));
+    REQUIRE(json(e1) == R"({"code":1,"desc":"a\u0000b"})");
+}
+
+TEST_CASE("render into a buffer", "[render.buffer]")
+{
+    jack::error e0(42, "disk \"data\" is full");
+    e0.wrap("writing block ", 7);
+    const std::string expected = json(e0);
+
+    char buf[128];
+    std::memset(buf, '#', sizeof(buf));
+    REQUIRE(jack::render::json(e0, buf, expected.size()) == expected.size());
+    REQUIRE(std::string(buf, expected.size()) == expected);
+    REQUIRE(buf[expected.size()] == '#');
+
+    // too small: nothing is written
+    std::memset(buf, '#', sizeof(buf));
+    REQUIRE(jack::render::json(e0, buf, expected.size() - 1) == 0);
+    REQUIRE(buf[0] == '#');
+
+    const std::string line = logfmt(e0);
+    REQUIRE(jack::render::logfmt(e0, buf, sizeof(buf)) == line.size());
+    REQUIRE(std::string(buf, line.size()) == line);
+}
+
+TEST_CASE("vectorized escape search", "[render.simd]")
+{
+    // escapable bytes at every position around the vector widths
+    std::mt19937 gen(12345);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::string text(300, 'x');
+    for (std::size_t at = 0; at < 80; ++at)
+    {
+        for (const char c : {'"', '\\', '\0', '\n', '\x1f'})
+        {
+            std::string s = text;
+            s[at] = c;
+            const char* const end = s.data() + s.size();
+            REQUIRE(jack::detail::find_escape(s.data(), end) == s.data() + at);
+            REQUIRE(jack::detail::find_escape(s.data() + at + 1, end) == end);
+            REQUIRE(jack::detail::find_escape_swar(s.data(), end) == s.data() + at);
+        }
+    }
+
+    // random bytes; every length & start against the portable loop
+    for (char& c : text)
+    {
+        c = static_cast<char>(byte(gen) | 0x20);
+    }
+    for (int i = 0; i < 6; ++i)
+    {
+        text[static_cast<std::size_t>(byte(gen))] = '"';
+    }
+    for (std::size_t from = 0; from < 40; ++from)
+    {
+        for (std::size_t to = from; to <= text.size(); ++to)
+        {
+            const char* const p = text.data() + from;
+            const char* const end = text.data() + to;
+            const char* const expected = jack::detail::find_escape_scalar(p, end);
+            REQUIRE(jack::detail::find_escape(p, end) == expected);
+            REQUIRE(jack::detail::find_escape_swar(p, end) == expected);
+        }
+    }
+}
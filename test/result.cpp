@@ -0,0 +1,195 @@
+#include <cstring>
+#include <memory>
+#include <string>
+
+// let catch define main
+#define CATCH_CONFIG_MAIN
+
+#include "catch2/catch.hpp"
+#include "jack/error.hpp"
+
+namespace jack
+{
+inline bool operator==(const jack::reason& lhs, const char* rhs)
+{
+    return !strcmp(lhs.c_str(), rhs);
+}
+}
+
+static jack::result<int> parse(const std::string& text)
+{
+    if (text.empty() || text[0] < '0' || text[0] > '9')
+    {
+        return jack::derror(22, "not a number: \"", text, "\"");
+    }
+    return std::stoi(text);
+}
+
+static jack::result<std::string> lookup(int id)
+{
+    if (id > 100)
+    {
+        return jack::error(404, "no user ", id);
+    }
+    return "user" + std::to_string(id);
+}
+
+static jack::result<void> check(const std::string& name)
+{
+    if (name == "user7")
+    {
+        return jack::derror(403, name, " is locked");
+    }
+    return {};
+}
+
+TEST_CASE("result size", "[result.size]")
+{
+    REQUIRE(sizeof(jack::result<void>) == sizeof(void*));
+    REQUIRE(sizeof(jack::result<int>) <= 2 * sizeof(void*));
+    REQUIRE(sizeof(jack::result<std::string>) <= sizeof(std::string) + sizeof(void*));
+    REQUIRE(sizeof(jack::result<std::string>) < sizeof(jack::error));
+}
+
+TEST_CASE("result constructors", "[result.constructors]")
+{
+    // values
+    jack::result<int> r0(42);
+    REQUIRE(r0.has_value());
+    REQUIRE(r0);
+    REQUIRE(*r0 == 42);
+    jack::result<std::string> r1("converted");
+    REQUIRE(r1->size() == 9);
+    jack::result<std::unique_ptr<int>> r2(std::unique_ptr<int>(new int(7)));
+    REQUIRE(**r2 == 7);
+
+    // errors, copied, moved & taken from a derror
+    const jack::error e0(101, "copied");
+    jack::result<int> r3(e0);
+    REQUIRE(!r3.has_value());
+    REQUIRE(!r3);
+    REQUIRE(r3.error().code == 101);
+    REQUIRE(r3.error().desc == "copied");
+    jack::result<int> r4(jack::error(102, "moved"));
+    REQUIRE(r4.error().desc == "moved");
+    jack::result<std::string> r5(jack::derror(103, "boxed ", 1));
+    REQUIRE(r5.error().desc == "boxed 1");
+
+    // copies & moves of both states
+    jack::result<std::string> r6(r1);
+    REQUIRE(*r6 == "converted");
+    jack::result<std::string> r7(r5);
+    REQUIRE(r7.error().desc == "boxed 1");
+    REQUIRE(&r7.error() != &r5.error());
+    const jack::error* boxed = &r5.error();
+    jack::result<std::string> r8(std::move(r5));
+    REQUIRE(&r8.error() == boxed);
+
+    // assignment across states
+    r6 = r7;
+    REQUIRE(r6.error().desc == "boxed 1");
+    r6 = jack::result<std::string>("back");
+    REQUIRE(*r6 == "back");
+    r6 = std::move(r8);
+    REQUIRE(&r6.error() == boxed);
+    r7 = r6;
+    REQUIRE(r7.error().desc == "boxed 1");
+
+    // value_or
+    REQUIRE(r0.value_or(0) == 42);
+    REQUIRE(r3.value_or(-1) == -1);
+    REQUIRE(jack::result<std::string>(r6).value_or("none") == "none");
+    REQUIRE(std::move(r1).value() == "converted");
+
+    // void
+    jack::result<void> v0;
+    REQUIRE(v0.has_value());
+    jack::result<void> v1(jack::error(104, "void"));
+    REQUIRE(!v1);
+    REQUIRE(v1.error().code == 104);
+    jack::result<void> v2((jack::derror()));
+    REQUIRE(v2);
+}
+
+TEST_CASE("result combinators", "[result.combinators]")
+{
+    const auto chain = [](const std::string& text) {
+        return parse(text)
+            .and_then(lookup)
+            .and_then([](std::string&& name) -> jack::result<std::size_t> {
+                return check(name).and_then([&]() -> jack::result<std::size_t> {
+                    return name.size();
+                });
+            })
+            .wrap("login ", text);
+    };
+    REQUIRE(*chain("42") == 6);
+    REQUIRE(chain("x").error().code == 22);
+    REQUIRE(chain("x").error().desc == "login x: not a number: \"x\"");
+    REQUIRE(chain("500").error().desc == "login 500: no user 500");
+    REQUIRE(chain("7").error().code == 403);
+    REQUIRE(chain("7").error().desc == "login 7: user7 is locked");
+
+    // the error that failed first is the one that arrives
+    jack::result<int> r0 = parse("?");
+    const jack::error* boxed = &r0.error();
+    jack::result<std::string> r1 = std::move(r0).and_then(lookup);
+    REQUIRE(&r1.error() == boxed);
+
+    // by const reference, the error is copied
+    const jack::result<int> r2 = parse("?");
+    jack::result<std::string> r3 = r2.and_then(lookup);
+    REQUIRE(&r3.error() != &r2.error());
+    REQUIRE(r3.error().desc == r2.error().desc.c_str());
+
+    // recovering
+    const auto fallback = [](jack::error& e) -> jack::result<int> {
+        if (e.code == 22)
+        {
+            return 0;
+        }
+        return std::move(e);
+    };
+    REQUIRE(*parse("x").or_else(fallback) == 0);
+    REQUIRE(*parse("5").or_else(fallback) == 5);
+    REQUIRE(*r2.or_else([](const jack::error&) -> jack::result<int> {
+        return 1;
+    }) == 1);
+
+    // map_error & wrap work on the error where it is
+    jack::result<int> r4 = parse("y").map_error([](jack::error& e) {
+        e.wrap_as(500, "reading config");
+    });
+    REQUIRE(r4.error().code == 500);
+    REQUIRE(r4.error().desc == "reading config: not a number: \"y\"");
+    boxed = &r4.error();
+    r4.extend("at line ", 3).trace(jack::location{"cfg.cpp", "load", 9});
+    REQUIRE(&r4.error() == boxed);
+    REQUIRE(r4.error().desc == "cfg.cpp:9 in load: reading config: "
+            "not a number: \"y\": at line 3");
+
+    // nothing happens on success
+    jack::result<int> r5 = parse("8").wrap("unused").map_error([](jack::error&) {
+        FAIL("map_error called on success");
+    });
+    REQUIRE(*r5 == 8);
+
+    // passing a failure on by hand
+    const auto by_hand = [](const std::string& text) -> jack::result<void> {
+        jack::result<int> n = parse(text);
+        if (!n)
+        {
+            return std::move(n).failure();
+        }
+        return {};
+    };
+    REQUIRE(by_hand("1"));
+    REQUIRE(by_hand("z").error().code == 22);
+
+    jack::result<void> v0 = check("user7").wrap_as(401, "auth");
+    REQUIRE(v0.error().code == 401);
+    REQUIRE(v0.error().desc == "auth: user7 is locked");
+    REQUIRE(check("user1").or_else([](jack::error&) -> jack::result<void> {
+        return jack::error(1, "unreachable");
+    }));
+}
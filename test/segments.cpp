@@ -0,0 +1,107 @@
+#include <cstring>
+#include <string>
+
+// let catch define main
+#define CATCH_CONFIG_MAIN
+
+#include "catch2/catch.hpp"
+#include "jack/error.hpp"
+
+static std::string joined(const jack::segments& segs)
+{
+    std::string out(segs.bytes(), '\0');
+    REQUIRE(segs.copy(&out[0]) == &out[0] + out.size());
+    return out;
+}
+
+// laid out like struct iovec
+struct io_vec
+{
+    void* iov_base;
+    std::size_t iov_len;
+};
+
+TEST_CASE("segments of a reason", "[segments.reason]")
+{
+    const std::string path("/var/lib/service/shard-0012/data.bin");
+    jack::reason r0("unexpected end of file after 4096 bytes");
+    r0.wrap("reading ", path).wrap("loading shard ", 12).extend("giving up");
+
+    // long pieces are referred to where they are, short ones merged
+    const jack::segments s0(r0);
+    REQUIRE(s0.size() <= 6);
+    REQUIRE(s0.copied() < s0.bytes() / 2);
+    REQUIRE(joined(s0) == "loading shard 12: reading " + path +
+            ": unexpected end of file after 4096 bytes: giving up");
+    bool root = false;
+    for (const auto& seg : s0)
+    {
+        root = root || std::string(seg.data, seg.size).find(
+                "unexpected end of file") == 0;
+    }
+    REQUIRE(root);
+
+    io_vec iov[jack::segments::max_segments];
+    REQUIRE(s0.to_iovec(iov) == s0.size());
+    std::string written;
+    for (std::size_t i = 0; i < s0.size(); ++i)
+    {
+        written.append(static_cast<const char*>(iov[i].iov_base), iov[i].iov_len);
+    }
+    REQUIRE(written == joined(s0));
+
+    // located frames & elided markers without rendering
+    jack::reason r1("disk full");
+    r1.trace(jack::location{"io.cpp", "flush", 1234}).limit(2);
+    r1.wrap("a").wrap("b").extend(jack::literal("c"));
+    const jack::segments s1(r1);
+    const std::string gathered = joined(s1);
+    REQUIRE(gathered == r1.c_str());
+
+    // a rendered reason is one segment
+    const jack::reason r2(r0);
+    r2.c_str();
+    const jack::segments s2(r2);
+    REQUIRE(s2.size() == 1);
+    REQUIRE(s2[0].data == r2.c_str());
+
+    // too many pieces to split
+    jack::reason r3("root");
+    for (int i = 0; i < 100; ++i)
+    {
+        r3.wrap("context number ", i, " of a long chain");
+    }
+    const jack::segments s3(r3);
+    REQUIRE(s3.size() == 1);
+    REQUIRE(joined(s3) == r3.c_str());
+
+}
+
+TEST_CASE("segments of an error", "[segments.error]")
+{
+    jack::error e0(-1001, "connection refused by the remote host");
+    e0.wrap("dialing the upstream service at ", 80).extend("retrying");
+    const jack::segments s0(e0);
+    REQUIRE(std::string(s0[0].data, s0[0].size) == "error { code: -1001, desc: \"");
+    REQUIRE(std::string(s0[1].data, s0[1].size) ==
+            "dialing the upstream service at 80");
+
+    // reading the description may move what the segments refer to
+    const std::string gathered = joined(s0);
+    REQUIRE(gathered == jack::debug::str(e0));
+
+    // a reason with no frames
+    const jack::error e1(7, "x");
+    const jack::segments s1(e1);
+    REQUIRE(s1.size() == 1);
+    REQUIRE(joined(s1) == "error { code: 7, desc: \"x\" }");
+
+    jack::error e2(3, jack::deferred, "value ", 3.5);
+    for (int i = 0; i < 40; ++i)
+    {
+        e2.wrap("w", i);
+    }
+    const jack::segments s2(e2);
+    const std::string many = joined(s2);
+    REQUIRE(many == jack::debug::str(e2));
+}
@@ -0,0 +1,176 @@
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+// let catch define main
+#define CATCH_CONFIG_MAIN
+
+#include "catch2/catch.hpp"
+#include "jack/sink.hpp"
+
+// everything written to a temporary file so far
+static std::string contents(std::FILE* file)
+{
+    std::string out;
+    std::rewind(file);
+    char buf[4096];
+    std::size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), file)) != 0)
+    {
+        out.append(buf, n);
+    }
+    return out;
+}
+
+static std::vector<std::string> lines(const std::string& str)
+{
+    std::vector<std::string> out;
+    std::size_t start = 0;
+    for (std::size_t end; (end = str.find('\n', start)) != std::string::npos;
+            start = end + 1)
+    {
+        out.push_back(str.substr(start, end - start));
+    }
+    return out;
+}
+
+TEST_CASE("sink writes debug strings", "[sink.write]")
+{
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file);
+
+    jack::error e0(1001, "plain");
+    jack::error e1(1002, jack::literal("refused"));
+    e1.wrap("connecting").extend("attempt ", 3);
+    jack::error e2(1003, jack::deferred, "read ", 10, " bytes");
+    jack::error e3(1004, "deep");
+    for (int i = 0; i < 2000; ++i)
+    {
+        e3.wrap("w");
+    }
+
+    std::string expected;
+    for (const auto* e : {&e0, &e1, &e2, &e3})
+    {
+        expected += jack::debug::str(*e) + "\n";
+    }
+
+    {
+        jack::sink sink(fileno(file));
+        REQUIRE(sink.push(std::move(e0)));
+        REQUIRE(sink.push(std::move(e1)));
+        REQUIRE(sink.push(std::move(e2)));
+        REQUIRE(sink.push(std::move(e3)));
+        sink.flush();
+        REQUIRE(sink.written() == 4);
+        REQUIRE(contents(file) == expected);
+
+        // the destructor writes whatever is left
+        sink.push(jack::error(1005, "last"));
+    }
+    REQUIRE(lines(contents(file)).back() == jack::debug::str(jack::error(1005, "last")));
+    std::fclose(file);
+}
+
+TEST_CASE("sink takes many producers", "[sink.producers]")
+{
+    constexpr int threads = 8;
+    constexpr int per_thread = 2000;
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file);
+
+    jack::sink_options options;
+    options.capacity = 16;
+    options.batch = 8;
+    options.when_full = jack::backpressure::block;
+    {
+        jack::sink sink(fileno(file), options);
+        std::atomic<int> rejected{0};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&sink, &rejected, t] {
+                for (int i = 0; i < per_thread; ++i)
+                {
+                    rejected += !sink.push(jack::error(t, "n ", i));
+                }
+            });
+        }
+        for (auto& w : workers)
+        {
+            w.join();
+        }
+        sink.flush();
+        REQUIRE(rejected == 0);
+        REQUIRE(sink.written() == threads * per_thread);
+        REQUIRE(sink.dropped() == 0);
+    }
+
+    // every error arrives once & each thread's in order
+    const auto all = lines(contents(file));
+    REQUIRE(all.size() == threads * per_thread);
+    std::vector<int> next(threads, 0);
+    for (const auto& line : all)
+    {
+        int code, n;
+        REQUIRE(std::sscanf(line.c_str(), "error { code: %d, desc: \"n %d\" }",
+                &code, &n) == 2);
+        REQUIRE(n == next[code]++);
+    }
+    std::fclose(file);
+}
+
+TEST_CASE("sink drops when full", "[sink.drop]")
+{
+    // nobody reads the pipe at first, so the flusher stalls once it fills
+    int fds[2];
+    REQUIRE(::pipe(fds) == 0);
+    std::string received;
+    std::thread reader;
+
+    constexpr int pushed = 20000;
+    jack::sink_options options;
+    options.capacity = 8;
+    std::uint64_t accepted = 0;
+    {
+        jack::sink sink(fds[1], options);
+        for (int i = 0; i < pushed; ++i)
+        {
+            accepted += sink.push(jack::error(1001, "a fairly long description ", i));
+        }
+        REQUIRE(sink.dropped() > 0);
+        REQUIRE(sink.overflows() == sink.dropped());
+        REQUIRE(accepted + sink.dropped() == pushed);
+
+        reader = std::thread([&] {
+            char buf[4096];
+            ssize_t n;
+            while ((n = ::read(fds[0], buf, sizeof(buf))) > 0)
+            {
+                received.append(buf, static_cast<std::size_t>(n));
+            }
+        });
+        sink.flush();
+        REQUIRE(sink.written() == accepted);
+    }
+    ::close(fds[1]);
+    reader.join();
+    ::close(fds[0]);
+    REQUIRE(lines(received).size() == accepted);
+    REQUIRE(received.compare(0, 15, "error { code: 1") == 0);
+}
+
+TEST_CASE("sink counts failed writes", "[sink.failed]")
+{
+    // not a descriptor
+    jack::sink sink(-1);
+    sink.push(jack::error(1001, "lost"));
+    sink.push(jack::error(1002, "lost"));
+    sink.flush();
+    REQUIRE(sink.failed() == 2);
+    REQUIRE(sink.written() == 0);
+}
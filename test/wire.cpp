@@ -0,0 +1,196 @@
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+// let catch define main
+#define CATCH_CONFIG_MAIN
+
+#include "catch2/catch.hpp"
+#include "jack/error.hpp"
+
+namespace jack
+{
+inline bool operator==(const jack::reason& lhs, const char* rhs)
+{
+    return !strcmp(lhs.c_str(), rhs);
+}
+}
+
+static std::vector<char> encode(const jack::error& err)
+{
+    std::vector<char> buf(jack::wire::encoded_size(err));
+    REQUIRE(jack::wire::encode(err, buf.data(), buf.size()) == buf.size());
+    return buf;
+}
+
+TEST_CASE("wire round trip", "[wire.round_trip]")
+{
+    jack::error e0(-42, "disk full");
+    const auto b0 = encode(e0);
+    REQUIRE(b0.size() == jack::wire::header_size + std::strlen("disk full") + 1);
+
+    const jack::error_view v0(b0.data(), b0.size());
+    REQUIRE(v0);
+    REQUIRE(v0.code() == -42);
+    REQUIRE(!std::strcmp(v0.c_str(), "disk full"));
+    REQUIRE(v0.size() == 9);
+    REQUIRE(v0.frame_count() == 0);
+    REQUIRE(v0.encoded_size() == b0.size());
+
+    // text is read in place
+    REQUIRE(v0.c_str() >= b0.data());
+    REQUIRE(v0.c_str() < b0.data() + b0.size());
+
+    std::stringstream ss;
+    ss << v0;
+    REQUIRE(ss.str() == "disk full");
+
+    const jack::error e1 = v0.to_error();
+    REQUIRE(e1.code == -42);
+    REQUIRE(e1.desc == "disk full");
+}
+
+TEST_CASE("wire frames", "[wire.frames]")
+{
+    jack::error e0(7, jack::literal("root"));
+    e0.wrap("w1").extend("e1").wrap("w2 ", 2).extend(jack::literal("e2"));
+    const auto buf = encode(e0);
+
+    const jack::error_view view(buf.data(), buf.size());
+    REQUIRE(view);
+    REQUIRE(!std::strcmp(view.c_str(), "w2 2: w1: root: e1: e2"));
+    REQUIRE(std::string(view.root().data, view.root().size) == "root");
+
+    // frames are kept in the order they were added
+    const char* expect[] = {"w1", "e1", "w2 2", "e2"};
+    const bool wraps[] = {true, false, true, false};
+    REQUIRE(view.frame_count() == 4);
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        const auto f = view.frame_at(i);
+        REQUIRE(std::string(f.data, f.size) == expect[i]);
+        REQUIRE(f.wrap == wraps[i]);
+    }
+
+    // & rebuilt, so the copy keeps growing the same way
+    jack::error e1 = view.to_error();
+    REQUIRE(e1.desc == "w2 2: w1: root: e1: e2");
+    e1.wrap("w3");
+    e0.wrap("w3");
+    REQUIRE(e1.desc == e0.desc.c_str());
+
+    // deferred reasons are formatted as they are written
+    const auto b2 = encode(jack::error(8, jack::deferred, "val ", 8));
+    REQUIRE(!std::strcmp(jack::error_view(b2.data(), b2.size()).c_str(), "val 8"));
+}
+
+TEST_CASE("wire stream of errors", "[wire.stream]")
+{
+    // several errors back to back, e.g. in a shared memory ring
+    std::vector<char> buf(256);
+    std::size_t used = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        jack::error e(i, "error ", i);
+        used += jack::wire::encode(e, buf.data() + used, buf.size() - used);
+    }
+
+    std::size_t pos = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        const jack::error_view view(buf.data() + pos, used - pos);
+        REQUIRE(view);
+        REQUIRE(view.code() == i);
+        REQUIRE(view.to_error().desc == ("error " + std::to_string(i)).c_str());
+        pos += view.encoded_size();
+    }
+    REQUIRE(pos == used);
+}
+
+TEST_CASE("wire rejects bad input", "[wire.invalid]")
+{
+    jack::error e0(1, "abc");
+    e0.wrap("ctx");
+
+    // buffer too small to encode into
+    std::vector<char> small(jack::wire::encoded_size(e0) - 1);
+    REQUIRE(jack::wire::encode(e0, small.data(), small.size()) == 0);
+
+    auto buf = encode(e0);
+    REQUIRE(!jack::error_view());
+
+    // truncated
+    for (std::size_t n = 0; n < buf.size(); ++n)
+    {
+        REQUIRE(!jack::error_view(buf.data(), n));
+    }
+
+    // bad magic & unknown version
+    auto bad = buf;
+    bad[0] = 'x';
+    REQUIRE(!jack::error_view(bad.data(), bad.size()));
+    bad = buf;
+    bad[2] = 2;
+    REQUIRE(!jack::error_view(bad.data(), bad.size()));
+
+    // a frame outside the description
+    bad = buf;
+    bad[jack::wire::header_size] = 100;
+    REQUIRE(!jack::error_view(bad.data(), bad.size()));
+
+    // missing terminator
+    bad = buf;
+    bad.back() = 'x';
+    REQUIRE(!jack::error_view(bad.data(), bad.size()));
+}
+
+#if __cplusplus >= 201703L
+TEST_CASE("wire to pmr error", "[wire.pmr]")
+{
+    const auto buf = encode(jack::error(3, "a description long enough to "
+            "need the heap"));
+    std::pmr::monotonic_buffer_resource res;
+    const jack::pmr::error err = jack::error_view(buf.data(), buf.size())
+            .to_error(std::pmr::polymorphic_allocator<char>(&res));
+    REQUIRE(err.get_allocator().resource() == &res);
+    REQUIRE(!std::strcmp(err.desc.c_str(),
+            "a description long enough to need the heap"));
+}
+TEST_CASE("wire writes locations out", "[wire.location]")
+{
+    jack::error e0(1001, "refused");
+    e0.trace(jack::location{"net.cpp", "dial", 9}).extend("port ", 80);
+    const auto b0 = encode(e0);
+    const jack::error_view v0(b0.data(), b0.size());
+    REQUIRE(!std::strcmp(v0.c_str(), "net.cpp:9 in dial: refused: port 80"));
+    REQUIRE(v0.frame_count() == 2);
+    REQUIRE(std::string(v0.frame_at(0).data, v0.frame_at(0).size) ==
+            "net.cpp:9 in dial");
+    REQUIRE(v0.to_error().desc == e0.desc.c_str());
+}
+
+#endif
+
+TEST_CASE("wire keeps elided markers", "[wire.limit]")
+{
+    jack::error e0(3, "timeout");
+    e0.limit(2);
+    for (int i = 0; i < 10; ++i)
+    {
+        e0.wrap("attempt ", i).extend("x");
+    }
+    REQUIRE(e0.desc.elided() == 18);
+    const auto buf = encode(e0);
+
+    const jack::error_view view(buf.data(), buf.size());
+    REQUIRE(view);
+    REQUIRE(view.c_str() == std::string(e0.desc.c_str()));
+    REQUIRE(view.frame_count() == 4);
+
+    // the markers come back as plain frames
+    jack::error e1 = view.to_error();
+    REQUIRE(e1.desc == e0.desc.c_str());
+    e1.wrap("w");
+    REQUIRE(e1.desc == "w: [... 9 frames elided ...]: attempt 0: timeout: "
+            "[... 9 frames elided ...]: x");
+}